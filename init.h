@@ -12,13 +12,22 @@ symbol redeclarations:
 #include <init.h>
 
 Download Vulkan SDK from lunarg (https://www.lunarg.com/vulkan-sdk/).
-Library uses CRT for memory allocation.
+Library uses CRT for memory allocation, unless callbacks are set with withAllocationCallbacks.
+JobSystem and writeShaderArchive don't take InitializationStruct and always use CRT, so do swapchain
+image arrays handed to app (free them with free()).
+JobSystem uses Win32 threads, or pthreads elsewhere (link with -pthread).
 
 Defines:
 
 #define VKCMDINIT_GLFW - If you use GLFW for crossplatform windows (recommended)
 #define VKCMDINIT_INCLUDED_VULKAN - If vulkan.h is already included
 #define VKCMDINIT_IMPL - includes definitions (function bodies)
+#define VKCMDINIT_DYNAMIC_LOADER - Loads vulkan loader at runtime in startInstance instead of linking it (implies VK_NO_PROTOTYPES, call through dispatch tables)
+#define VKCMDINIT_MAX_QUEUES_PER_FAMILY N - Upper bound of queues default createDevice requests from one family (default 16)
+#define VKCMDINIT_MAX_SWAPCHAIN_IMAGES N - Images vki::Swapchain and retired swapchains keep inline, more spill to heap or fail in-place creation (default 8)
+#define VKCMDINIT_GPU_PROFILER_WINDOW N - Frames GpuProfiler computes min/avg/max over (default 64)
+#define VKCMDINIT_DEBUG_MESSAGE_SIZE N - Bytes of message text withDebugOutputSink keeps per message, longer ones are truncated (default 2048)
+#define VKCMDINIT_DEFAULT_VALIDATION_PROFILE P - Validation startInstance enables unless withValidation is called (default VALIDATION_PROFILE_NONE with NDEBUG, VALIDATION_PROFILE_STANDARD otherwise)
 
 */
 
@@ -35,6 +44,9 @@ Defines:
 #endif 
 
 #ifndef VKCMDINIT_INCLUDED_VULKAN
+#if defined(VKCMDINIT_DYNAMIC_LOADER) && !defined(VK_NO_PROTOTYPES)
+#define VK_NO_PROTOTYPES
+#endif
 #include <vulkan/vulkan.h>
 #else
 #ifndef VULKAN_H_
@@ -75,20 +87,397 @@ extern "C" {
 
 #endif
 
+	//Outcome of seeding pipeline cache from disk, see withPipelineCache
+	typedef enum PipelineCacheLoadResult
+	{
+		PIPELINE_CACHE_LOAD_RESULT_NONE = 0, //no cache path was provided
+		PIPELINE_CACHE_LOAD_RESULT_LOADED = 1,
+		PIPELINE_CACHE_LOAD_RESULT_NOT_FOUND = 2,
+		PIPELINE_CACHE_LOAD_RESULT_STALE = 3, //written by different device/driver, discarded
+		PIPELINE_CACHE_LOAD_RESULT_CORRUPT = 4 //truncated or checksum mismatch, discarded
+	} PipelineCacheLoadResult;
+
+#ifndef VKCMDINIT_MAX_QUEUES_PER_FAMILY
+#define VKCMDINIT_MAX_QUEUES_PER_FAMILY 16
+#endif
+
+#ifndef VKCMDINIT_MAX_SWAPCHAIN_IMAGES
+#define VKCMDINIT_MAX_SWAPCHAIN_IMAGES 8
+#endif
+
+	//Queue families chosen by default createDevice path, see withQueueCount
+	typedef enum QueueRole
+	{
+		QUEUE_ROLE_GRAPHICS = 0,
+		QUEUE_ROLE_COMPUTE = 1, //falls back to graphics family if there's no compute-only family
+		QUEUE_ROLE_TRANSFER = 2, //falls back to graphics family if there's no transfer-only family
+		QUEUE_ROLE_COUNT = 3
+	} QueueRole;
+
+	//Validation layer setup startInstance requests, see withValidation
+	typedef enum ValidationProfile
+	{
+		VALIDATION_PROFILE_NONE = 0, //no layers, for shipping builds
+		VALIDATION_PROFILE_STANDARD = 1, //VK_LAYER_KHRONOS_validation
+		VALIDATION_PROFILE_EXTENDED = 2 //STANDARD plus VK_EXT_validation_features, see ValidationFeatureBits
+	} ValidationProfile;
+
+	//Checks VALIDATION_PROFILE_EXTENDED turns on, all of them slow validation down considerably
+	typedef enum ValidationFeatureBits
+	{
+		VALIDATION_FEATURE_BEST_PRACTICES = 1,
+		VALIDATION_FEATURE_GPU_ASSISTED = 2, //instruments shaders, costs a descriptor set binding slot
+		VALIDATION_FEATURE_SYNCHRONIZATION = 4
+	} ValidationFeatureBits;
+
+	typedef struct PipelineCacheStats
+	{
+		PipelineCacheLoadResult loadResult;
+		size_t loadedBytes;
+		size_t savedBytes;
+		//Filled by recordPipelineCacheFeedback
+		uint32_t hits;
+		uint32_t misses;
+	} PipelineCacheStats;
+
+	typedef struct InitTraceEvent
+	{
+		const char* name; //has to outlive the trace, library passes string literals
+		uint64_t startNanoseconds; //since withInitTracing
+		uint64_t durationNanoseconds;
+		uint32_t depth; //0 for top level steps like createDevice, nested calls are deeper
+	} InitTraceEvent;
+
+	//Timings of init steps and the Vulkan calls inside them, in the order they began. Not thread safe
+	typedef struct InitTrace
+	{
+		InitTraceEvent* events;
+		uint32_t eventCount;
+		uint32_t eventCapacity;
+		uint32_t depth; //scopes open right now
+		uint64_t originNanoseconds;
+	} InitTrace;
+
+	//VK_SYSTEM_ALLOCATION_SCOPE_COMMAND..VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE
+#define VKCMDINIT_ALLOCATION_SCOPE_COUNT 5
+
+	typedef struct AllocationScopeStats
+	{
+		uint64_t allocationCount; //reallocation counts as allocation + free
+		uint64_t freeCount;
+		uint64_t allocatedBytes; //sum of all allocations so far
+		uint64_t liveBytes;
+		uint64_t peakLiveBytes;
+	} AllocationScopeStats;
+
+	//Host memory that went through allocation callbacks, see withAllocationCallbacks
+	typedef struct AllocationStats
+	{
+		AllocationScopeStats scopes[VKCMDINIT_ALLOCATION_SCOPE_COUNT]; //indexed by VkSystemAllocationScope
+		//Driver's own allocations it reports through pfnInternalAllocation (ex. executable memory)
+		uint64_t internalAllocationCount;
+		uint64_t internalLiveBytes;
+	} AllocationStats;
+
+	//Linear allocator for transient init scratch (enumerations, queue family lists...), see withScratchArena.
+	//First block is kept until terminateInstance so every init step reuses it. Not thread safe
+	typedef struct ScratchArena
+	{
+		void* block; //newest block
+		size_t blockSize; //0 means default (64 KiB)
+		size_t usedBytes;
+		size_t peakUsedBytes;
+		uint32_t overflowBlockCount; //extra blocks chained because request didn't fit, raise blockSize if it isn't 0
+	} ScratchArena;
+
+	//Position scratchRewind returns arena to
+	typedef struct ScratchMark
+	{
+		void* block;
+		size_t offset;
+		size_t usedBytes;
+	} ScratchMark;
+
+//Loader-level functions, resolved with vkGetInstanceProcAddr(NULL, ...)
+#define VKCMDINIT_GLOBAL_FUNCTIONS(X) \
+	X(vkCreateInstance) \
+	X(vkEnumerateInstanceLayerProperties) \
+	X(vkEnumerateInstanceExtensionProperties)
+
+//Resolved once startInstance created the instance. Extension functions are NULL if extension isn't enabled
+#define VKCMDINIT_INSTANCE_FUNCTIONS(X) \
+	X(vkDestroyInstance) \
+	X(vkEnumeratePhysicalDevices) \
+	X(vkGetPhysicalDeviceProperties) \
+	X(vkGetPhysicalDeviceFeatures) \
+	X(vkGetPhysicalDeviceFeatures2) \
+	X(vkGetPhysicalDeviceMemoryProperties) \
+	X(vkGetPhysicalDeviceQueueFamilyProperties) \
+	X(vkEnumerateDeviceExtensionProperties) \
+	X(vkCreateDevice) \
+	X(vkGetDeviceProcAddr) \
+	X(vkDestroySurfaceKHR) \
+	X(vkGetPhysicalDeviceSurfaceSupportKHR) \
+	X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+	X(vkGetPhysicalDeviceSurfaceFormatsKHR) \
+	X(vkGetPhysicalDeviceSurfacePresentModesKHR) \
+	X(vkCreateDebugUtilsMessengerEXT) \
+	X(vkDestroyDebugUtilsMessengerEXT) \
+	X(vkCreateHeadlessSurfaceEXT)
+
+//Resolved with vkGetDeviceProcAddr in createDevice, calls go straight to the driver
+#define VKCMDINIT_DEVICE_FUNCTIONS(X) \
+	X(vkDestroyDevice) \
+	X(vkGetDeviceQueue) \
+	X(vkQueueSubmit) \
+	X(vkQueueWaitIdle) \
+	X(vkDeviceWaitIdle) \
+	X(vkAllocateMemory) \
+	X(vkFreeMemory) \
+	X(vkMapMemory) \
+	X(vkUnmapMemory) \
+	X(vkFlushMappedMemoryRanges) \
+	X(vkInvalidateMappedMemoryRanges) \
+	X(vkBindBufferMemory) \
+	X(vkBindImageMemory) \
+	X(vkGetBufferMemoryRequirements) \
+	X(vkGetImageMemoryRequirements) \
+	X(vkGetBufferMemoryRequirements2) \
+	X(vkGetImageMemoryRequirements2) \
+	X(vkCreateFence) \
+	X(vkDestroyFence) \
+	X(vkResetFences) \
+	X(vkGetFenceStatus) \
+	X(vkWaitForFences) \
+	X(vkCreateSemaphore) \
+	X(vkDestroySemaphore) \
+	X(vkGetSemaphoreCounterValue) \
+	X(vkWaitSemaphores) \
+	X(vkSignalSemaphore) \
+	X(vkCreateQueryPool) \
+	X(vkDestroyQueryPool) \
+	X(vkGetQueryPoolResults) \
+	X(vkCreateBuffer) \
+	X(vkDestroyBuffer) \
+	X(vkCreateImage) \
+	X(vkDestroyImage) \
+	X(vkCreateImageView) \
+	X(vkDestroyImageView) \
+	X(vkCreateShaderModule) \
+	X(vkDestroyShaderModule) \
+	X(vkCreatePipelineCache) \
+	X(vkDestroyPipelineCache) \
+	X(vkGetPipelineCacheData) \
+	X(vkMergePipelineCaches) \
+	X(vkCreateGraphicsPipelines) \
+	X(vkCreateComputePipelines) \
+	X(vkDestroyPipeline) \
+	X(vkCreatePipelineLayout) \
+	X(vkDestroyPipelineLayout) \
+	X(vkCreateSampler) \
+	X(vkDestroySampler) \
+	X(vkCreateDescriptorSetLayout) \
+	X(vkDestroyDescriptorSetLayout) \
+	X(vkCreateDescriptorPool) \
+	X(vkDestroyDescriptorPool) \
+	X(vkResetDescriptorPool) \
+	X(vkAllocateDescriptorSets) \
+	X(vkFreeDescriptorSets) \
+	X(vkUpdateDescriptorSets) \
+	X(vkCreateFramebuffer) \
+	X(vkDestroyFramebuffer) \
+	X(vkCreateRenderPass) \
+	X(vkDestroyRenderPass) \
+	X(vkCreateCommandPool) \
+	X(vkDestroyCommandPool) \
+	X(vkResetCommandPool) \
+	X(vkAllocateCommandBuffers) \
+	X(vkFreeCommandBuffers) \
+	X(vkBeginCommandBuffer) \
+	X(vkEndCommandBuffer) \
+	X(vkResetCommandBuffer) \
+	X(vkCmdBindPipeline) \
+	X(vkCmdSetViewport) \
+	X(vkCmdSetScissor) \
+	X(vkCmdBindDescriptorSets) \
+	X(vkCmdBindIndexBuffer) \
+	X(vkCmdBindVertexBuffers) \
+	X(vkCmdDraw) \
+	X(vkCmdDrawIndexed) \
+	X(vkCmdDrawIndirect) \
+	X(vkCmdDrawIndexedIndirect) \
+	X(vkCmdDispatch) \
+	X(vkCmdDispatchIndirect) \
+	X(vkCmdCopyBuffer) \
+	X(vkCmdCopyImage) \
+	X(vkCmdBlitImage) \
+	X(vkCmdCopyBufferToImage) \
+	X(vkCmdCopyImageToBuffer) \
+	X(vkCmdUpdateBuffer) \
+	X(vkCmdFillBuffer) \
+	X(vkCmdClearColorImage) \
+	X(vkCmdPipelineBarrier) \
+	X(vkCmdBeginQuery) \
+	X(vkCmdEndQuery) \
+	X(vkCmdResetQueryPool) \
+	X(vkCmdWriteTimestamp) \
+	X(vkCmdPushConstants) \
+	X(vkCmdBeginRenderPass) \
+	X(vkCmdNextSubpass) \
+	X(vkCmdEndRenderPass) \
+	X(vkCmdExecuteCommands) \
+	X(vkCreateSwapchainKHR) \
+	X(vkDestroySwapchainKHR) \
+	X(vkGetSwapchainImagesKHR) \
+	X(vkAcquireNextImageKHR) \
+	X(vkQueuePresentKHR)
+
+#define VKCMDINIT_DECLARE_FUNCTION(name) PFN_##name name;
+
+	//Instance function pointers, filled by startInstance
+	typedef struct InstanceDispatchTable
+	{
+		PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr;
+		VKCMDINIT_GLOBAL_FUNCTIONS(VKCMDINIT_DECLARE_FUNCTION)
+		VKCMDINIT_INSTANCE_FUNCTIONS(VKCMDINIT_DECLARE_FUNCTION)
+	} InstanceDispatchTable;
+
+	//Device function pointers, filled by createDevice. Prefer them over global vk* functions, they skip loader trampolines
+	typedef struct DeviceDispatchTable
+	{
+		VKCMDINIT_DEVICE_FUNCTIONS(VKCMDINIT_DECLARE_FUNCTION)
+	} DeviceDispatchTable;
+
+	//Swapchain replaced by recreateSwapchainKHR, waiting until frames that may still use it are finished
+	typedef struct RetiredSwapchain
+	{
+		VkSwapchainKHR swapchain;
+		VkImageView* imageViews; //NULL if they fit in inlineImageViews
+		uint32_t imageViewCount;
+		uint64_t retireAfterFrame;
+		VkImageView inlineImageViews[VKCMDINIT_MAX_SWAPCHAIN_IMAGES];
+	} RetiredSwapchain;
+
+	//Weights used by default device selection, start from defaultDeviceSelectionPolicy and adjust.
+	//Keep memory and queue scores together below smallest gap between device type scores, otherwise they outrank device type
+	//(ex. CPU device reporting system RAM as device local heap beats integrated GPU)
+	typedef struct DeviceSelectionPolicy
+	{
+		int64_t discreteGpuScore;
+		int64_t integratedGpuScore;
+		int64_t virtualGpuScore;
+		int64_t cpuScore;
+		int64_t otherScore;
+		int64_t scorePerDeviceLocalGiB; //largest device local heap
+		uint32_t deviceLocalGiBLimit; //larger heaps score as this much
+		int64_t dedicatedComputeQueueScore; //family with compute, without graphics
+		int64_t dedicatedTransferQueueScore; //family with transfer only
+		int64_t presentationSupportScore;
+
+		//Devices failing these are never selected
+		const char* const* requiredExtensions;
+		uint32_t requiredExtensionCount;
+		bool requireGraphicsQueue;
+		bool requirePresentationSupport; //ignored if there's no surface
+	} DeviceSelectionPolicy;
+
+	//Result of scoring one physical device, for logging and custom selection
+	typedef struct PhysicalDeviceScore
+	{
+		VkPhysicalDevice physicalDevice;
+		char deviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE];
+		VkPhysicalDeviceType deviceType;
+		VkDeviceSize deviceLocalHeapSize;
+		bool hasGraphicsQueue;
+		bool hasDedicatedComputeQueue;
+		bool hasDedicatedTransferQueue;
+		bool supportsPresentation;
+		uint32_t missingExtensionCount;
+		bool suitable; //passed all requirements of the policy
+		int64_t score;
+	} PhysicalDeviceScore;
+
 	//DO NOT use if you specified custom deviceDesigner in createDevice
 	typedef struct DefaultQueueRetrieveStruct
 	{
 		VkQueue graphicsQueue;
 		VkQueue presentationQueue;
+		VkQueue computeQueue; //same as graphicsQueue if there's no compute-only family
+		VkQueue transferQueue; //same as graphicsQueue if there's no transfer-only family
 	} DefaultQueueRetrieveStruct;
 
 	//DO NOT use if you specified custom deviceDesigner in createDevice
 	typedef struct DefaultQueueIndices
 	{
+		//First two are passed as array to swapchain creation, keep them first
 		uint32_t graphicQueueIndex;
 		uint32_t presentationFamilyIndex;
+		uint32_t computeFamilyIndex; //equals graphicQueueIndex if there's no compute-only family
+		uint32_t transferFamilyIndex; //equals graphicQueueIndex if there's no transfer-only family
+		//Queues created in family of each role, shared if roles share a family
+		uint32_t graphicsQueueCount;
+		uint32_t computeQueueCount;
+		uint32_t transferQueueCount;
 	} DefaultQueueIndices;
 
+	//What startInstance and default createDevice path negotiate, start from defaultFeatureRequest and adjust. Missing required
+	//item skips creation of instance/device, missing optional one is left out. Feature structs are compared member by member,
+	//their sType and pNext are ignored. Arrays (and strings in them) have to stay alive until createDevice
+	typedef struct FeatureRequest
+	{
+		const char* const* requiredInstanceLayers;
+		uint32_t requiredInstanceLayerCount;
+		const char* const* optionalInstanceLayers;
+		uint32_t optionalInstanceLayerCount;
+		const char* const* requiredInstanceExtensions; //looked up in loader, implicit and enabled layers
+		uint32_t requiredInstanceExtensionCount;
+		const char* const* optionalInstanceExtensions;
+		uint32_t optionalInstanceExtensionCount;
+		const char* const* requiredDeviceExtensions; //deviceExtensions passed to createDevice are required too
+		uint32_t requiredDeviceExtensionCount;
+		const char* const* optionalDeviceExtensions;
+		uint32_t optionalDeviceExtensionCount;
+
+		VkPhysicalDeviceFeatures requiredFeatures;
+		VkPhysicalDeviceFeatures optionalFeatures;
+		VkPhysicalDeviceVulkan11Features requiredFeatures11; //need apiVersion 1.2, before that only 1.0 features can be negotiated
+		VkPhysicalDeviceVulkan11Features optionalFeatures11;
+		VkPhysicalDeviceVulkan12Features requiredFeatures12; //need apiVersion 1.2
+		VkPhysicalDeviceVulkan12Features optionalFeatures12;
+		VkPhysicalDeviceVulkan13Features requiredFeatures13; //need apiVersion 1.3
+		VkPhysicalDeviceVulkan13Features optionalFeatures13;
+	} FeatureRequest;
+
+	//What was actually enabled. Names aren't copied, they point at strings from request, addExtension or library literals
+	typedef struct FeatureGrant
+	{
+		bool instanceSatisfied;
+		bool deviceSatisfied;
+		const char* firstMissing; //first required name (or feature struct type) that wasn't there, NULL if none
+		uint32_t apiVersion; //lower of instance and device version, decides which feature structs could be chained
+
+		const char** instanceLayers;
+		uint32_t instanceLayerCount;
+		const char** instanceExtensions;
+		uint32_t instanceExtensionCount;
+		const char** deviceExtensions;
+		uint32_t deviceExtensionCount;
+
+		VkPhysicalDeviceFeatures features;
+		VkPhysicalDeviceVulkan11Features features11;
+		VkPhysicalDeviceVulkan12Features features12;
+		VkPhysicalDeviceVulkan13Features features13;
+	} FeatureGrant;
+
+	//Sub-allocator created on first allocateBufferMemory/allocateImageMemory/createLinearArena call, see withMemoryAllocator
+	typedef struct GpuMemoryAllocator GpuMemoryAllocator;
+
+	//Wraps app's allocation callbacks (or CRT) and counts what goes through them, see withAllocationCallbacks
+	typedef struct AllocationTracker AllocationTracker;
+
+	//Background delivery of debug messenger output, see withDebugOutputSink
+	typedef struct DebugSink DebugSink;
+
 	//Struct containing all initialization data
 	typedef struct InitializationStruct
 	{
@@ -98,9 +487,18 @@ extern "C" {
 			VkApplicationInfo appInfo;
 			VkInstanceCreateInfo instanceInfo;
 			uint32_t extensionCount;
+			uint32_t extensionCapacity;
 			const char** extensionPtr;
 		};
 
+		struct //Allocation
+		{
+			//Passed as pAllocator to every create/destroy call the library makes, NULL means Vulkan's default
+			const VkAllocationCallbacks* allocationCallbacks;
+			AllocationTracker* allocationTracker; //NULL unless statistics are tracked
+			ScratchArena scratchArena;
+		};
+
 		union
 		{
 			void* queueIndices;
@@ -114,6 +512,7 @@ extern "C" {
 			struct //DebugOutput
 			{
 				VkDebugUtilsMessengerEXT debugMessenger;
+				DebugSink* debugSink; //NULL unless withDebugOutputSink was used
 			};
 
 			struct //Surface
@@ -122,10 +521,75 @@ extern "C" {
 			};
 		};
 
+		struct //Validation
+		{
+			ValidationProfile validationProfile; //createApplication sets VKCMDINIT_DEFAULT_VALIDATION_PROFILE
+			uint32_t validationFeatures; //ValidationFeatureBits
+			//Set by startInstance, false if layer (or VK_EXT_validation_features) isn't installed
+			bool validationEnabled;
+			bool validationFeaturesEnabled;
+		};
+
+		struct //Swapchain
+		{
+			//Decisions made by createSwapchainKHR, reused by recreateSwapchainKHR
+			VkSurfaceFormatKHR swapchainFormat;
+			VkPresentModeKHR swapchainPresentMode;
+			void(*swapchainSurfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount);
+			VkImageUsageFlags swapchainImageUsage; //on top of color attachment, see withSwapchainReadback
+			VkImageUsageFlags swapchainGrantedUsage; //what images of last created swapchain actually have, 0 before first
+
+			RetiredSwapchain* retiredSwapchains;
+			uint32_t retiredSwapchainCount;
+			uint32_t retiredSwapchainCapacity;
+		};
+
+		struct //QueueRequests
+		{
+			//Set by withQueueCount, 0 means 1 queue
+			uint32_t queueRequestCounts[QUEUE_ROLE_COUNT];
+			const float* queueRequestPriorities[QUEUE_ROLE_COUNT];
+		};
+
+		struct //Memory
+		{
+			VkDeviceSize memoryBlockSize; //0 means default, see withMemoryAllocator
+			GpuMemoryAllocator* memoryAllocator;
+		};
+
+		struct //DeviceFeatures
+		{
+			//Chained into default createDevice path, see withTimelineSemaphores and withBindlessDescriptors
+			bool enableTimelineSemaphore;
+			bool enableBindless;
+			const FeatureRequest* featureRequest; //NULL unless withFeatureRequest was called
+			FeatureGrant featureGrant; //filled by startInstance and default createDevice path
+		};
+
+		struct //Tracing
+		{
+			InitTrace* initTrace; //NULL unless withInitTracing was called
+		};
+
+		struct //PipelineCache
+		{
+			const char* pipelineCachePath;
+			VkPipelineCache pipelineCache;
+			PipelineCacheStats pipelineCacheStats;
+		};
+
 		VkInstance instance;
 		VkPhysicalDevice physicalDevice;
 		VkDevice device;
 
+		struct //Dispatch
+		{
+			//Handle of runtime-loaded loader library, NULL unless VKCMDINIT_DYNAMIC_LOADER
+			void* loaderLibrary;
+			InstanceDispatchTable instanceTable;
+			DeviceDispatchTable deviceTable;
+		};
+
 	} InitializationStruct;
 
 	//Creates instance of InitialziationStruct with basic application information
@@ -143,6 +607,14 @@ extern "C" {
 		const char* extensionName
 	) CPPONLY(noexcept);
 
+	//Selects validation startInstance enables. Layers are checked with vkEnumerateInstanceLayerProperties first, what isn't
+	//installed is skipped, see validationEnabled and validationFeaturesEnabled. Call before startInstance
+	InitializationStruct* withValidation(
+		InitializationStruct* initStruct,
+		ValidationProfile profile,
+		/*ValidationFeatureBits, only used by VALIDATION_PROFILE_EXTENDED*/ uint32_t validationFeatures
+	) CPPONLY(noexcept);
+
 	//Starts a vulkan instance with extensions provided using addExtension
 	InitializationStruct* startInstance(
 		InitializationStruct* initStruct
@@ -153,12 +625,36 @@ extern "C" {
 		InitializationStruct* initStruct
 	) CPPONLY(noexcept);
 
+	//Destroys device with what library created on it (retired swapchains, memory allocator, pipeline cache after saving it),
+	//so device can go before instance. App's objects on device have to be destroyed first. terminateInstance calls it
+	void destroyDevice(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Destroys surface of withSurface* call, swapchains on it have to be destroyed first. terminateInstance calls it
+	void destroySurface(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
 	//Enumerates and selects a suitable physical device, provide deviceEnumerator for custom selection rules
 	InitializationStruct* selectPhysicalDevices(
 		InitializationStruct* initStruct,
-		/*can be NULL. If so, selects first device available*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices,
+		/*can be NULL. If so, selects highest scored device (see scorePhysicalDevices), VK_NULL_HANDLE if none is suitable*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices,
 			size_t deviceCount, /*ex. required device extensions*/ void* additionalData),
-		/*if device enumerator is null, can be null, because default implementation ignores it*/ void* additionalData
+		/*if device enumerator is null, can be const DeviceSelectionPolicy* or null for default policy*/ void* additionalData
+	) CPPONLY(noexcept);
+
+	//Default weights: discrete > integrated > virtual > CPU, then device local memory and dedicated queues. Graphics queue
+	//and (with surface) presentation support are required
+	DeviceSelectionPolicy defaultDeviceSelectionPolicy(
+	) CPPONLY(noexcept);
+
+	//Scores every physical device, works like vkEnumerate* (scores NULL -> count only). Call after surface is created so presentation support is counted
+	void scorePhysicalDevices(
+		InitializationStruct* initStruct,
+		/*can be null, if so, uses default policy*/ const DeviceSelectionPolicy* policy,
+		uint32_t* scoreCount,
+		/*can be null*/ PhysicalDeviceScore* scores
 	) CPPONLY(noexcept);
 
 	//Creates logical device with extensions provided
@@ -177,6 +673,157 @@ extern "C" {
 		/*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices)
 	) CPPONLY(noexcept);
 
+	//retrieveQueues of default createDevice path with compute and transfer queues as well, familyIndices gets DefaultQueueIndices.
+	//Does nothing if createDevice was called with custom deviceDesigner
+	void retrieveDefaultQueues(
+		InitializationStruct* initStruct,
+		DefaultQueueRetrieveStruct* queues,
+		uint32_t** familyIndices
+	) CPPONLY(noexcept);
+
+	//Requests up to queueCount queues from family of role in default createDevice path (call before createDevice). Clamped to what
+	//the family offers. If roles share a family, larger count wins and priorities are maxed per queue
+	InitializationStruct* withQueueCount(
+		InitializationStruct* initStruct,
+		QueueRole role,
+		uint32_t queueCount,
+		/*can be null (all 1.0f), otherwise queueCount priorities in [0, 1], has to stay alive until createDevice*/ const float* priorities
+	) CPPONLY(noexcept);
+
+	//Returns queue queueIndex of family of role, VK_NULL_HANDLE if family has less queues. Default createDevice path only
+	VkQueue retrieveQueue(
+		InitializationStruct* initStruct,
+		QueueRole role,
+		uint32_t queueIndex
+	) CPPONLY(noexcept);
+
+	//Hands out one queue per worker thread, worker i gets queue i % returned count, so as long as workerCount <= returned count
+	//every worker submits to its own queue without locking. Queue 0 of graphics and presentation family is left out, frame loop
+	//submits to it. Returns count of queues handed out (workerQueues can be null), 0 if family has no other queue (see withQueueCount)
+	uint32_t retrieveWorkerQueues(
+		InitializationStruct* initStruct,
+		QueueRole role,
+		uint32_t workerCount,
+		/*can be null*/ VkQueue* workerQueues
+	) CPPONLY(noexcept);
+
+	//Sets size of device memory blocks the sub-allocator carves allocations from (default 64 MiB, capped at 1/8 of the heap).
+	//Call before first allocation
+	InitializationStruct* withMemoryAllocator(
+		InitializationStruct* initStruct,
+		VkDeviceSize blockSize
+	) CPPONLY(noexcept);
+
+	//Creates swapchain images with VK_IMAGE_USAGE_TRANSFER_SRC_BIT so they can be copied by recordImageReadback.
+	//Call before createSwapchainKHR
+	InitializationStruct* withSwapchainReadback(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Enables timelineSemaphore feature in default createDevice path (call before createDevice), required by TimelineQueue.
+	//Core in 1.2, for 1.1 devices pass VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME in deviceExtensions
+	InitializationStruct* withTimelineSemaphores(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Enables descriptor indexing features BindlessTable needs in default createDevice path (call before createDevice).
+	//Core in 1.2, for 1.1 devices pass VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME in deviceExtensions
+	InitializationStruct* withBindlessDescriptors(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Nothing required. Optional: anisotropy, multi draw indirect, timeline semaphores, buffer device address, descriptor indexing,
+	//synchronization2, dynamic rendering and maintenance4, so fast paths are on wherever device has them
+	FeatureRequest defaultFeatureRequest(
+	) CPPONLY(noexcept);
+
+	//Negotiates request against one enumeration of layers/extensions/features in startInstance and default createDevice path,
+	//result is in initStruct->featureGrant. Call before startInstance, request has to stay alive until createDevice.
+	//Without request createDevice enables every 1.0 feature device has, like it always did
+	InitializationStruct* withFeatureRequest(
+		InitializationStruct* initStruct,
+		const FeatureRequest* request
+	) CPPONLY(noexcept);
+
+	//Sets file the pipeline cache is seeded from and saved to. If called before createDevice, cache is created right after device,
+	//otherwise immediately. Files written by a different device or driver are discarded
+	InitializationStruct* withPipelineCache(
+		InitializationStruct* initStruct,
+		const char* cachePath
+	) CPPONLY(noexcept);
+
+	//Starts recording how long every init step takes (startInstance, selectPhysicalDevices, createDevice, createSwapchainKHR...)
+	//and the Vulkan calls they make. Call right after createApplication (and withAllocationCallbacks), trace is freed by terminateInstance
+	InitializationStruct* withInitTracing(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Opens scope of app's own init work (ex. shader loading), so it shows up next to library steps. UINT32_MAX if tracing is off
+	uint32_t beginTraceScope(
+		InitializationStruct* initStruct,
+		/*has to outlive the trace*/ const char* name
+	) CPPONLY(noexcept);
+
+	void endTraceScope(
+		InitializationStruct* initStruct,
+		uint32_t traceScope
+	) CPPONLY(noexcept);
+
+	//Writes trace as Chrome trace event JSON, open it in chrome://tracing or ui.perfetto.dev. Call before terminateInstance
+	VkResult exportInitTrace(
+		const InitializationStruct* initStruct,
+		const char* path
+	) CPPONLY(noexcept);
+
+	//Routes every create/destroy call and library's host memory through allocationCallbacks (except JobSystem, writeShaderArchive
+	//and swapchain image arrays handed to app, those stay on CRT). Call right after createApplication,
+	//callbacks have to outlive terminateInstance. With trackStatistics, allocations are counted per scope, see getAllocationStats.
+	//Extensions added before are moved to new callbacks, does nothing once instance, scratch memory, init trace or statistics exist
+	InitializationStruct* withAllocationCallbacks(
+		InitializationStruct* initStruct,
+		/*can be null (CRT)*/ const VkAllocationCallbacks* allocationCallbacks,
+		bool trackStatistics
+	) CPPONLY(noexcept);
+
+	//Thread safe, drivers allocate from any thread. False (and zeroed stats) if statistics aren't tracked
+	bool getAllocationStats(
+		const InitializationStruct* initStruct,
+		AllocationStats* stats
+	) CPPONLY(noexcept);
+
+	//Sets size of scratch arena blocks (default 64 KiB). Call before startInstance
+	InitializationStruct* withScratchArena(
+		InitializationStruct* initStruct,
+		size_t blockSize
+	) CPPONLY(noexcept);
+
+	ScratchMark scratchMark(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Memory stays valid until scratchRewind to a mark taken before it. NULL on failure
+	void* scratchAllocate(
+		InitializationStruct* initStruct,
+		size_t size
+	) CPPONLY(noexcept);
+
+	//Frees everything allocated after mark at once
+	void scratchRewind(
+		InitializationStruct* initStruct,
+		ScratchMark mark
+	) CPPONLY(noexcept);
+
+	//Writes pipeline cache back to disk (write to temporary file + rename), terminateInstance calls it for you
+	VkResult savePipelineCache(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Counts cache hit/miss from VK_EXT_pipeline_creation_feedback output chained into pipeline creation
+	void recordPipelineCacheFeedback(
+		InitializationStruct* initStruct,
+		const VkPipelineCreationFeedbackEXT* pipelineFeedback
+	) CPPONLY(noexcept);
+
 	//Creates debug messenger, for simpler calls see withDebugOutput1 and withDebugOutput2
 	InitializationStruct* withDebugOutput(
 		InitializationStruct* initStruct,
@@ -199,6 +846,53 @@ extern "C" {
 		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc
 	) CPPONLY(noexcept);
 
+	typedef struct DebugSinkStats
+	{
+		uint64_t receivedCount;
+		uint64_t deliveredCount;
+		uint64_t suppressedCount; //over repeat limit of their messageIdNumber
+		uint64_t droppedCount; //ring was full
+		uint64_t truncatedCount; //longer than VKCMDINIT_DEBUG_MESSAGE_SIZE
+		uint32_t untrackedIdCount; //ids that didn't fit id table, they aren't rate limited
+	} DebugSinkStats;
+
+	typedef struct DebugMessageIdStats
+	{
+		int32_t messageIdNumber;
+		uint64_t receivedCount;
+		uint64_t deliveredCount;
+		uint64_t suppressedCount;
+		uint64_t droppedCount;
+	} DebugMessageIdStats;
+
+	//Creates debug messenger whose callback only copies message into a lock-free ring, debugOutputProc is called on a background
+	//thread, so thread that triggered the message never waits for it. Objects and labels aren't copied, callback data has only ids
+	//and text. Each messageIdNumber is delivered at most repeatLimitPerSecond times a second (0 means no limit), the rest is counted.
+	//Thread is stopped by terminateInstance after last message was delivered
+	InitializationStruct* withDebugOutputSink(
+		InitializationStruct* initStruct,
+		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
+		void* userData,
+		VkDebugUtilsMessageSeverityFlagsEXT messageSeverity,
+		VkDebugUtilsMessageTypeFlagsEXT messageType,
+		uint32_t ringCapacity, //rounded up to power of 2, 0 means 256
+		uint32_t repeatLimitPerSecond
+	) CPPONLY(noexcept);
+
+	//Blocks until every message queued before the call was delivered (ex. before aborting on error)
+	void flushDebugOutputSink(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Thread safe. idStatCount is capacity of idStats on input and ids written on output, idStats can be null.
+	//False (and zeroed stats) if withDebugOutputSink wasn't used
+	bool getDebugOutputSinkStats(
+		const InitializationStruct* initStruct,
+		DebugSinkStats* stats,
+		/*can be null*/ uint32_t* idStatCount,
+		/*can be null*/ DebugMessageIdStats* idStats
+	) CPPONLY(noexcept);
+
 #ifdef VKCMDINIT_GLFW
 	//Creates window surface using GLFWwindow (platform-independent)
 	InitializationStruct* withSurfaceGLFW(
@@ -216,7 +910,12 @@ extern "C" {
 	);
 #endif
 
-	//Creates generic swapchain and retrieves images and image views from it
+	//Creates windowless surface using VK_EXT_headless_surface (add it with addExtension), createSwapchainKHR works with it as with a window
+	InitializationStruct* withSurfaceHeadless(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
+
+	//Creates generic swapchain and retrieves images and image views from it, caller frees both arrays with free()
 	VkSwapchainKHR createSwapchainKHR(
 		InitializationStruct* initStruct,
 		/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount),
@@ -227,440 +926,8157 @@ extern "C" {
 		/*can be null*/ VkImageView** swapchainImageViews
 	);
 
-#ifdef VKCMDINIT_CPP
-}
-#endif
+	//createSwapchainKHR with surface format and present mode already chosen from ones surface supports (ex. by vki::createSwapchainKHR<Config>)
+	VkSwapchainKHR createSwapchainKHRWithFormat(
+		InitializationStruct* initStruct,
+		VkSurfaceFormatKHR surfaceFormat,
+		VkPresentModeKHR presentMode,
+		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+		uint32_t* swapchainImageCount,
+		VkImage** swapchainImages,
+		/*can be null*/ VkImageView** swapchainImageViews
+	) CPPONLY(noexcept);
 
-#ifdef VKCMDINIT_IMPL
-#include <stdlib.h>
+	//Default surface format selector: B8G8R8A8 in sRGB nonlinear color space, first format if there is none
+	VkSurfaceFormatKHR selectDefaultSurfaceFormat(
+		VkSurfaceFormatKHR* surfaceFormats,
+		size_t surfaceFormatCount
+	) CPPONLY(noexcept);
 
-#ifdef VKCMDINIT_CPP
-extern "C" {
-#endif
+	//Default present mode selector: first MAILBOX or FIFO mode, FIFO if there is none
+	VkPresentModeKHR selectDefaultPresentMode(
+		VkPresentModeKHR* presentModes,
+		size_t presentModeCount
+	) CPPONLY(noexcept);
 
+	//Recreates swapchain created by createSwapchainKHR (i.e. after resize) without waiting for the device.
+	//Format, present mode and surfaceDesigner from createSwapchainKHR are reused and oldSwapchain is handed to the driver.
+	//Image arrays are reused (in: old arrays and count, out: new ones). Old swapchain and image views are destroyed by
+	//collectRetiredSwapchains once frame retireAfterFrame completed. Returns VK_NULL_HANDLE and keeps old swapchain if window is minimized
+	//or out of host memory
+	VkSwapchainKHR recreateSwapchainKHR(
+		InitializationStruct* initStruct,
+		VkSwapchainKHR oldSwapchain,
+		/*i.e. current frame number, resources are kept until this frame is done*/ uint64_t retireAfterFrame,
+		uint32_t* swapchainImageCount,
+		VkImage** swapchainImages,
+		/*can be null*/ VkImageView** swapchainImageViews
+	) CPPONLY(noexcept);
 
-	InitializationStruct createApplication(
-		const char* engineName,
-		const char* applicationName,
-		uint32_t applicationVersion,
-		uint32_t engineVersion,
-		uint32_t apiVersion
-	)
-	{
-		InitializationStruct initStruct = { ZERO };
+	//createSwapchainKHR writing to app's arrays of imageCapacity elements (ex. VKCMDINIT_MAX_SWAPCHAIN_IMAGES) instead of
+	//allocating them. Returns VK_NULL_HANDLE and zero count if swapchain has more images
+	VkSwapchainKHR createSwapchainKHRInPlace(
+		InitializationStruct* initStruct,
+		/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount),
+		/*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount),
+		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+		uint32_t imageCapacity,
+		uint32_t* swapchainImageCount,
+		VkImage* swapchainImages,
+		/*can be null*/ VkImageView* swapchainImageViews
+	) CPPONLY(noexcept);
 
-		VkApplicationInfo appInfo = { ZERO };
+	//recreateSwapchainKHR for swapchains of createSwapchainKHRInPlace, arrays are overwritten in place
+	VkSwapchainKHR recreateSwapchainKHRInPlace(
+		InitializationStruct* initStruct,
+		VkSwapchainKHR oldSwapchain,
+		/*i.e. current frame number, resources are kept until this frame is done*/ uint64_t retireAfterFrame,
+		uint32_t imageCapacity,
+		uint32_t* swapchainImageCount,
+		VkImage* swapchainImages,
+		/*can be null*/ VkImageView* swapchainImageViews
+	) CPPONLY(noexcept);
 
-		appInfo.engineVersion = engineVersion;
-		appInfo.apiVersion = apiVersion;
-		appInfo.applicationVersion = applicationVersion;
-		appInfo.pEngineName = engineName;
-		appInfo.pApplicationName = applicationName;
+	//Destroys swapchains retired by recreateSwapchainKHR whose frames are done, never waits. Call once per frame
+	void collectRetiredSwapchains(
+		InitializationStruct* initStruct,
+		/*frames up to and including this one have finished on GPU*/ uint64_t completedFrame
+	) CPPONLY(noexcept);
 
-		appInfo.pNext = NULL;
-		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	//Ring of device-local images standing in for a swapchain when there is nothing to present to
+	typedef struct OffscreenSwapchain
+	{
+		VkDeviceMemory memory; //backs all images
+		VkImage* images;
+		uint32_t imageCount;
+		VkFormat format;
+		VkExtent2D extent;
+		uint32_t nextImage;
+	} OffscreenSwapchain;
+
+	//Creates offscreen swapchain with same output contract as createSwapchainKHR: caller destroys image views and frees both arrays (free()),
+	//images themselves belong to the offscreen swapchain. Works without surface and without swapchain extension.
+	//NULL if imageCount is 0 or on failure
+	OffscreenSwapchain* createOffscreenSwapchain(
+		InitializationStruct* initStruct,
+		VkFormat format,
+		VkExtent2D extent,
+		uint32_t imageCount,
+		uint32_t* swapchainImageCount,
+		VkImage** swapchainImages,
+		/*can be null*/ VkImageView** swapchainImageViews
+	) CPPONLY(noexcept);
 
-		VkInstanceCreateInfo instanceCreateInfo = { ZERO };
+	//Counterpart of vkAcquireNextImageKHR, never blocks. Images are handed out round-robin.
+	//Semaphore and fence can be VK_NULL_HANDLE, if not, they are signaled by an empty submit on queue
+	VkResult acquireOffscreenImage(
+		InitializationStruct* initStruct,
+		OffscreenSwapchain* offscreenSwapchain,
+		VkQueue queue,
+		VkSemaphore semaphore,
+		VkFence fence,
+		uint32_t* imageIndex
+	) CPPONLY(noexcept);
 
-		instanceCreateInfo.pNext = NULL;
-		instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	//Counterpart of vkQueuePresentKHR. Nothing is displayed, wait semaphores are consumed by an empty submit so binary semaphores can be reused
+	VkResult presentOffscreenImage(
+		InitializationStruct* initStruct,
+		OffscreenSwapchain* offscreenSwapchain,
+		VkQueue queue,
+		uint32_t waitSemaphoreCount,
+		const VkSemaphore* waitSemaphores,
+		uint32_t imageIndex
+	) CPPONLY(noexcept);
 
-		initStruct.appInfo = appInfo;
-		initStruct.instanceInfo = instanceCreateInfo;
+	//Destroys images and their memory, image views returned by createOffscreenSwapchain have to be destroyed before
+	void destroyOffscreenSwapchain(
+		InitializationStruct* initStruct,
+		OffscreenSwapchain* offscreenSwapchain
+	) CPPONLY(noexcept);
 
-		initStruct.extensionCount = 0;
-		initStruct.extensionPtr = NULL;
-		return initStruct;
-	}
 
-	InitializationStruct* addExtension(InitializationStruct* initStruct, const char* extensionName)
+	//Resources owned by one frame in flight
+	typedef struct FrameData
 	{
+		VkCommandPool commandPool; //reset as a whole at the start of the frame
+		VkCommandBuffer commandBuffer;
+		VkFence inFlightFence;
+		VkSemaphore imageAcquiredSemaphore;
+	} FrameData;
+
+	//Acquire -> record -> submit -> present loop with N frames in flight, see beginFrame and endFrame.
+	//Targets either a swapchain from createSwapchainKHR or an offscreen swapchain
+	typedef struct FrameContext
+	{
+		uint32_t framesInFlight;
+		FrameData* frames;
 
-		const char** ptr = (const char**)malloc(sizeof(const char* const) * (initStruct->extensionCount + 1));
-
-		for (uint32_t i = 0; i < initStruct->extensionCount; ++i)
-			ptr[i] = initStruct->extensionPtr[i];
+		//One per image, not per frame. Presentation may still wait on it after the frame's fence signaled
+		VkSemaphore* renderCompleteSemaphores;
+		uint32_t renderCompleteSemaphoreCount;
 
+		VkQueue graphicsQueue;
+		VkQueue presentationQueue;
+		VkSwapchainKHR swapchain;
+		OffscreenSwapchain* offscreenSwapchain;
 
-		ptr[initStruct->extensionCount] = extensionName;
+		uint64_t frameNumber; //frames begun so far
+		uint32_t frameIndex; //frameNumber % framesInFlight
+		uint32_t imageIndex;
+	} FrameContext;
 
-		initStruct->extensionCount += 1;
+	//Creates frame context. Uses queues and graphics family from default createDevice path, offscreenSwapchain is used if swapchain is VK_NULL_HANDLE.
+	//NULL on failure or if device wasn't created by default path
+	FrameContext* createFrameContext(
+		InitializationStruct* initStruct,
+		const DefaultQueueRetrieveStruct* queues,
+		/*2 lets CPU record next frame while GPU renders current one*/ uint32_t framesInFlight,
+		VkSwapchainKHR swapchain,
+		/*can be null*/ OffscreenSwapchain* offscreenSwapchain,
+		uint32_t swapchainImageCount
+	) CPPONLY(noexcept);
 
-		free(initStruct->extensionPtr);
+	//Waits until frame slot is free, collects retired swapchains, resets the slot's command pool, acquires image and begins commandBuffer.
+	//VK_ERROR_OUT_OF_DATE_KHR means swapchain has to be recreated (see recreateFrameSwapchain), frame wasn't begun then
+	VkResult beginFrame(
+		InitializationStruct* initStruct,
+		FrameContext* frameContext,
+		VkCommandBuffer* commandBuffer,
+		uint32_t* imageIndex
+	) CPPONLY(noexcept);
 
-		initStruct->extensionPtr = ptr;
+	//Ends command buffer, submits it (waiting for acquired image at color attachment output) and presents.
+	//VK_SUBOPTIMAL_KHR/VK_ERROR_OUT_OF_DATE_KHR mean swapchain should be recreated. If submit fails, frame isn't counted nor presented
+	VkResult endFrame(
+		InitializationStruct* initStruct,
+		FrameContext* frameContext
+	) CPPONLY(noexcept);
 
-		return initStruct;
-	}
+	//Calls recreateSwapchainKHR and points frame context at the new swapchain, old one is retired after frames in flight are done
+	VkResult recreateFrameSwapchain(
+		InitializationStruct* initStruct,
+		FrameContext* frameContext,
+		uint32_t* swapchainImageCount,
+		VkImage** swapchainImages,
+		/*can be null*/ VkImageView** swapchainImageViews
+	) CPPONLY(noexcept);
 
+	//Waits for all frames in flight and destroys frame context, swapchain stays alive
+	void destroyFrameContext(
+		InitializationStruct* initStruct,
+		FrameContext* frameContext
+	) CPPONLY(noexcept);
 
+	//Point on a timeline to wait for, see timelinePoint. Binary semaphores (ex. swapchain acquire) can be used too, value is ignored then
+	typedef struct TimelineWait
+	{
+		VkSemaphore semaphore;
+		uint64_t value;
+		VkPipelineStageFlags stageMask;
+	} TimelineWait;
 
-	InitializationStruct* startInstance(InitializationStruct* initStruct)
+	//Submission recorded by enqueueSubmit, offsets point into arrays of TimelineQueue
+	typedef struct TimelinePendingSubmit
 	{
-		const char* validation_layers[1] =
-		{
-			"VK_LAYER_KHRONOS_validation"
-		};
-		initStruct->instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-		initStruct->instanceInfo.enabledLayerCount = 1;
-		initStruct->instanceInfo.ppEnabledLayerNames = validation_layers;
-		initStruct->instanceInfo.pApplicationInfo = &initStruct->appInfo;
-		initStruct->instanceInfo.ppEnabledExtensionNames = initStruct->extensionPtr;
-		initStruct->instanceInfo.enabledExtensionCount = initStruct->extensionCount;
-		initStruct->instanceInfo.pNext = NULL;
-		vkCreateInstance(&initStruct->instanceInfo, NULL, &initStruct->instance);
-		free(initStruct->extensionPtr);
-		return initStruct;
-	}
-
-	void terminateInstance(InitializationStruct* initStruct)
+		uint32_t firstCommandBuffer;
+		uint32_t commandBufferCount;
+		uint32_t firstWait;
+		uint32_t waitCount;
+		uint64_t signalValue;
+		VkSemaphore binarySignalSemaphore;
+	} TimelinePendingSubmit;
+
+	//Queue with its own timeline semaphore, every enqueueSubmit signals next point. Submissions are batched until flushTimelineQueue,
+	//so N submits cost one vkQueueSubmit and no fences. Not thread safe, give each submitting thread its own (see retrieveWorkerQueues)
+	typedef struct TimelineQueue
 	{
+		const InitializationStruct* initStruct; //pending arrays grow through its allocation callbacks
+		VkQueue queue;
+		VkSemaphore timeline;
+		uint64_t enqueuedValue; //point signaled by the latest enqueueSubmit
+		uint64_t submittedValue; //highest point handed to vkQueueSubmit
+		uint64_t completedValue; //cached, refreshed by isTimelinePointReached and waitTimelinePoint
+
+		TimelinePendingSubmit* pendingSubmits;
+		uint32_t pendingSubmitCount;
+		uint32_t pendingSubmitCapacity;
+		VkCommandBuffer* pendingCommandBuffers;
+		uint32_t pendingCommandBufferCount;
+		uint32_t pendingCommandBufferCapacity;
+		TimelineWait* pendingWaits;
+		uint32_t pendingWaitCount;
+		uint32_t pendingWaitCapacity;
+		char* submitBlock; //reused by flushTimelineQueue, only grows
+		uint32_t submitBlockCapacity;
+	} TimelineQueue;
+
+	//Creates timeline queue on top of queue, device has to be created with withTimelineSemaphores. NULL on failure
+	TimelineQueue* createTimelineQueue(
+		InitializationStruct* initStruct,
+		VkQueue queue
+	) CPPONLY(noexcept);
 
-		if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
-		{
-			vkDestroySurfaceKHR(initStruct->instance, initStruct->surface, NULL);
-		}
+	//Wait on point of a timeline queue, use it to express cross-queue dependencies (ex. transfer -> compute -> graphics).
+	//Waiting on point not yet flushed on other queue is valid (wait-before-signal), it just has to be flushed eventually
+	TimelineWait timelinePoint(
+		const TimelineQueue* timelineQueue,
+		uint64_t value,
+		VkPipelineStageFlags stageMask
+	) CPPONLY(noexcept);
 
-		if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_DEBUG_MESSENGER)
-		{
-			//TODO: Store these functions
-			PFN_vkDestroyDebugUtilsMessengerEXT vkDestroyDebugUtilsMessengerEXT = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(initStruct->instance, "vkDestroyDebugUtilsMessengerEXT");
-			vkDestroyDebugUtilsMessengerEXT(initStruct->instance, initStruct->debugMessenger, NULL);
-		}
+	//Records submission without calling vkQueueSubmit, returns timeline point it signals on completion (0 on allocation failure)
+	uint64_t enqueueSubmit(
+		TimelineQueue* timelineQueue,
+		const VkCommandBuffer* commandBuffers,
+		uint32_t commandBufferCount,
+		/*can be null*/ const TimelineWait* waits,
+		uint32_t waitCount,
+		/*can be VK_NULL_HANDLE, ex. semaphore presentation waits on*/ VkSemaphore binarySignalSemaphore
+	) CPPONLY(noexcept);
 
-		vkDestroyDevice(initStruct->device, NULL);
-		vkDestroyInstance(initStruct->instance, NULL);
-	}
+	//Submits every pending submission with one vkQueueSubmit
+	VkResult flushTimelineQueue(
+		InitializationStruct* initStruct,
+		TimelineQueue* timelineQueue,
+		/*can be VK_NULL_HANDLE*/ VkFence fence
+	) CPPONLY(noexcept);
 
-	InitializationStruct* selectPhysicalDevices(InitializationStruct* initStruct, /*can be NULL. If so, selects first device available*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices, size_t deviceCount, /*ex. required device extensions*/ void* additionalData), /*if device enumerator is null, can be null, because default implementation ignores it*/ void* additionalData)
-	{
-		uint32_t deviceCount;
-		vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, NULL);
-		VkPhysicalDevice* devicesAvailable = (VkPhysicalDevice*)malloc(deviceCount * sizeof(VkPhysicalDevice));
-		vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, devicesAvailable);
+	//Non-blocking check if GPU reached value
+	bool isTimelinePointReached(
+		InitializationStruct* initStruct,
+		TimelineQueue* timelineQueue,
+		uint64_t value
+	) CPPONLY(noexcept);
 
-		if (deviceEnumerator)
-		{
-			initStruct->physicalDevice = deviceEnumerator(devicesAvailable, deviceCount, additionalData);
-		}
-		else
-		{
-			initStruct->physicalDevice = devicesAvailable[0];
-		}
+	//Flushes if value is still pending and waits until GPU reaches it. VK_NOT_READY if value was never enqueued
+	VkResult waitTimelinePoint(
+		InitializationStruct* initStruct,
+		TimelineQueue* timelineQueue,
+		uint64_t value,
+		uint64_t timeout
+	) CPPONLY(noexcept);
 
-		free(devicesAvailable);
+	//Flushes, waits for everything submitted and destroys timeline queue
+	void destroyTimelineQueue(
+		InitializationStruct* initStruct,
+		TimelineQueue* timelineQueue
+	) CPPONLY(noexcept);
 
-		return initStruct;
-	}
+	//What memory is used for, picks memory type
+	typedef enum GpuMemoryUsage
+	{
+		GPU_MEMORY_USAGE_DEVICE_LOCAL = 0, //GPU only, falls back to any type if implementation has no device local memory
+		GPU_MEMORY_USAGE_UPLOAD = 1, //host visible and coherent, CPU writes GPU reads
+		GPU_MEMORY_USAGE_READBACK = 2 //host visible, cached if available (invalidate before reading if it isn't coherent)
+	} GpuMemoryUsage;
 
-	InitializationStruct* createDevice(InitializationStruct* initStruct, /*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount), const char* const* deviceExtensions, uint32_t deviceExtensionCount)
+	typedef struct GpuMemoryBlock GpuMemoryBlock;
+
+	//Range of device memory returned by allocator. Host visible memory is persistently mapped
+	typedef struct GpuAllocation
 	{
-		VkDeviceCreateInfo deviceCreateInfo = { ZERO };
-		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-		if (deviceDesigner)
-		{
-			initStruct->queueIndices = deviceDesigner(initStruct->physicalDevice, &deviceCreateInfo, deviceExtensions, deviceExtensionCount);
-		}
-		else
-		{
+		VkDeviceMemory memory;
+		VkDeviceSize offset;
+		VkDeviceSize size;
+		void* mappedData; //already offset, null if memory isn't host visible
+		uint32_t memoryTypeIndex;
+
+		GpuMemoryBlock* block; //null for dedicated allocations
+		uint32_t node;
+	} GpuAllocation;
+
+	//Bump allocator over one allocation, reset as a whole. Use one per frame in flight and reset it once the frame's fence signaled
+	typedef struct GpuLinearArena
+	{
+		GpuAllocation allocation;
+		VkBuffer buffer; //VK_NULL_HANDLE if arena was created without bufferUsage
+		VkDeviceSize capacity;
+		VkDeviceSize head;
+		VkDeviceSize highWatermark; //largest head since creation, use it to size the arena
+	} GpuLinearArena;
+
+	typedef struct GpuMemoryStats
+	{
+		uint32_t blockCount;
+		uint32_t allocationCount; //sub-allocations inside blocks
+		uint32_t dedicatedAllocationCount;
+		uint32_t freeRangeCount;
+		VkDeviceSize blockBytes;
+		VkDeviceSize usedBytes; //inside blocks, includes rounding to allocator granularity
+		VkDeviceSize dedicatedBytes;
+		VkDeviceSize freeBytes;
+		VkDeviceSize largestFreeRange;
+		float fragmentation; //1 - largestFreeRange / freeBytes, 0 if free memory is a single range
+	} GpuMemoryStats;
+
+	//Allocates memory for buffer and binds it. Dedicated allocation is used if driver prefers it (VK_KHR_dedicated_allocation, core 1.1)
+	//or buffer is larger than half a block
+	VkResult allocateBufferMemory(
+		InitializationStruct* initStruct,
+		VkBuffer buffer,
+		GpuMemoryUsage usage,
+		GpuAllocation* allocation
+	) CPPONLY(noexcept);
 
-			VkPhysicalDeviceFeatures deviceFeatures;
-			vkGetPhysicalDeviceFeatures(initStruct->physicalDevice, &deviceFeatures);
-			deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+	//Allocates memory for image and binds it, see allocateBufferMemory. Image is assumed to have optimal tiling
+	VkResult allocateImageMemory(
+		InitializationStruct* initStruct,
+		VkImage image,
+		GpuMemoryUsage usage,
+		GpuAllocation* allocation
+	) CPPONLY(noexcept);
 
-			uint32_t queueFamilyCount;
-			vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, NULL);
-			VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)malloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount);
-			vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, queueFamilies);
+	//Returns allocation to its block (or frees dedicated memory), resource bound to it has to be destroyed already
+	void freeAllocation(
+		InitializationStruct* initStruct,
+		GpuAllocation* allocation
+	) CPPONLY(noexcept);
 
-			uint32_t graphicQueueIndex = 0;
-			uint32_t presentationQueueIndex = 0;
+	//Creates linear arena of capacity bytes. With bufferUsage, a buffer covering whole arena is created and offsets are relative to it,
+	//otherwise offsets are relative to allocation.offset (add it when binding). NULL on failure
+	GpuLinearArena* createLinearArena(
+		InitializationStruct* initStruct,
+		VkDeviceSize capacity,
+		GpuMemoryUsage usage,
+		/*0 = raw memory*/ VkBufferUsageFlags bufferUsage
+	) CPPONLY(noexcept);
 
-			for (uint32_t i = 0; i < queueFamilyCount; ++i)
-			{
-				//Do NOT use else if, there's a possibility that both queue families have same index (i.e. there's a universal queue family for 2)
+	//O(1) bump allocation, VK_ERROR_OUT_OF_DEVICE_MEMORY if arena is full
+	VkResult allocateFromArena(
+		GpuLinearArena* arena,
+		VkDeviceSize size,
+		/*power of two*/ VkDeviceSize alignment,
+		VkDeviceSize* offset,
+		/*can be null*/ void** mappedData
+	) CPPONLY(noexcept);
 
-				if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
-				{
-					graphicQueueIndex = i;
-				}
+	//Releases everything allocated from arena in O(1)
+	void resetLinearArena(
+		GpuLinearArena* arena
+	) CPPONLY(noexcept);
 
-				if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
-				{
-					VkBool32 supported = VK_FALSE;
-					vkGetPhysicalDeviceSurfaceSupportKHR(initStruct->physicalDevice, i, initStruct->surface, &supported);
-					if (supported)
-						presentationQueueIndex = i;
-				}
-			}
+	void destroyLinearArena(
+		InitializationStruct* initStruct,
+		GpuLinearArena* arena
+	) CPPONLY(noexcept);
 
-			free(queueFamilies);
+	//Walks all blocks, so don't call it every frame
+	void getMemoryStats(
+		InitializationStruct* initStruct,
+		/*can be null, otherwise VK_MAX_MEMORY_TYPES entries*/ GpuMemoryStats* memoryTypeStats,
+		/*can be null*/ GpuMemoryStats* totalStats
+	) CPPONLY(noexcept);
 
-			const float priority = 1.0f;
+	//Copies submitted together by one flushUploads, ring space up to ringEnd is free again once timelineValue is reached
+	typedef struct UploadBatch
+	{
+		uint64_t timelineValue;
+		VkDeviceSize ringEnd;
+		VkCommandBuffer commandBuffer;
+	} UploadBatch;
+
+	//Persistently mapped staging ring. Copies are recorded into one command buffer and submitted on flushUploads, space is
+	//reclaimed as the transfer queue's timeline advances. Not thread safe
+	typedef struct UploadRing
+	{
+		GpuAllocation allocation;
+		VkBuffer buffer;
+		VkDeviceSize capacity;
+		//Monotonic byte counters, position in ring is value % capacity. head - tail is space in use
+		VkDeviceSize head;
+		VkDeviceSize tail;
+		VkDeviceSize copyAlignment; //optimalBufferCopyOffsetAlignment, at least 16 so any texel format fits
+
+		TimelineQueue* timelineQueue;
+		uint32_t queueFamilyIndex;
+		VkCommandPool commandPool;
+		VkCommandBuffer recordingCommandBuffer; //VK_NULL_HANDLE until first copy after flush
+		uint32_t pendingCopyCount;
+
+		UploadBatch* batches; //in flight, oldest first
+		uint32_t batchCount;
+		uint32_t batchCapacity;
+		VkCommandBuffer* freeCommandBuffers;
+		uint32_t freeCommandBufferCount;
+		uint32_t freeCommandBufferCapacity;
+
+		uint64_t uploadedBytes;
+		uint32_t flushCount;
+		uint32_t stallCount; //times ring was full and had to wait for GPU, grow capacity if it isn't 0
+	} UploadRing;
+
+	//Creates upload ring of capacity bytes. Device has to be created with withTimelineSemaphores.
+	//Submits to transfer queue of default createDevice path, unless queue is given. NULL on failure
+	UploadRing* createUploadRing(
+		InitializationStruct* initStruct,
+		/*can be VK_NULL_HANDLE*/ VkQueue queue,
+		/*ignored if queue is VK_NULL_HANDLE*/ uint32_t queueFamilyIndex,
+		VkDeviceSize capacity
+	) CPPONLY(noexcept);
 
+	//Copies data into ring and records copy to dstBuffer, data can be freed right after. Uploads larger than half of the ring are split.
+	//If dstQueueFamilyIndex differs from ring's family, ownership is released to it, consumer has to record matching acquire barrier
+	VkResult uploadToBuffer(
+		InitializationStruct* initStruct,
+		UploadRing* uploadRing,
+		VkBuffer dstBuffer,
+		VkDeviceSize dstOffset,
+		const void* data,
+		VkDeviceSize size,
+		/*VK_QUEUE_FAMILY_IGNORED if buffer is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex
+	) CPPONLY(noexcept);
 
+	//Copies tightly packed texels into ring and records copy to one subresource region of image (region->bufferOffset is ignored).
+	//Image goes from oldLayout to finalLayout, ownership is released like in uploadToBuffer. Uploads larger than half of the ring are
+	//split at array layers or depth slices, VK_ERROR_OUT_OF_DEVICE_MEMORY if a single one doesn't fit in the ring
+	VkResult uploadToImage(
+		InitializationStruct* initStruct,
+		UploadRing* uploadRing,
+		VkImage dstImage,
+		const VkBufferImageCopy* region,
+		const void* data,
+		VkDeviceSize size,
+		/*VK_IMAGE_LAYOUT_UNDEFINED discards previous contents*/ VkImageLayout oldLayout,
+		VkImageLayout finalLayout,
+		/*VK_QUEUE_FAMILY_IGNORED if image is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex
+	) CPPONLY(noexcept);
 
-			VkDeviceQueueCreateInfo graphicQueueCreateInfo = { ZERO };
-			graphicQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-			graphicQueueCreateInfo.pQueuePriorities = &priority;
-			graphicQueueCreateInfo.queueCount = 1;
-			graphicQueueCreateInfo.queueFamilyIndex = graphicQueueIndex;
+	//Submits recorded copies, timelineValue gets point on uploadRing->timelineQueue they complete at (0 if nothing was pending).
+	//Wait for it with timelinePoint on other queues or waitTimelinePoint on CPU. If vkQueueSubmit fails, copies stay enqueued on
+	//timeline queue and are submitted by its next flush. VK_ERROR_OUT_OF_HOST_MEMORY means they were dropped and have to be uploaded again
+	VkResult flushUploads(
+		InitializationStruct* initStruct,
+		UploadRing* uploadRing,
+		/*can be null*/ uint64_t* timelineValue
+	) CPPONLY(noexcept);
 
-			VkDeviceQueueCreateInfo presentQueueCreateInfo = { ZERO };
-			presentQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-			presentQueueCreateInfo.pQueuePriorities = &priority;
-			presentQueueCreateInfo.queueCount = 1;
-			presentQueueCreateInfo.queueFamilyIndex = presentationQueueIndex;
+	//Flushes, waits for all uploads and destroys ring
+	void destroyUploadRing(
+		InitializationStruct* initStruct,
+		UploadRing* uploadRing
+	) CPPONLY(noexcept);
 
-			VkDeviceQueueCreateInfo queueCreateinfos[] = { graphicQueueCreateInfo,presentQueueCreateInfo };
-			deviceCreateInfo.queueCreateInfoCount = (presentationQueueIndex == graphicQueueIndex) ? 1 : 2;
-			deviceCreateInfo.pQueueCreateInfos = queueCreateinfos;
-			deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
-			deviceCreateInfo.enabledExtensionCount = deviceExtensionCount;
+	//Captured image, data stays valid until callback returns (or releaseReadback in polling mode)
+	typedef struct ReadbackResult
+	{
+		const void* data;
+		VkDeviceSize size;
+		uint32_t rowPitch; //tightly packed, width * texel size
+		VkExtent2D extent;
+		VkFormat format;
+		uint64_t frameNumber;
+		uint32_t slotIndex;
+	} ReadbackResult;
+
+	typedef void(*ReadbackCallback)(const ReadbackResult* result, void* userData);
+
+	typedef enum ReadbackSlotState
+	{
+		READBACK_SLOT_STATE_FREE = 0,
+		READBACK_SLOT_STATE_PENDING = 1, //copy recorded, frame not finished yet
+		READBACK_SLOT_STATE_READY = 2,
+		READBACK_SLOT_STATE_ACQUIRED = 3 //handed out by acquireReadback
+	} ReadbackSlotState;
 
+	typedef struct ReadbackSlot
+	{
+		VkBuffer buffer;
+		GpuAllocation allocation;
+		ReadbackSlotState state;
+		uint64_t frameNumber;
+		VkExtent2D extent;
+		VkFormat format;
+		VkDeviceSize size;
+	} ReadbackSlot;
+
+	//Ring of host visible (cached if available) buffers images are copied into from within a frame's command buffer.
+	//Results are picked up frames later by pollReadbacks, nothing ever waits on the GPU. Not thread safe
+	typedef struct ReadbackRing
+	{
+		ReadbackSlot* slots;
+		uint32_t slotCount;
+		VkDeviceSize slotSize;
+		VkDeviceSize nonCoherentAtomSize;
+		bool coherent;
+		uint32_t nextSlot;
+
+		ReadbackCallback callback;
+		void* userData;
+
+		uint64_t deliveredCount;
+		uint32_t droppedCount; //captures skipped because every slot was busy, add slots if it isn't 0
+	} ReadbackRing;
+
+	//Creates slotCount buffers of slotSize bytes (width * height * texel size of largest capture). Use framesInFlight + 1 slots or more.
+	//Without callback, results are polled with acquireReadback. NULL on failure
+	ReadbackRing* createReadbackRing(
+		InitializationStruct* initStruct,
+		uint32_t slotCount,
+		VkDeviceSize slotSize,
+		/*can be null*/ ReadbackCallback callback,
+		void* userData
+	) CPPONLY(noexcept);
 
-			DefaultQueueIndices defaultQueueIndices;
+	//Records copy of image's first mip/layer into next free slot, image is left in imageLayout. Record it after rendering, into the
+	//command buffer of frame frameNumber (FrameContext::frameNumber between beginFrame and endFrame).
+	//VK_NOT_READY if every slot is busy, capture is dropped then instead of waiting. Image in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR is taken
+	//as swapchain image, VK_ERROR_FEATURE_NOT_PRESENT if swapchain wasn't created with transfer source (see withSwapchainReadback)
+	VkResult recordImageReadback(
+		InitializationStruct* initStruct,
+		ReadbackRing* readbackRing,
+		VkCommandBuffer commandBuffer,
+		VkImage image,
+		/*ex. VK_IMAGE_LAYOUT_PRESENT_SRC_KHR after render pass*/ VkImageLayout imageLayout,
+		VkFormat format,
+		VkExtent2D extent,
+		uint64_t frameNumber
+	) CPPONLY(noexcept);
 
-			defaultQueueIndices.graphicQueueIndex = graphicQueueIndex;
-			defaultQueueIndices.presentationFamilyIndex = presentationQueueIndex;
+	//Marks captures of frames up to completedFrameNumber ready and hands them to callback. Never blocks, nor checks any fence, so
+	//completedFrameNumber must really be done. Values with top bit set (ex. frameNumber - framesInFlight wrapped during first frames)
+	//mean no frame is done. Returns number of captures that became ready
+	uint32_t pollReadbacks(
+		InitializationStruct* initStruct,
+		ReadbackRing* readbackRing,
+		uint64_t completedFrameNumber
+	) CPPONLY(noexcept);
 
-			initStruct->defaultQueueIndices = (DefaultQueueIndices*)malloc(sizeof(defaultQueueIndices));
-			*initStruct->defaultQueueIndices = defaultQueueIndices;
+	//pollReadbacks with frames FrameContext knows are done. Call after beginFrame, which waited for the slot's fence
+	uint32_t pollFrameReadbacks(
+		InitializationStruct* initStruct,
+		ReadbackRing* readbackRing,
+		const FrameContext* frameContext
+	) CPPONLY(noexcept);
 
-		}
-		vkCreateDevice(initStruct->physicalDevice, &deviceCreateInfo, NULL, &initStruct->device);
-		return initStruct;
-	}
+	//Polling mode, returns oldest ready capture. Slot is reused only after releaseReadback
+	bool acquireReadback(
+		ReadbackRing* readbackRing,
+		ReadbackResult* result
+	) CPPONLY(noexcept);
 
-	void retrieveQueues(InitializationStruct* initStruct, /*if queueRetriever isn't custom, should be array of a graphics queue and a presentation queue (non-initialized if VkSurfaceKHR isn't present)*/ VkQueue* queues, uint32_t** familyIndices, /*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices))
-	{
-		if (queueRetriever)
-		{
-			queueRetriever(initStruct->queueIndices, initStruct->device, queues, familyIndices);
-		}
-		else
-		{
-			vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->graphicQueueIndex, 0, &queues[0]);
-			if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
-				vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->presentationFamilyIndex, 0, &queues[1]);
-			*((DefaultQueueIndices**)familyIndices) = initStruct->defaultQueueIndices;
-		}
-	}
+	void releaseReadback(
+		ReadbackRing* readbackRing,
+		const ReadbackResult* result
+	) CPPONLY(noexcept);
 
-	InitializationStruct* withDebugOutput(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc, void* userData, VkDebugUtilsMessageSeverityFlagsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType)
-	{
-		VkDebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfo = { ZERO };
-		debugUtilsMessengerCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-		debugUtilsMessengerCreateInfo.messageSeverity = messageSeverity;
-		debugUtilsMessengerCreateInfo.messageType = messageType;
-		debugUtilsMessengerCreateInfo.pfnUserCallback = debugOutputProc;
-		debugUtilsMessengerCreateInfo.pUserData = userData;
+	//Buffers may still be written by GPU, wait for frames that recorded readbacks first (ex. destroyFrameContext)
+	void destroyReadbackRing(
+		InitializationStruct* initStruct,
+		ReadbackRing* readbackRing
+	) CPPONLY(noexcept);
 
+	//Pool gets ceil(ratio * setsPerPool) descriptors of type
+	typedef struct DescriptorPoolRatio
+	{
+		VkDescriptorType type;
+		float ratio;
+	} DescriptorPoolRatio;
+
+	//Hands out descriptor sets from pools created on demand, every new pool holds twice the sets of previous one (up to 4096).
+	//Full pools are set aside instead of failing, resetDescriptorAllocator resets all of them at once and keeps them for reuse,
+	//so with one allocator per frame in flight per-frame sets never free individually. Not thread safe
+	typedef struct DescriptorAllocator
+	{
+		DescriptorPoolRatio* ratios;
+		uint32_t ratioCount;
+		VkDescriptorPoolCreateFlags poolFlags;
+		uint32_t setsPerPool; //size of next created pool
+
+		VkDescriptorPool currentPool;
+		uint32_t currentPoolSetCount; //sets allocated from current pool since it was created or reset
+		VkDescriptorPool* fullPools;
+		uint32_t fullPoolCount;
+		uint32_t fullPoolCapacity;
+		VkDescriptorPool* freePools; //reset, reused before creating new ones
+		uint32_t freePoolCount;
+		uint32_t freePoolCapacity;
+
+		uint32_t poolCount;
+		uint64_t allocatedSetCount;
+	} DescriptorAllocator;
+
+	//ratios can be null, defaults cover common descriptor types. initialSetsPerPool 0 means 64. NULL on failure
+	DescriptorAllocator* createDescriptorAllocator(
+		InitializationStruct* initStruct,
+		/*can be null*/ const DescriptorPoolRatio* ratios,
+		uint32_t ratioCount,
+		uint32_t initialSetsPerPool
+	) CPPONLY(noexcept);
 
-		PFN_vkCreateDebugUtilsMessengerEXT vkCreateDebugUtilsMessengerEXT = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(initStruct->instance, "vkCreateDebugUtilsMessengerEXT");
-		vkCreateDebugUtilsMessengerEXT(initStruct->instance, &debugUtilsMessengerCreateInfo, NULL, &initStruct->debugMessenger);
+	//Allocates from current pool, moves on to a fresh one if it's out of memory or fragmented. Layout that doesn't fit into an empty pool
+	//returns VK_ERROR_OUT_OF_POOL_MEMORY without creating more pools, give it larger ratios or its own allocator
+	VkResult allocateDescriptorSet(
+		InitializationStruct* initStruct,
+		DescriptorAllocator* descriptorAllocator,
+		VkDescriptorSetLayout layout,
+		VkDescriptorSet* descriptorSet
+	) CPPONLY(noexcept);
 
-		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_DEBUG_MESSENGER;
+	//Frees every set allocated so far, GPU must be done with them (ex. after beginFrame waited for the frame's fence)
+	void resetDescriptorAllocator(
+		InitializationStruct* initStruct,
+		DescriptorAllocator* descriptorAllocator
+	) CPPONLY(noexcept);
 
-		return initStruct;
-	}
+	void destroyDescriptorAllocator(
+		InitializationStruct* initStruct,
+		DescriptorAllocator* descriptorAllocator
+	) CPPONLY(noexcept);
 
-	InitializationStruct* withDebugOutput1(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc, void* userData)
+	//Single descriptor of immutable set, bufferInfo is used for (dynamic) uniform/storage buffers, texelBufferView for texel buffers,
+	//imageInfo for everything else
+	typedef struct DescriptorWrite
 	{
-		//Default options from vulkan-tutorial.com
-		//Thanks!
-		return withDebugOutput(initStruct, debugOutputProc, userData, VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT, VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT);
-	}
-
-	InitializationStruct* withDebugOutput2(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc)
+		uint32_t binding;
+		uint32_t arrayElement;
+		VkDescriptorType type;
+		VkDescriptorBufferInfo bufferInfo;
+		VkDescriptorImageInfo imageInfo;
+		VkBufferView texelBufferView;
+	} DescriptorWrite;
+
+	typedef struct DescriptorCacheEntry
 	{
-		return withDebugOutput1(initStruct, debugOutputProc, NULL);
-	}
-
-#ifdef VKCMDINIT_GLFW
-	InitializationStruct* withSurfaceGLFW(InitializationStruct* initStruct, GLFWwindow* window)
+		uint64_t hash; //0 marks empty slot
+		uint64_t* key;
+		uint32_t keyWordCount;
+		VkDescriptorSetLayout layout; //owned by cache, VK_NULL_HANDLE for set entries
+		VkDescriptorSet set;
+	} DescriptorCacheEntry;
+
+	//Deduplicates descriptor set layouts and immutable descriptor sets by hash of their contents, identical requests return the same
+	//handle without calling into the driver. Open addressing, not thread safe
+	typedef struct DescriptorCache
 	{
-		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_SURFACE;
-		glfwCreateWindowSurface(initStruct->instance, window, NULL, &initStruct->surface);
-		return initStruct;
-	}
-#endif
+		DescriptorCacheEntry* entries;
+		uint32_t entryCapacity; //power of 2
+		uint32_t entryCount;
+		DescriptorAllocator* setAllocator; //immutable sets, never reset
 
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-	//FIXME: Untested
-	InitializationStruct* withSurfaceWin32(InitializationStruct* initStruct, HINSTANCE processHandle, HWND windowHandle)
-	{
+		uint64_t hitCount;
+		uint64_t missCount;
+	} DescriptorCache;
 
-		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_SURFACE;
+	//NULL on failure
+	DescriptorCache* createDescriptorCache(
+		InitializationStruct* initStruct
+	) CPPONLY(noexcept);
 
-		VkWin32SurfaceCreateInfoKHR win32SurfaceCreateInfo = { ZERO };
-		win32SurfaceCreateInfo.hinstance = processHandle;
-		win32SurfaceCreateInfo.hwnd = windowHandle;
-		win32SurfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
-		vkCreateWin32SurfaceKHR(initStruct->instance, &win32SurfaceCreateInfo, NULL, &initStruct->surface);
-		return initStruct;
-	}
+	//Returns cached layout for bindings, creates it on first request. Bindings are hashed in given order, including immutable samplers.
+	//Layout is owned by cache, do not destroy it. VK_NULL_HANDLE on failure
+	VkDescriptorSetLayout getDescriptorSetLayout(
+		InitializationStruct* initStruct,
+		DescriptorCache* descriptorCache,
+		const VkDescriptorSetLayoutBinding* bindings,
+		uint32_t bindingCount,
+		VkDescriptorSetLayoutCreateFlags flags
+	) CPPONLY(noexcept);
 
-	//TODO: Add Linux and Mac OS support
+	//Returns set of layout with writes applied, allocated and written only on first request. Sets are keyed by handle values,
+	//so resources (and layout) must outlive the cache, a destroyed handle the driver hands out again would return the stale set.
+	//VK_NULL_HANDLE on failure
+	VkDescriptorSet getImmutableDescriptorSet(
+		InitializationStruct* initStruct,
+		DescriptorCache* descriptorCache,
+		VkDescriptorSetLayout layout,
+		const DescriptorWrite* writes,
+		uint32_t writeCount
+	) CPPONLY(noexcept);
 
-#endif
+	//Destroys cached layouts and frees cached sets
+	void destroyDescriptorCache(
+		InitializationStruct* initStruct,
+		DescriptorCache* descriptorCache
+	) CPPONLY(noexcept);
 
-//PROVIDES UNIVERSAL, DEFAULT WAY OF CREATING A SWAPCHAIN
-//IF YOU NEED SOMETHING MORE CUSTOM, JUST WRITE YOUR OWN FUNCTION
-	VkSwapchainKHR createSwapchainKHR(InitializationStruct* initStruct, /*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount), /*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount), /*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	//Binding of BindlessTable each type lives in
+	typedef enum BindlessResourceType
 	{
-		if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
-		{
-			//Thanks vulkan-tutorial.com for that piece of code
+		BINDLESS_RESOURCE_TYPE_SAMPLED_IMAGE = 0, //layout(binding = 0) uniform texture2D images[];
+		BINDLESS_RESOURCE_TYPE_STORAGE_BUFFER = 1, //layout(binding = 1) buffer Buffers { ... } buffers[];
+		BINDLESS_RESOURCE_TYPE_SAMPLER = 2, //layout(binding = 2) uniform sampler samplers[];
+		BINDLESS_RESOURCE_TYPE_COUNT = 3
+	} BindlessResourceType;
+
+	//Single update-after-bind set holding every resource, shaders index arrays with nonuniformEXT(index) instead of binding sets per draw.
+	//Bind it once per command buffer. Device has to be created with withBindlessDescriptors. Not thread safe
+	typedef struct BindlessTable
+	{
+		VkDescriptorPool pool;
+		VkDescriptorSetLayout layout;
+		VkDescriptorSet set;
+
+		uint32_t capacities[BINDLESS_RESOURCE_TYPE_COUNT];
+		uint32_t usedCounts[BINDLESS_RESOURCE_TYPE_COUNT]; //high watermark, indices above it were never handed out
+		uint32_t* freeIndices[BINDLESS_RESOURCE_TYPE_COUNT]; //removed indices, reused first
+		uint32_t freeIndexCounts[BINDLESS_RESOURCE_TYPE_COUNT];
+		uint32_t* freeMasks[BINDLESS_RESOURCE_TYPE_COUNT]; //bit per index, set while it sits in freeIndices
+	} BindlessTable;
+
+	//Capacities must not exceed maxDescriptorSetUpdateAfterBind* limits. NULL on failure
+	BindlessTable* createBindlessTable(
+		InitializationStruct* initStruct,
+		uint32_t maxSampledImages,
+		uint32_t maxStorageBuffers,
+		uint32_t maxSamplers
+	) CPPONLY(noexcept);
 
-			VkSurfaceCapabilitiesKHR surfaceCapabilities;
-			vkGetPhysicalDeviceSurfaceCapabilitiesKHR(initStruct->physicalDevice, initStruct->surface, &surfaceCapabilities);
+	//Writes image view into table, returns index shaders use or UINT32_MAX if table is full
+	uint32_t bindlessAddImage(
+		InitializationStruct* initStruct,
+		BindlessTable* bindlessTable,
+		VkImageView imageView,
+		VkImageLayout imageLayout
+	) CPPONLY(noexcept);
 
-			uint32_t surfaceFormatCount = 0;
-			vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct->physicalDevice, initStruct->surface, &surfaceFormatCount, NULL);
-			VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)malloc(surfaceFormatCount * sizeof(VkSurfaceFormatKHR));
-			vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct->physicalDevice, initStruct->surface, &surfaceFormatCount, surfaceFormats);
+	//Writes buffer range into table, returns index shaders use or UINT32_MAX if table is full
+	uint32_t bindlessAddBuffer(
+		InitializationStruct* initStruct,
+		BindlessTable* bindlessTable,
+		VkBuffer buffer,
+		VkDeviceSize offset,
+		VkDeviceSize range
+	) CPPONLY(noexcept);
 
-			uint32_t presentModeCount = 0;
-			vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct->physicalDevice, initStruct->surface, &presentModeCount, NULL);
-			VkPresentModeKHR* presentModes = (VkPresentModeKHR*)malloc(presentModeCount * sizeof(VkPresentModeKHR));
-			vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct->physicalDevice, initStruct->surface, &presentModeCount, presentModes);
+	//Writes sampler into table, returns index shaders use or UINT32_MAX if table is full
+	uint32_t bindlessAddSampler(
+		InitializationStruct* initStruct,
+		BindlessTable* bindlessTable,
+		VkSampler sampler
+	) CPPONLY(noexcept);
 
-			if (presentModeCount > 0 && surfaceFormatCount > 0)
-			{
-				VkSurfaceFormatKHR chosenFormat;
-				VkPresentModeKHR chosenMode;
+	//Makes index available again, removing index that is already free is ignored. Submitted work may still read it,
+	//so only remove resources once frames using them finished
+	void bindlessRemove(
+		BindlessTable* bindlessTable,
+		BindlessResourceType type,
+		uint32_t index
+	) CPPONLY(noexcept);
 
-				if (surfaceFormatSelector)
-					chosenFormat = surfaceFormatSelector(surfaceFormats, surfaceFormatCount);
-				else
-				{
-					chosenFormat = surfaceFormats[0];
-					for (size_t i = 0; i < surfaceFormatCount; ++i)
-					{
-						VkSurfaceFormatKHR format = surfaceFormats[i];
-						if (format.colorSpace == VK_COLORSPACE_SRGB_NONLINEAR_KHR /*preferred*/)
-						{
-							if (format.format == VK_FORMAT_B8G8R8A8_UNORM || format.format == VK_FORMAT_B8G8R8A8_SRGB || format.format == VK_FORMAT_B8G8R8A8_SNORM)
-							{
-								chosenFormat = format;
-								break;
-							}
-						}
-					}
-				}
+	void destroyBindlessTable(
+		InitializationStruct* initStruct,
+		BindlessTable* bindlessTable
+	) CPPONLY(noexcept);
 
-				if (presentModeSelector)
-				{
-					chosenMode = presentModeSelector(presentModes, presentModeCount);
-				}
-				else
-				{
-					for (size_t i = 0; i < presentModeCount; ++i)
-					{
-						VkPresentModeKHR mode = presentModes[i];
-						if (mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR || mode == VK_PRESENT_MODE_IMMEDIATE_KHR)
-							; //ignore!
-						else
-						{
-							//MAILBOX or FIFO will do!
-							chosenMode = mode;
-							break;
-						}
-					}
-				}
+	//Worker threads with one work-stealing deque each. Jobs submitted from a job go to that worker's deque, others are spread round robin.
+	//Workers pop own jobs newest first and steal oldest jobs of others when idle
+	typedef struct JobSystem JobSystem;
 
-				VkExtent2D extent = { 0,0 };
-				uint32_t imageCount = 0;
-				surfaceDesigner(&surfaceCapabilities, &extent, &imageCount);
-
-				VkSwapchainCreateInfoKHR swapchainCreateinfo = { ZERO };
-				swapchainCreateinfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-				swapchainCreateinfo.clipped = VK_TRUE;
-				swapchainCreateinfo.minImageCount = imageCount;
-				swapchainCreateinfo.imageExtent = extent;
-				swapchainCreateinfo.surface = initStruct->surface;
-				swapchainCreateinfo.imageColorSpace = chosenFormat.colorSpace;
-				swapchainCreateinfo.imageFormat = chosenFormat.format;
-				swapchainCreateinfo.presentMode = chosenMode;
-				swapchainCreateinfo.imageArrayLayers = 1; //It's some strange thing so I won't touch it..
-				swapchainCreateinfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-				//Once again, thanks vulkan-tutorial for this code piece
-				if (initStruct->defaultQueueIndices->graphicQueueIndex != initStruct->defaultQueueIndices->presentationFamilyIndex)
-				{
-					swapchainCreateinfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-					swapchainCreateinfo.queueFamilyIndexCount = 2;
-					swapchainCreateinfo.pQueueFamilyIndices = (uint32_t*)initStruct->defaultQueueIndices;
-				}
-				else
-				{
-					swapchainCreateinfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-					swapchainCreateinfo.queueFamilyIndexCount = 0;
-					swapchainCreateinfo.pQueueFamilyIndices = NULL;
-				}
-				//TODO: Make this customizable
-				swapchainCreateinfo.preTransform = surfaceCapabilities.currentTransform;
-				swapchainCreateinfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	//workerIndex is in [0, workerCount) and unique among jobs running at the same time, use it to index per-thread data
+	typedef void(*JobFunction)(void* userData, uint32_t workerIndex);
 
-				//TODO: Allow for this?
-				//swapchainCreateinfo.oldSwapchain = 0;
+	//Zero-initialize, pass to submitJob for every job of a batch, then waitJobCounter
+	typedef struct JobCounter
+	{
+		volatile long pendingJobCount;
+	} JobCounter;
 
-				VkSwapchainKHR swapchain;
-				vkCreateSwapchainKHR(initStruct->device, &swapchainCreateinfo, NULL, &swapchain);
+	//workerCount 0 means one worker per core. NULL on failure
+	JobSystem* createJobSystem(
+		uint32_t workerCount
+	) CPPONLY(noexcept);
 
-				vkGetSwapchainImagesKHR(initStruct->device, swapchain, swapchainImageCount, NULL);
-				*swapchainImages = (VkImage*)malloc(sizeof(VkImage) * (*swapchainImageCount));
-				vkGetSwapchainImagesKHR(initStruct->device, swapchain, swapchainImageCount, *swapchainImages);
+	uint32_t getJobWorkerCount(
+		const JobSystem* jobSystem
+	) CPPONLY(noexcept);
 
-				if (swapchainImageViews)
-				{
-					*swapchainImageViews = (VkImageView*)malloc(sizeof(VkImageView) * (*swapchainImageCount));
-					for (uint32_t i = 0; i < *swapchainImageCount; ++i)
-					{
-						VkImageViewCreateInfo swapchainImageViewCreateInfo = { ZERO };
-						swapchainImageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-						swapchainImageViewCreateInfo.image = (*swapchainImages)[i];
-						swapchainImageViewCreateInfo.components = CPPEXCLUDE((VkComponentMapping)) { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-						swapchainImageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-						swapchainImageViewCreateInfo.format = chosenFormat.format;
-						swapchainImageViewCreateInfo.subresourceRange.levelCount = 1;
-						swapchainImageViewCreateInfo.subresourceRange.layerCount = 1;
-						swapchainImageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-						swapchainImageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-						swapchainImageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-
-						vkCreateImageView(initStruct->device, &swapchainImageViewCreateInfo, NULL, &((*swapchainImageViews)[i]));
-					}
-				}
+	//Thread safe, jobs may submit jobs too. false if out of memory, job won't run then
+	bool submitJob(
+		JobSystem* jobSystem,
+		JobFunction function,
+		void* userData,
+		/*can be null*/ JobCounter* counter
+	) CPPONLY(noexcept);
 
-				return swapchain;
-			}
-			else
-			{
-				free(surfaceFormats);
-				free(presentModes);
-				return VK_NULL_HANDLE;
-			}
+	//Blocks until every job submitted with counter finished. Don't call from inside a job, worker would sleep instead of helping
+	void waitJobCounter(
+		JobSystem* jobSystem,
+		JobCounter* counter
+	) CPPONLY(noexcept);
 
-			free(surfaceFormats);
-			free(presentModes);
-		}
-		else
-			return VK_NULL_HANDLE;
-	}
+	//Runs jobs still queued, then joins workers
+	void destroyJobSystem(
+		JobSystem* jobSystem
+	) CPPONLY(noexcept);
 
-#ifdef VKCMDINIT_CPP
-}
-#endif
+	//Never blocks, true once every job submitted with counter finished. Safe to call from inside a job
+	bool pollJobCounter(
+		const JobCounter* counter
+	) CPPONLY(noexcept);
 
-#endif
+	//SPIR-V file beginAsyncInit turns into a shader module. Outputs are VK_NOT_READY until pollAsyncInit is true
+	typedef struct AsyncShaderRequest
+	{
+		const char* path;
+		VkShaderModule shaderModule; //app destroys it
+		VkResult result; //VK_ERROR_INITIALIZATION_FAILED if file is missing or isn't SPIR-V
+	} AsyncShaderRequest;
+
+	//Completion handle of beginAsyncInit
+	typedef struct AsyncInit AsyncInit;
+
+	//createDevice that overlaps with disk and worker threads. Pipeline cache file (withPipelineCache) and shaders are read on
+	//jobSystem while vkCreateDevice runs on calling thread, returns once device is ready with pipeline cache and shader modules
+	//still being created on workers. Create swapchain and present first frames meanwhile, just don't use pipelineCache or
+	//shaders (nor savePipelineCache/destroyDevice) before pollAsyncInit is true or finishAsyncInit returned.
+	//shaders have to stay alive until then. NULL if out of memory, nothing was started then
+	AsyncInit* beginAsyncInit(
+		InitializationStruct* initStruct,
+		JobSystem* jobSystem,
+		/*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount),
+		const char* const* deviceExtensions,
+		uint32_t deviceExtensionCount,
+		/*can be null*/ AsyncShaderRequest* shaders,
+		uint32_t shaderCount
+	) CPPONLY(noexcept);
 
-#if defined(VKCMDINIT_CPP)
+	//Never blocks, true once pipeline cache and every shader of beginAsyncInit are done. Poll once per frame
+	bool pollAsyncInit(
+		const AsyncInit* asyncInit
+	) CPPONLY(noexcept);
 
-namespace vki
-{
-	//Creates instance of InitialziationStruct with basic application information
-	inline InitializationStruct createApplication(
+	//Waits for what's left and frees asyncInit. VK_SUCCESS if device, pipeline cache and every shader were created
+	VkResult finishAsyncInit(
+		AsyncInit* asyncInit
+	) CPPONLY(noexcept);
+
+	//Records chunkIndex-th part of the work into secondary command buffer, called on a worker thread
+	typedef void(*RecordFunction)(VkCommandBuffer commandBuffer, uint32_t chunkIndex, void* userData);
+
+	typedef struct ParallelRecorderPool
+	{
+		VkCommandPool commandPool; //reset as a whole when its frame slot comes around again
+		VkCommandBuffer* commandBuffers;
+		uint32_t commandBufferCount;
+		uint32_t commandBufferCapacity;
+		uint32_t usedCount; //handed out this frame
+	} ParallelRecorderPool;
+
+	typedef struct ParallelRecordTask
+	{
+		struct ParallelRecorder* recorder;
+		InitializationStruct* initStruct;
+		RecordFunction function;
+		void* userData;
+		const VkCommandBufferInheritanceInfo* inheritanceInfo;
+		uint32_t chunkIndex;
+		VkResult result;
+	} ParallelRecordTask;
+
+	//Command pool per worker per frame in flight, so workers record secondaries without locking.
+	//Secondaries are executed in chunk order, output doesn't depend on which worker recorded what
+	typedef struct ParallelRecorder
+	{
+		JobSystem* jobSystem;
+		uint32_t workerCount;
+		uint32_t framesInFlight;
+		ParallelRecorderPool* pools; //[frameIndex * workerCount + workerIndex]
+
+		uint32_t frameIndex;
+		uint64_t resetFrameNumber; //frameNumber + 1 pools of frameIndex were last reset for, 0 if never
+
+		VkCommandBuffer* secondaries; //by chunk index
+		uint32_t secondaryCapacity;
+		ParallelRecordTask* tasks;
+		uint32_t taskCapacity;
+	} ParallelRecorder;
+
+	//Creates pools on graphics family of default createDevice path, one set per frame slot of frameContext. NULL on failure or
+	//if device wasn't created by default path
+	ParallelRecorder* createParallelRecorder(
+		InitializationStruct* initStruct,
+		JobSystem* jobSystem,
+		const FrameContext* frameContext
+	) CPPONLY(noexcept);
+
+	//Call between beginFrame and endFrame. Splits work into chunkCount jobs each recording a secondary, waits for them and executes
+	//secondaries in primaryCommandBuffer in chunk order. With inheritanceInfo->renderPass set, begin render pass with
+	//VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS first. First call in a frame resets that frame slot's pools
+	VkResult recordParallel(
+		InitializationStruct* initStruct,
+		ParallelRecorder* recorder,
+		const FrameContext* frameContext,
+		VkCommandBuffer primaryCommandBuffer,
+		/*can be null*/ const VkCommandBufferInheritanceInfo* inheritanceInfo,
+		uint32_t chunkCount,
+		RecordFunction function,
+		void* userData
+	) CPPONLY(noexcept);
+
+	//GPU must be done with every frame, ex. vkDeviceWaitIdle first
+	void destroyParallelRecorder(
+		InitializationStruct* initStruct,
+		ParallelRecorder* recorder
+	) CPPONLY(noexcept);
+
+	//Order PipelineCompiler picks queued pipelines in, requesting queued pipeline again with higher priority raises it
+	typedef enum PipelinePriority
+	{
+		PIPELINE_PRIORITY_BACKGROUND = 0, //prewarming, compiled when nothing else waits
+		PIPELINE_PRIORITY_NORMAL = 1,
+		PIPELINE_PRIORITY_FRAME = 2, //current frame draws with it
+		PIPELINE_PRIORITY_COUNT = 3
+	} PipelinePriority;
+
+	//Index of deduplicated pipeline in its PipelineCompiler, valid until destroyPipelineCompiler. UINT32_MAX if request ran out of memory
+	typedef uint32_t PipelineHandle;
+
+	typedef struct PipelineCompilerStats
+	{
+		uint64_t requestCount;
+		uint64_t deduplicatedCount; //requests answered with handle of earlier identical description
+		uint32_t compiledCount;
+		uint32_t failedCount;
+		uint32_t pendingCount; //queued or compiling right now
+		uint64_t compileNanoseconds; //summed over threads
+	} PipelineCompilerStats;
+
+	//Compiles pipelines on JobSystem into pipelineCache of createDevice/withPipelineCache. Descriptions are keyed by content
+	//(shader module, layout and render pass handles included), identical ones share one pipeline. Descriptions with extension
+	//structs other than VkPipelineRenderingCreateInfo are compiled but never shared. Thread safe, pipelines are owned by compiler
+	typedef struct PipelineCompiler PipelineCompiler;
+
+	//NULL on failure
+	PipelineCompiler* createPipelineCompiler(
+		InitializationStruct* initStruct,
+		JobSystem* jobSystem
+	) CPPONLY(noexcept);
+
+	//Queues pipeline, or returns handle of identical earlier request. Never blocks on compilation.
+	//createInfo and everything it points to has to stay alive until pipeline is done (pollPipeline isn't VK_NOT_READY)
+	PipelineHandle compileGraphicsPipeline(
+		PipelineCompiler* compiler,
+		const VkGraphicsPipelineCreateInfo* createInfo,
+		PipelinePriority priority
+	) CPPONLY(noexcept);
+
+	//Same as compileGraphicsPipeline
+	PipelineHandle compileComputePipeline(
+		PipelineCompiler* compiler,
+		const VkComputePipelineCreateInfo* createInfo,
+		PipelinePriority priority
+	) CPPONLY(noexcept);
+
+	//Never blocks. VK_NOT_READY while queued or compiling, otherwise result of creation with pipeline written
+	VkResult pollPipeline(
+		PipelineCompiler* compiler,
+		PipelineHandle handle,
+		VkPipeline* pipeline
+	) CPPONLY(noexcept);
+
+	//Compiles pipeline on calling thread if no worker started it yet, otherwise waits for the worker. Don't call from inside a job
+	VkResult waitPipeline(
+		PipelineCompiler* compiler,
+		PipelineHandle handle,
+		VkPipeline* pipeline
+	) CPPONLY(noexcept);
+
+	//Blocks until nothing is queued or compiling, ex. before savePipelineCache. Don't call from inside a job
+	void waitPipelineCompiler(
+		PipelineCompiler* compiler
+	) CPPONLY(noexcept);
+
+	void getPipelineCompilerStats(
+		PipelineCompiler* compiler,
+		PipelineCompilerStats* stats
+	) CPPONLY(noexcept);
+
+	//Waits for queued pipelines, then destroys every pipeline compiler created. GPU must be done with them
+	void destroyPipelineCompiler(
+		InitializationStruct* initStruct,
+		PipelineCompiler* compiler
+	) CPPONLY(noexcept);
+
+	//Input of writeShaderArchive
+	typedef struct ShaderArchiveSource
+	{
+		const char* name; //ex. path of .spv it was compiled to
+		const uint32_t* code;
+		size_t codeSize; //bytes
+	} ShaderArchiveSource;
+
+	typedef struct ShaderArchiveStats
+	{
+		uint32_t entryCount;
+		uint32_t codeCount; //distinct blobs, upper bound of modules
+		uint32_t moduleCount; //created so far
+		size_t mappedBytes;
+	} ShaderArchiveStats;
+
+	//One mapped file of SPIR-V blobs with an index sorted by name hash. Modules are created on first use and shared by
+	//names with identical code. Not thread safe
+	typedef struct ShaderArchive ShaderArchive;
+
+	//Packs SPIR-V blobs into one file for openShaderArchive, identical blobs are stored once. Meant for build step.
+	//VK_ERROR_INITIALIZATION_FAILED if a blob isn't SPIR-V, a name repeats or file can't be written
+	VkResult writeShaderArchive(
+		const char* path,
+		const ShaderArchiveSource* sources,
+		uint32_t sourceCount
+	) CPPONLY(noexcept);
+
+	//Maps archive and validates its index (bounds, 4 byte alignment of every blob), code itself isn't read yet.
+	//NULL if file is missing, corrupt or out of memory
+	ShaderArchive* openShaderArchive(
+		InitializationStruct* initStruct,
+		const char* path
+	) CPPONLY(noexcept);
+
+	//Creates module on first request of name (or of another name with identical code), later requests return the same one.
+	//Module is owned by archive. VK_NULL_HANDLE if name isn't in archive, blob isn't valid SPIR-V or creation failed
+	VkShaderModule getShaderModule(
+		InitializationStruct* initStruct,
+		ShaderArchive* shaderArchive,
+		const char* name
+	) CPPONLY(noexcept);
+
+	//Code of name straight from the mapping (ex. for reflection), valid until closeShaderArchive. NULL if name isn't in archive
+	const uint32_t* getShaderCode(
+		const ShaderArchive* shaderArchive,
+		const char* name,
+		/*can be null*/ size_t* codeSize
+	) CPPONLY(noexcept);
+
+	void getShaderArchiveStats(
+		const ShaderArchive* shaderArchive,
+		ShaderArchiveStats* stats
+	) CPPONLY(noexcept);
+
+	//Unmaps archive and destroys modules it created, pipelines created from them stay valid
+	void closeShaderArchive(
+		InitializationStruct* initStruct,
+		ShaderArchive* shaderArchive
+	) CPPONLY(noexcept);
+
+#ifndef VKCMDINIT_GPU_PROFILER_WINDOW
+#define VKCMDINIT_GPU_PROFILER_WINDOW 64
+#endif
+
+#define VKCMDINIT_GPU_PROFILER_MAX_DEPTH 32
+
+	//Scope is identified by name and parent, so same pass under different parents is tracked separately.
+	//Time of all instances of a scope within one frame is summed into one sample
+	typedef struct GpuScopeStats
+	{
+		const char* name;
+		uint32_t parentScope; //UINT32_MAX for top level scopes
+		uint32_t depth;
+
+		double lastMilliseconds;
+		//Over last VKCMDINIT_GPU_PROFILER_WINDOW resolved frames the scope ran in
+		double minMilliseconds;
+		double averageMilliseconds;
+		double maxMilliseconds;
+
+		double samples[VKCMDINIT_GPU_PROFILER_WINDOW];
+		uint32_t sampleCount;
+		uint32_t nextSample;
+		uint64_t sampleFrameNumber; //frameNumber + 1 of newest sample
+	} GpuScopeStats;
+
+	typedef struct GpuScopeRecord
+	{
+		uint32_t scope;
+		uint32_t beginQuery;
+		uint32_t endQuery; //UINT32_MAX while open
+	} GpuScopeRecord;
+
+	typedef struct GpuProfilerFrame
+	{
+		VkQueryPool queryPool;
+		GpuScopeRecord* records;
+		uint32_t recordCount;
+		uint32_t queryCount; //written this frame
+		uint64_t frameNumber;
+		bool pending; //ended, results not read yet
+	} GpuProfilerFrame;
+
+	//Resolved scope instance kept for exportGpuProfilerTrace, times are GPU clock converted to nanoseconds
+	typedef struct GpuTraceEvent
+	{
+		uint32_t scope;
+		uint64_t frameNumber;
+		uint64_t startNanoseconds;
+		uint64_t durationNanoseconds;
+	} GpuTraceEvent;
+
+	//Timestamp queries around named, nested scopes, one query pool per frame in flight. Results are read frames later when the
+	//GPU is known to be done, never with VK_QUERY_RESULT_WAIT_BIT. Record all scopes of a frame into one command buffer. Not thread safe
+	typedef struct GpuProfiler
+	{
+		GpuProfilerFrame* frames;
+		uint32_t frameCount;
+		uint32_t maxScopesPerFrame;
+		GpuProfilerFrame* currentFrame; //between beginGpuProfilerFrame and endGpuProfilerFrame
+		uint64_t* queryResults;
+
+		double timestampPeriod; //nanoseconds per tick, from physical device limits
+		uint64_t timestampMask; //from timestampValidBits of graphics family
+
+		uint32_t openRecords[VKCMDINIT_GPU_PROFILER_MAX_DEPTH];
+		uint32_t openRecordCount;
+
+		GpuScopeStats* scopes;
+		uint32_t scopeCount;
+		uint32_t scopeCapacity;
+
+		GpuTraceEvent* traceEvents; //ring, oldest are overwritten
+		uint32_t traceCapacity;
+		uint64_t traceEventCount; //written so far
+
+		uint64_t resolvedFrameCount;
+		uint32_t droppedFrameCount; //frame slot reused before its results were read, call resolveGpuProfiler every frame
+		uint32_t overflowCount; //scopes skipped because maxScopesPerFrame or nesting depth was exceeded
+	} GpuProfiler;
+
+	//Uses graphics family of default createDevice path. traceCapacity 0 disables trace export. NULL on failure, if family
+	//doesn't support timestamps or if device wasn't created by default path
+	GpuProfiler* createGpuProfiler(
+		InitializationStruct* initStruct,
+		/*same as FrameContext*/ uint32_t framesInFlight,
+		uint32_t maxScopesPerFrame,
+		uint32_t traceCapacity
+	) CPPONLY(noexcept);
+
+	//Resets frame slot's queries in commandBuffer, call first thing after beginFrame (with FrameContext::frameNumber)
+	void beginGpuProfilerFrame(
+		InitializationStruct* initStruct,
+		GpuProfiler* profiler,
+		VkCommandBuffer commandBuffer,
+		uint64_t frameNumber
+	) CPPONLY(noexcept);
+
+	//Scopes nest, every beginGpuScope needs an endGpuScope in the same frame
+	void beginGpuScope(
+		InitializationStruct* initStruct,
+		GpuProfiler* profiler,
+		VkCommandBuffer commandBuffer,
+		/*has to outlive the profiler*/ const char* name
+	) CPPONLY(noexcept);
+
+	void endGpuScope(
+		InitializationStruct* initStruct,
+		GpuProfiler* profiler,
+		VkCommandBuffer commandBuffer
+	) CPPONLY(noexcept);
+
+	//Call before endFrame, scopes still open are dropped
+	void endGpuProfilerFrame(
+		GpuProfiler* profiler
+	) CPPONLY(noexcept);
+
+	//Reads results of ended frames up to completedFrameNumber and updates scope stats. Never blocks, frames whose results aren't
+	//available yet are retried next call. With FrameContext call it after beginFrame with frameNumber - framesInFlight.
+	//Returns number of frames resolved
+	uint32_t resolveGpuProfiler(
+		InitializationStruct* initStruct,
+		GpuProfiler* profiler,
+		uint64_t completedFrameNumber
+	) CPPONLY(noexcept);
+
+	//Writes resolved scopes still in trace ring as Chrome trace event JSON
+	VkResult exportGpuProfilerTrace(
+		const GpuProfiler* profiler,
+		const char* path
+	) CPPONLY(noexcept);
+
+	//Query pools may still be written by GPU, wait for frames first (ex. destroyFrameContext)
+	void destroyGpuProfiler(
+		InitializationStruct* initStruct,
+		GpuProfiler* profiler
+	) CPPONLY(noexcept);
+
+#ifdef VKCMDINIT_CPP
+}
+#endif
+
+#ifdef VKCMDINIT_IMPL
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef _MSC_VER
+#define VKCMDINIT_ATOMIC_ADD(target, value) (_InterlockedExchangeAdd((volatile long*)(target), (value)) + (value))
+#define VKCMDINIT_ATOMIC_LOAD(target) _InterlockedOr((volatile long*)(target), 0)
+#define VKCMDINIT_ATOMIC_STORE(target, value) _InterlockedExchange((volatile long*)(target), (value))
+#define VKCMDINIT_ATOMIC_EXCHANGE(target, value) _InterlockedExchange((volatile long*)(target), (value))
+#define VKCMDINIT_ATOMIC_CAS(target, expected, desired) (_InterlockedCompareExchange((volatile long*)(target), (desired), (expected)) == (expected))
+#define VKCMDINIT_ATOMIC_ADD64(target, value) (_InterlockedExchangeAdd64((volatile long long*)(target), (value)) + (value))
+#define VKCMDINIT_ATOMIC_LOAD64(target) _InterlockedCompareExchange64((volatile long long*)(target), 0, 0)
+#define VKCMDINIT_ATOMIC_CAS64(target, expected, desired) (_InterlockedCompareExchange64((volatile long long*)(target), (desired), (expected)) == (expected))
+#else
+#define VKCMDINIT_ATOMIC_ADD(target, value) __atomic_add_fetch((target), (value), __ATOMIC_ACQ_REL)
+#define VKCMDINIT_ATOMIC_LOAD(target) __atomic_load_n((target), __ATOMIC_ACQUIRE)
+#define VKCMDINIT_ATOMIC_STORE(target, value) __atomic_store_n((target), (value), __ATOMIC_RELEASE)
+#define VKCMDINIT_ATOMIC_EXCHANGE(target, value) __atomic_exchange_n((target), (value), __ATOMIC_ACQ_REL)
+#define VKCMDINIT_ATOMIC_CAS(target, expected, desired) __sync_bool_compare_and_swap((target), (expected), (desired))
+#define VKCMDINIT_ATOMIC_ADD64(target, value) __atomic_add_fetch((target), (value), __ATOMIC_ACQ_REL)
+#define VKCMDINIT_ATOMIC_LOAD64(target) __atomic_load_n((target), __ATOMIC_ACQUIRE)
+#define VKCMDINIT_ATOMIC_CAS64(target, expected, desired) __sync_bool_compare_and_swap((target), (expected), (desired))
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef VKCMDINIT_DYNAMIC_LOADER
+#include <dlfcn.h>
+#endif
+#endif
+
+#ifdef VKCMDINIT_CPP
+extern "C" {
+#endif
+
+	//Read-only view of a whole file
+	typedef struct VkCmdInitMappedFile
+	{
+		const void* data;
+		size_t size;
+	} VkCmdInitMappedFile;
+
+	static bool vkCmdInitMapFile(const char* path, VkCmdInitMappedFile* mappedFile)
+	{
+		mappedFile->data = NULL;
+		mappedFile->size = 0;
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (!mapping)
+			return false;
+
+		//View keeps the mapping alive, handle isn't needed anymore
+		mappedFile->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		mappedFile->size = (size_t)fileSize.QuadPart;
+#else
+		int file = open(path, O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		void* data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		mappedFile->data = (data == MAP_FAILED) ? NULL : data;
+		mappedFile->size = (size_t)fileStat.st_size;
+#endif
+		return mappedFile->data != NULL;
+	}
+
+	static void vkCmdInitUnmapFile(VkCmdInitMappedFile* mappedFile)
+	{
+		if (!mappedFile->data)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(mappedFile->data);
+#else
+		munmap((void*)mappedFile->data, mappedFile->size);
+#endif
+		mappedFile->data = NULL;
+		mappedFile->size = 0;
+	}
+
+	//Defined next to withAllocationCallbacks below
+	static void* vkCmdInitHostAllocate(const InitializationStruct* initStruct, size_t size, VkSystemAllocationScope scope);
+	static void vkCmdInitHostFree(const InitializationStruct* initStruct, void* memory);
+
+	//Replaces file at path with data, readers never observe a half-written file
+	static bool vkCmdInitWriteFileAtomic(/*can be null (CRT)*/ const InitializationStruct* initStruct, const char* path, const void* data, size_t size)
+	{
+		size_t pathLength = strlen(path);
+		char* temporaryPath = (char*)vkCmdInitHostAllocate(initStruct, pathLength + sizeof(".tmp"), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+		if (!temporaryPath)
+			return false;
+		memcpy(temporaryPath, path, pathLength);
+		memcpy(temporaryPath + pathLength, ".tmp", sizeof(".tmp"));
+
+#ifdef _WIN32
+		FILE* file = fopen(temporaryPath, "wb");
+		bool written = file && fwrite(data, 1, size, file) == size;
+		written = file && (fclose(file) == 0) && written;
+		written = written && MoveFileExA(temporaryPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+		int file = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		bool written = file >= 0;
+		for (size_t offset = 0; written && offset < size;)
+		{
+			ssize_t chunk = write(file, (const uint8_t*)data + offset, size - offset);
+			written = chunk > 0;
+			offset += written ? (size_t)chunk : 0;
+		}
+		//Data has to hit the disk before rename, otherwise crash can leave empty file under final name
+		written = written && fsync(file) == 0;
+		written = file >= 0 && close(file) == 0 && written;
+		written = written && rename(temporaryPath, path) == 0;
+#endif
+		if (!written)
+			remove(temporaryPath);
+
+		vkCmdInitHostFree(initStruct, temporaryPath);
+		return written;
+	}
+
+	//FNV-1a
+	static uint64_t vkCmdInitHash(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+#define VKCMDINIT_HASH_SEED 14695981039346656037ull
+
+#ifndef VKCMDINIT_DEFAULT_VALIDATION_PROFILE
+#ifdef NDEBUG
+#define VKCMDINIT_DEFAULT_VALIDATION_PROFILE VALIDATION_PROFILE_NONE
+#else
+#define VKCMDINIT_DEFAULT_VALIDATION_PROFILE VALIDATION_PROFILE_STANDARD
+#endif
+#endif
+
+#define VKCMDINIT_VALIDATION_LAYER_NAME "VK_LAYER_KHRONOS_validation"
+
+#define VKCMDINIT_PIPELINE_CACHE_MAGIC 0x43504B56u /*'VKPC'*/
+#define VKCMDINIT_PIPELINE_CACHE_FILE_VERSION 1u
+
+	//Prepended to driver's cache blob. Key (vendor, device, driver, UUID) decides if blob can be reused
+	typedef struct VkCmdInitPipelineCacheFileHeader
+	{
+		uint32_t magic;
+		uint32_t fileVersion;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint32_t headerSize;
+		uint64_t dataSize;
+		uint64_t dataHash;
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+	} VkCmdInitPipelineCacheFileHeader;
+
+	static PipelineCacheLoadResult vkCmdInitValidatePipelineCacheFile(const VkPhysicalDeviceProperties* properties, const VkCmdInitMappedFile* mappedFile)
+	{
+		if (mappedFile->size < sizeof(VkCmdInitPipelineCacheFileHeader))
+			return PIPELINE_CACHE_LOAD_RESULT_CORRUPT;
+
+		VkCmdInitPipelineCacheFileHeader header;
+		memcpy(&header, mappedFile->data, sizeof(header));
+
+		if (header.magic != VKCMDINIT_PIPELINE_CACHE_MAGIC || header.headerSize != sizeof(header))
+			return PIPELINE_CACHE_LOAD_RESULT_CORRUPT;
+
+		if (header.fileVersion != VKCMDINIT_PIPELINE_CACHE_FILE_VERSION || header.vendorID != properties->vendorID || header.deviceID != properties->deviceID ||
+			header.driverVersion != properties->driverVersion || memcmp(header.pipelineCacheUUID, properties->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+			return PIPELINE_CACHE_LOAD_RESULT_STALE;
+
+		if (header.dataSize != mappedFile->size - sizeof(header) || header.dataSize < sizeof(VkPipelineCacheHeaderVersionOne))
+			return PIPELINE_CACHE_LOAD_RESULT_CORRUPT;
+
+		const uint8_t* data = (const uint8_t*)mappedFile->data + sizeof(header);
+		if (vkCmdInitHash(data, (size_t)header.dataSize, VKCMDINIT_HASH_SEED) != header.dataHash)
+			return PIPELINE_CACHE_LOAD_RESULT_CORRUPT;
+
+		//Driver validates its own header too, but some drivers crash on foreign blobs instead of rejecting them
+		VkPipelineCacheHeaderVersionOne driverHeader;
+		memcpy(&driverHeader, data, sizeof(driverHeader));
+		if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || driverHeader.vendorID != properties->vendorID ||
+			driverHeader.deviceID != properties->deviceID || memcmp(driverHeader.pipelineCacheUUID, properties->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+			return PIPELINE_CACHE_LOAD_RESULT_STALE;
+
+		return PIPELINE_CACHE_LOAD_RESULT_LOADED;
+	}
+
+	//Mapping is kept only if blob can be loaded. Needs no device, so beginAsyncInit runs it during vkCreateDevice
+	static PipelineCacheLoadResult vkCmdInitMapPipelineCache(const char* path, const VkPhysicalDeviceProperties* properties, VkCmdInitMappedFile* mappedFile)
+	{
+		if (!vkCmdInitMapFile(path, mappedFile))
+			return PIPELINE_CACHE_LOAD_RESULT_NOT_FOUND;
+
+		PipelineCacheLoadResult loadResult = vkCmdInitValidatePipelineCacheFile(properties, mappedFile);
+		if (loadResult != PIPELINE_CACHE_LOAD_RESULT_LOADED)
+			vkCmdInitUnmapFile(mappedFile);
+		return loadResult;
+	}
+
+	static void vkCmdInitCreatePipelineCacheFrom(InitializationStruct* initStruct, const VkCmdInitMappedFile* mappedFile, PipelineCacheLoadResult loadResult)
+	{
+		VkPipelineCacheCreateInfo pipelineCacheCreateInfo = { ZERO };
+		pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		if (loadResult == PIPELINE_CACHE_LOAD_RESULT_LOADED)
+		{
+			//Driver copies initial data, so blob is read straight from the mapping
+			pipelineCacheCreateInfo.initialDataSize = mappedFile->size - sizeof(VkCmdInitPipelineCacheFileHeader);
+			pipelineCacheCreateInfo.pInitialData = (const uint8_t*)mappedFile->data + sizeof(VkCmdInitPipelineCacheFileHeader);
+		}
+
+		if (initStruct->deviceTable.vkCreatePipelineCache(initStruct->device, &pipelineCacheCreateInfo, initStruct->allocationCallbacks, &initStruct->pipelineCache) != VK_SUCCESS && pipelineCacheCreateInfo.initialDataSize)
+		{
+			loadResult = PIPELINE_CACHE_LOAD_RESULT_CORRUPT;
+			pipelineCacheCreateInfo.initialDataSize = 0;
+			pipelineCacheCreateInfo.pInitialData = NULL;
+			initStruct->deviceTable.vkCreatePipelineCache(initStruct->device, &pipelineCacheCreateInfo, initStruct->allocationCallbacks, &initStruct->pipelineCache);
+		}
+
+		initStruct->pipelineCacheStats.loadResult = loadResult;
+		initStruct->pipelineCacheStats.loadedBytes = pipelineCacheCreateInfo.initialDataSize;
+	}
+
+	static void vkCmdInitCreatePipelineCache(InitializationStruct* initStruct)
+	{
+		VkPhysicalDeviceProperties properties;
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+
+		VkCmdInitMappedFile mappedFile;
+		PipelineCacheLoadResult loadResult = vkCmdInitMapPipelineCache(initStruct->pipelineCachePath, &properties, &mappedFile);
+		vkCmdInitCreatePipelineCacheFrom(initStruct, &mappedFile, loadResult);
+		vkCmdInitUnmapFile(&mappedFile);
+	}
+
+
+	//Returns UINT32_MAX if no memory type in typeBits has all required properties
+	static uint32_t vkCmdInitFindMemoryType(InitializationStruct* initStruct, uint32_t typeBits, VkMemoryPropertyFlags requiredProperties)
+	{
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		initStruct->instanceTable.vkGetPhysicalDeviceMemoryProperties(initStruct->physicalDevice, &memoryProperties);
+
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+		{
+			if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & requiredProperties) == requiredProperties)
+				return i;
+		}
+		return UINT32_MAX;
+	}
+
+	static uint64_t vkCmdInitNanoseconds(void)
+	{
+#ifdef _WIN32
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER counter;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+		return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ull + (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ull / (uint64_t)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+#else
+		//Strict ISO mode hides POSIX clocks
+		struct timespec time;
+		timespec_get(&time, TIME_UTC);
+		return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+#endif
+	}
+
+#define VKCMDINIT_HOST_ALIGNMENT 16
+#define VKCMDINIT_DEFAULT_SCRATCH_BLOCK_SIZE (64 * 1024)
+
+	//Sits right before every allocation tracker hands out, so free knows size and scope
+	typedef struct VkCmdInitAllocationHeader
+	{
+		void* base;
+		size_t size;
+		VkSystemAllocationScope scope;
+	} VkCmdInitAllocationHeader;
+
+	struct AllocationTracker
+	{
+		VkAllocationCallbacks callbacks; //handed to Vulkan, pUserData points back to tracker
+		VkAllocationCallbacks parent; //app's callbacks, pfnAllocation is NULL if CRT is used
+		volatile long long allocationCount[VKCMDINIT_ALLOCATION_SCOPE_COUNT];
+		volatile long long freeCount[VKCMDINIT_ALLOCATION_SCOPE_COUNT];
+		volatile long long allocatedBytes[VKCMDINIT_ALLOCATION_SCOPE_COUNT];
+		volatile long long liveBytes[VKCMDINIT_ALLOCATION_SCOPE_COUNT];
+		volatile long long peakLiveBytes[VKCMDINIT_ALLOCATION_SCOPE_COUNT];
+		volatile long long internalAllocationCount;
+		volatile long long internalLiveBytes;
+	};
+
+	static void* VKAPI_CALL vkCmdInitTrackedAllocation(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		AllocationTracker* tracker = (AllocationTracker*)userData;
+		if (size == 0)
+			return NULL;
+		if (alignment < sizeof(void*))
+			alignment = sizeof(void*);
+
+		//Over-allocate so any alignment works with parent's (or CRT's) natural alignment
+		size_t totalSize = size + alignment + sizeof(VkCmdInitAllocationHeader);
+		void* base = tracker->parent.pfnAllocation ? tracker->parent.pfnAllocation(tracker->parent.pUserData, totalSize, sizeof(void*), scope) : malloc(totalSize);
+		if (!base)
+			return NULL;
+
+		uintptr_t memory = ((uintptr_t)base + sizeof(VkCmdInitAllocationHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		VkCmdInitAllocationHeader* header = (VkCmdInitAllocationHeader*)memory - 1;
+		header->base = base;
+		header->size = size;
+		header->scope = scope;
+
+		VKCMDINIT_ATOMIC_ADD64(&tracker->allocationCount[scope], 1);
+		VKCMDINIT_ATOMIC_ADD64(&tracker->allocatedBytes[scope], (long long)size);
+		long long liveBytes = VKCMDINIT_ATOMIC_ADD64(&tracker->liveBytes[scope], (long long)size);
+		long long peakLiveBytes = VKCMDINIT_ATOMIC_LOAD64(&tracker->peakLiveBytes[scope]);
+		while (liveBytes > peakLiveBytes && !VKCMDINIT_ATOMIC_CAS64(&tracker->peakLiveBytes[scope], peakLiveBytes, liveBytes))
+			peakLiveBytes = VKCMDINIT_ATOMIC_LOAD64(&tracker->peakLiveBytes[scope]);
+		return (void*)memory;
+	}
+
+	static void VKAPI_CALL vkCmdInitTrackedFree(void* userData, void* memory)
+	{
+		AllocationTracker* tracker = (AllocationTracker*)userData;
+		if (!memory)
+			return;
+
+		VkCmdInitAllocationHeader* header = (VkCmdInitAllocationHeader*)memory - 1;
+		VKCMDINIT_ATOMIC_ADD64(&tracker->freeCount[header->scope], 1);
+		VKCMDINIT_ATOMIC_ADD64(&tracker->liveBytes[header->scope], -(long long)header->size);
+		if (tracker->parent.pfnFree)
+			tracker->parent.pfnFree(tracker->parent.pUserData, header->base);
+		else
+			free(header->base);
+	}
+
+	static void* VKAPI_CALL vkCmdInitTrackedReallocation(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		if (!original)
+			return vkCmdInitTrackedAllocation(userData, size, alignment, scope);
+		if (size == 0)
+		{
+			vkCmdInitTrackedFree(userData, original);
+			return NULL;
+		}
+
+		//Parent's reallocation could move block to different offset from alignment, copy instead
+		void* memory = vkCmdInitTrackedAllocation(userData, size, alignment, scope);
+		if (memory)
+		{
+			size_t originalSize = ((VkCmdInitAllocationHeader*)original - 1)->size;
+			memcpy(memory, original, originalSize < size ? originalSize : size);
+			vkCmdInitTrackedFree(userData, original);
+		}
+		return memory;
+	}
+
+	static void VKAPI_CALL vkCmdInitTrackedInternalAllocation(void* userData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope scope)
+	{
+		AllocationTracker* tracker = (AllocationTracker*)userData;
+		VKCMDINIT_ATOMIC_ADD64(&tracker->internalAllocationCount, 1);
+		VKCMDINIT_ATOMIC_ADD64(&tracker->internalLiveBytes, (long long)size);
+		if (tracker->parent.pfnInternalAllocation)
+			tracker->parent.pfnInternalAllocation(tracker->parent.pUserData, size, allocationType, scope);
+	}
+
+	static void VKAPI_CALL vkCmdInitTrackedInternalFree(void* userData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope scope)
+	{
+		AllocationTracker* tracker = (AllocationTracker*)userData;
+		VKCMDINIT_ATOMIC_ADD64(&tracker->internalLiveBytes, -(long long)size);
+		if (tracker->parent.pfnInternalFree)
+			tracker->parent.pfnInternalFree(tracker->parent.pUserData, size, allocationType, scope);
+	}
+
+	//Library's own host memory goes through the same callbacks as Vulkan objects. initStruct is NULL (CRT) for utilities
+	//that don't take one. Zero size still returns a block like malloc, callbacks may return NULL for it
+	static void* vkCmdInitHostAllocate(const InitializationStruct* initStruct, size_t size, VkSystemAllocationScope scope)
+	{
+		const VkAllocationCallbacks* callbacks = initStruct ? initStruct->allocationCallbacks : NULL;
+		if (size == 0)
+			size = 1;
+		return callbacks ? callbacks->pfnAllocation(callbacks->pUserData, size, VKCMDINIT_HOST_ALIGNMENT, scope) : malloc(size);
+	}
+
+	//calloc counterpart
+	static void* vkCmdInitHostAllocateZeroed(const InitializationStruct* initStruct, size_t count, size_t size, VkSystemAllocationScope scope)
+	{
+		if (size && count > SIZE_MAX / size)
+			return NULL;
+		void* memory = vkCmdInitHostAllocate(initStruct, count * size, scope);
+		if (memory)
+			memset(memory, 0, count * size);
+		return memory;
+	}
+
+	static void* vkCmdInitHostReallocate(const InitializationStruct* initStruct, void* memory, size_t size, VkSystemAllocationScope scope)
+	{
+		const VkAllocationCallbacks* callbacks = initStruct ? initStruct->allocationCallbacks : NULL;
+		return callbacks ? callbacks->pfnReallocation(callbacks->pUserData, memory, size, VKCMDINIT_HOST_ALIGNMENT, scope) : realloc(memory, size);
+	}
+
+	static void vkCmdInitHostFree(const InitializationStruct* initStruct, void* memory)
+	{
+		const VkAllocationCallbacks* callbacks = initStruct ? initStruct->allocationCallbacks : NULL;
+		if (callbacks)
+			callbacks->pfnFree(callbacks->pUserData, memory);
+		else
+			free(memory);
+	}
+
+	InitializationStruct* withAllocationCallbacks(InitializationStruct* initStruct, /*can be null (CRT)*/ const VkAllocationCallbacks* allocationCallbacks, bool trackStatistics)
+	{
+		//Memory has to be freed through callbacks it came from, only extension list is small enough to move over
+		if (initStruct->instance || initStruct->scratchArena.block || initStruct->initTrace || initStruct->allocationTracker)
+			return initStruct;
+
+		AllocationTracker* tracker = NULL;
+		if (trackStatistics)
+		{
+			tracker = (AllocationTracker*)(allocationCallbacks ?
+				allocationCallbacks->pfnAllocation(allocationCallbacks->pUserData, sizeof(AllocationTracker), VKCMDINIT_HOST_ALIGNMENT, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE) :
+				malloc(sizeof(AllocationTracker)));
+			if (!tracker)
+				return initStruct;
+
+			memset(tracker, 0, sizeof(AllocationTracker));
+			if (allocationCallbacks)
+				tracker->parent = *allocationCallbacks;
+			tracker->callbacks.pUserData = tracker;
+			tracker->callbacks.pfnAllocation = vkCmdInitTrackedAllocation;
+			tracker->callbacks.pfnReallocation = vkCmdInitTrackedReallocation;
+			tracker->callbacks.pfnFree = vkCmdInitTrackedFree;
+			tracker->callbacks.pfnInternalAllocation = vkCmdInitTrackedInternalAllocation;
+			tracker->callbacks.pfnInternalFree = vkCmdInitTrackedInternalFree;
+		}
+
+		const VkAllocationCallbacks* previousCallbacks = initStruct->allocationCallbacks;
+		const VkAllocationCallbacks* callbacks = tracker ? &tracker->callbacks : allocationCallbacks;
+		if (initStruct->extensionPtr)
+		{
+			initStruct->allocationCallbacks = callbacks;
+			const char** extensionPtr = (const char**)vkCmdInitHostAllocate(initStruct, sizeof(const char*) * initStruct->extensionCapacity, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+			initStruct->allocationCallbacks = previousCallbacks;
+			if (!extensionPtr)
+			{
+				if (tracker && allocationCallbacks)
+					allocationCallbacks->pfnFree(allocationCallbacks->pUserData, tracker);
+				else
+					free(tracker);
+				return initStruct;
+			}
+
+			memcpy((void*)extensionPtr, initStruct->extensionPtr, sizeof(const char*) * initStruct->extensionCount);
+			vkCmdInitHostFree(initStruct, (void*)initStruct->extensionPtr);
+			initStruct->extensionPtr = extensionPtr;
+		}
+
+		initStruct->allocationTracker = tracker;
+		initStruct->allocationCallbacks = callbacks;
+		return initStruct;
+	}
+
+	bool getAllocationStats(const InitializationStruct* initStruct, AllocationStats* stats)
+	{
+		memset(stats, 0, sizeof(*stats));
+		AllocationTracker* tracker = initStruct->allocationTracker;
+		if (!tracker)
+			return false;
+
+		for (uint32_t i = 0; i < VKCMDINIT_ALLOCATION_SCOPE_COUNT; ++i)
+		{
+			stats->scopes[i].allocationCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->allocationCount[i]);
+			stats->scopes[i].freeCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->freeCount[i]);
+			stats->scopes[i].allocatedBytes = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->allocatedBytes[i]);
+			stats->scopes[i].liveBytes = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->liveBytes[i]);
+			stats->scopes[i].peakLiveBytes = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->peakLiveBytes[i]);
+		}
+		stats->internalAllocationCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->internalAllocationCount);
+		stats->internalLiveBytes = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&tracker->internalLiveBytes);
+		return true;
+	}
+
+	//Has to run after everything allocated through tracker is freed
+	static void vkCmdInitDestroyAllocationTracker(InitializationStruct* initStruct)
+	{
+		AllocationTracker* tracker = initStruct->allocationTracker;
+		if (!tracker)
+			return;
+
+		VkAllocationCallbacks parent = tracker->parent;
+		if (parent.pfnFree)
+			parent.pfnFree(parent.pUserData, tracker);
+		else
+			free(tracker);
+		initStruct->allocationTracker = NULL;
+		initStruct->allocationCallbacks = NULL;
+	}
+
+	//Header of scratch block, data follows it
+	typedef struct VkCmdInitScratchBlock
+	{
+		struct VkCmdInitScratchBlock* previous;
+		size_t capacity;
+		size_t offset;
+	} VkCmdInitScratchBlock;
+
+#define VKCMDINIT_SCRATCH_HEADER_SIZE ((sizeof(VkCmdInitScratchBlock) + VKCMDINIT_HOST_ALIGNMENT - 1) & ~(size_t)(VKCMDINIT_HOST_ALIGNMENT - 1))
+
+	InitializationStruct* withScratchArena(InitializationStruct* initStruct, size_t blockSize)
+	{
+		initStruct->scratchArena.blockSize = blockSize;
+		return initStruct;
+	}
+
+	void* scratchAllocate(InitializationStruct* initStruct, size_t size)
+	{
+		ScratchArena* arena = &initStruct->scratchArena;
+		VkCmdInitScratchBlock* block = (VkCmdInitScratchBlock*)arena->block;
+		size = (size + VKCMDINIT_HOST_ALIGNMENT - 1) & ~(size_t)(VKCMDINIT_HOST_ALIGNMENT - 1);
+		if (!block || block->capacity - block->offset < size)
+		{
+			size_t capacity = arena->blockSize ? arena->blockSize : VKCMDINIT_DEFAULT_SCRATCH_BLOCK_SIZE;
+			if (capacity < size)
+				capacity = size;
+
+			VkCmdInitScratchBlock* newBlock = (VkCmdInitScratchBlock*)vkCmdInitHostAllocate(initStruct, VKCMDINIT_SCRATCH_HEADER_SIZE + capacity, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+			if (!newBlock)
+				return NULL;
+			newBlock->previous = block;
+			newBlock->capacity = capacity;
+			newBlock->offset = 0;
+			arena->overflowBlockCount += block ? 1 : 0;
+			arena->block = newBlock;
+			block = newBlock;
+		}
+
+		void* memory = (uint8_t*)block + VKCMDINIT_SCRATCH_HEADER_SIZE + block->offset;
+		block->offset += size;
+		arena->usedBytes += size;
+		if (arena->usedBytes > arena->peakUsedBytes)
+			arena->peakUsedBytes = arena->usedBytes;
+		return memory;
+	}
+
+	ScratchMark scratchMark(InitializationStruct* initStruct)
+	{
+		//First block is created before the mark, so rewinding keeps it around for the next init step
+		if (!initStruct->scratchArena.block)
+			scratchAllocate(initStruct, 0);
+
+		VkCmdInitScratchBlock* block = (VkCmdInitScratchBlock*)initStruct->scratchArena.block;
+		ScratchMark mark;
+		mark.block = block;
+		mark.offset = block ? block->offset : 0;
+		mark.usedBytes = initStruct->scratchArena.usedBytes;
+		return mark;
+	}
+
+	void scratchRewind(InitializationStruct* initStruct, ScratchMark mark)
+	{
+		ScratchArena* arena = &initStruct->scratchArena;
+		VkCmdInitScratchBlock* block = (VkCmdInitScratchBlock*)arena->block;
+		while (block && block != mark.block)
+		{
+			VkCmdInitScratchBlock* previous = block->previous;
+			vkCmdInitHostFree(initStruct, block);
+			block = previous;
+		}
+		if (block)
+			block->offset = mark.offset;
+		arena->block = block;
+		arena->usedBytes = mark.usedBytes;
+	}
+
+	//Both are a single pointer check when tracing is off
+	static uint32_t vkCmdInitTraceBegin(InitializationStruct* initStruct, const char* name)
+	{
+		InitTrace* trace = initStruct->initTrace;
+		if (!trace)
+			return UINT32_MAX;
+
+		if (trace->eventCount == trace->eventCapacity)
+		{
+			uint32_t newCapacity = trace->eventCapacity ? trace->eventCapacity * 2 : 64;
+			InitTraceEvent* newEvents = (InitTraceEvent*)vkCmdInitHostReallocate(initStruct, trace->events, sizeof(InitTraceEvent) * newCapacity, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+			if (!newEvents)
+				return UINT32_MAX;
+			trace->events = newEvents;
+			trace->eventCapacity = newCapacity;
+		}
+
+		InitTraceEvent* event = &trace->events[trace->eventCount];
+		event->name = name;
+		event->depth = trace->depth++;
+		event->durationNanoseconds = 0;
+		event->startNanoseconds = vkCmdInitNanoseconds() - trace->originNanoseconds;
+		return trace->eventCount++;
+	}
+
+	static void vkCmdInitTraceEnd(InitializationStruct* initStruct, uint32_t traceEvent)
+	{
+		InitTrace* trace = initStruct->initTrace;
+		if (!trace || traceEvent >= trace->eventCount)
+			return;
+
+		InitTraceEvent* event = &trace->events[traceEvent];
+		event->durationNanoseconds = vkCmdInitNanoseconds() - trace->originNanoseconds - event->startNanoseconds;
+		trace->depth -= 1;
+	}
+
+	static void vkCmdInitCreateImageViews(InitializationStruct* initStruct, const VkImage* images, uint32_t imageCount, VkFormat format, VkImageView* imageViews)
+	{
+		uint32_t loopTrace = vkCmdInitTraceBegin(initStruct, "createImageViews");
+		for (uint32_t i = 0; i < imageCount; ++i)
+		{
+			VkImageViewCreateInfo imageViewCreateInfo = { ZERO };
+			imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			imageViewCreateInfo.image = images[i];
+			imageViewCreateInfo.components = CPPEXCLUDE((VkComponentMapping)) { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+			imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			imageViewCreateInfo.format = format;
+			imageViewCreateInfo.subresourceRange.levelCount = 1;
+			imageViewCreateInfo.subresourceRange.layerCount = 1;
+			imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+			imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+			imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+
+			uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkCreateImageView");
+			initStruct->deviceTable.vkCreateImageView(initStruct->device, &imageViewCreateInfo, initStruct->allocationCallbacks, &imageViews[i]);
+			vkCmdInitTraceEnd(initStruct, trace);
+		}
+		vkCmdInitTraceEnd(initStruct, loopTrace);
+	}
+
+#define VKCMDINIT_LOAD_GLOBAL_FUNCTION(name) initStruct->instanceTable.name = (PFN_##name)initStruct->instanceTable.vkGetInstanceProcAddr(NULL, #name);
+#define VKCMDINIT_LOAD_INSTANCE_FUNCTION(name) initStruct->instanceTable.name = (PFN_##name)initStruct->instanceTable.vkGetInstanceProcAddr(initStruct->instance, #name);
+#define VKCMDINIT_LOAD_DEVICE_FUNCTION(name) initStruct->deviceTable.name = (PFN_##name)initStruct->instanceTable.vkGetDeviceProcAddr(initStruct->device, #name);
+//Promoted functions aren't exposed under core name if device's API version is older, try extension name then
+#define VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(name, alias) if (!initStruct->deviceTable.name) initStruct->deviceTable.name = (PFN_##name)initStruct->instanceTable.vkGetDeviceProcAddr(initStruct->device, #alias);
+
+	//Finds vkGetInstanceProcAddr and global functions, only the first call does any work
+	static bool vkCmdInitLoadLoader(InitializationStruct* initStruct)
+	{
+		if (initStruct->instanceTable.vkGetInstanceProcAddr)
+			return true;
+
+#ifdef VKCMDINIT_DYNAMIC_LOADER
+#if defined(_WIN32)
+		HMODULE library = LoadLibraryA("vulkan-1.dll");
+		if (!library)
+			return false;
+		initStruct->instanceTable.vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)(void(*)(void))GetProcAddress(library, "vkGetInstanceProcAddr");
+#else
+#if defined(__APPLE__)
+		const char* libraryNames[] = { "libvulkan.dylib", "libvulkan.1.dylib", "libMoltenVK.dylib" };
+#else
+		const char* libraryNames[] = { "libvulkan.so.1", "libvulkan.so" };
+#endif
+		void* library = NULL;
+		for (size_t i = 0; i < sizeof(libraryNames) / sizeof(libraryNames[0]) && !library; ++i)
+			library = dlopen(libraryNames[i], RTLD_NOW | RTLD_LOCAL);
+		if (!library)
+			return false;
+		initStruct->instanceTable.vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)dlsym(library, "vkGetInstanceProcAddr");
+#endif
+		initStruct->loaderLibrary = (void*)library;
+#else
+		initStruct->instanceTable.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+#endif
+
+		if (!initStruct->instanceTable.vkGetInstanceProcAddr)
+			return false;
+
+		VKCMDINIT_GLOBAL_FUNCTIONS(VKCMDINIT_LOAD_GLOBAL_FUNCTION)
+		return true;
+	}
+
+	static void vkCmdInitUnloadLoader(InitializationStruct* initStruct)
+	{
+#ifdef VKCMDINIT_DYNAMIC_LOADER
+		if (initStruct->loaderLibrary)
+		{
+#ifdef _WIN32
+			FreeLibrary((HMODULE)initStruct->loaderLibrary);
+#else
+			dlclose(initStruct->loaderLibrary);
+#endif
+		}
+#endif
+		initStruct->loaderLibrary = NULL;
+		initStruct->instanceTable.vkGetInstanceProcAddr = NULL;
+	}
+
+	InitializationStruct createApplication(
+		const char* engineName,
+		const char* applicationName,
+		uint32_t applicationVersion,
+		uint32_t engineVersion,
+		uint32_t apiVersion
+	)
+	{
+		InitializationStruct initStruct = { ZERO };
+
+		VkApplicationInfo appInfo = { ZERO };
+
+		appInfo.engineVersion = engineVersion;
+		appInfo.apiVersion = apiVersion;
+		appInfo.applicationVersion = applicationVersion;
+		appInfo.pEngineName = engineName;
+		appInfo.pApplicationName = applicationName;
+
+		appInfo.pNext = NULL;
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+
+		VkInstanceCreateInfo instanceCreateInfo = { ZERO };
+
+		instanceCreateInfo.pNext = NULL;
+		instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+
+		initStruct.appInfo = appInfo;
+		initStruct.instanceInfo = instanceCreateInfo;
+
+		initStruct.extensionCount = 0;
+		initStruct.extensionCapacity = 0;
+		initStruct.extensionPtr = NULL;
+		initStruct.validationProfile = VKCMDINIT_DEFAULT_VALIDATION_PROFILE;
+		return initStruct;
+	}
+
+	InitializationStruct* addExtension(InitializationStruct* initStruct, const char* extensionName)
+	{
+		if (initStruct->extensionCount == initStruct->extensionCapacity)
+		{
+			uint32_t newCapacity = initStruct->extensionCapacity ? initStruct->extensionCapacity * 2 : 16;
+			const char** ptr = (const char**)vkCmdInitHostReallocate(initStruct, (void*)initStruct->extensionPtr, sizeof(const char*) * newCapacity, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+			if (!ptr)
+				return initStruct;
+			initStruct->extensionPtr = ptr;
+			initStruct->extensionCapacity = newCapacity;
+		}
+
+		initStruct->extensionPtr[initStruct->extensionCount] = extensionName;
+		initStruct->extensionCount += 1;
+
+		return initStruct;
+	}
+
+
+
+	InitializationStruct* withValidation(InitializationStruct* initStruct, ValidationProfile profile, /*ValidationFeatureBits, only used by VALIDATION_PROFILE_EXTENDED*/ uint32_t validationFeatures)
+	{
+		initStruct->validationProfile = profile;
+		initStruct->validationFeatures = validationFeatures;
+		return initStruct;
+	}
+
+	//layerName/extensionName is first member of both VkLayerProperties and VkExtensionProperties, so one lookup serves both
+	static bool vkCmdInitHasProperty(const void* properties, uint32_t propertyCount, size_t stride, const char* name)
+	{
+		for (uint32_t i = 0; i < propertyCount; ++i)
+		{
+			if (strcmp((const char*)properties + stride * i, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	static bool vkCmdInitHasName(const char* const* names, uint32_t nameCount, const char* name)
+	{
+		for (uint32_t i = 0; i < nameCount; ++i)
+		{
+			if (strcmp(names[i], name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	//Appends names found in properties to enabled, skipping ones already there. Returns first missing name if required, NULL otherwise
+	static const char* vkCmdInitNegotiateNames(const void* properties, uint32_t propertyCount, size_t stride, const char* const* names, uint32_t nameCount, bool required, const char** enabled, uint32_t* enabledCount)
+	{
+		const char* missing = NULL;
+		for (uint32_t i = 0; i < nameCount; ++i)
+		{
+			if (!vkCmdInitHasProperty(properties, propertyCount, stride, names[i]))
+			{
+				if (required && !missing)
+					missing = names[i];
+			}
+			else if (!vkCmdInitHasName(enabled, *enabledCount, names[i]))
+			{
+				enabled[(*enabledCount)++] = names[i];
+			}
+		}
+		return missing;
+	}
+
+	//Grant keeps its own arrays, names in them aren't copied
+	static const char** vkCmdInitCopyNames(InitializationStruct* initStruct, const char* const* names, uint32_t nameCount, uint32_t* copyCount)
+	{
+		const char** copy = nameCount ? (const char**)vkCmdInitHostAllocate(initStruct, sizeof(const char*) * nameCount, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) : NULL;
+		if (copy)
+			memcpy((void*)copy, names, sizeof(const char*) * nameCount);
+		*copyCount = copy ? nameCount : 0;
+		return copy;
+	}
+
+	//List lives in scratch, caller rewinds
+	static VkLayerProperties* vkCmdInitEnumerateInstanceLayers(InitializationStruct* initStruct, uint32_t* layerCount)
+	{
+		*layerCount = 0;
+		if (initStruct->instanceTable.vkEnumerateInstanceLayerProperties(layerCount, NULL) != VK_SUCCESS)
+			return NULL;
+		VkLayerProperties* layers = (VkLayerProperties*)scratchAllocate(initStruct, sizeof(VkLayerProperties) * *layerCount);
+		if (!layers || initStruct->instanceTable.vkEnumerateInstanceLayerProperties(layerCount, layers) < VK_SUCCESS)
+			*layerCount = 0;
+		return layers;
+	}
+
+	//Extensions of loader, implicit layers and every enabled layer in one list. Lives in scratch, caller rewinds
+	static VkExtensionProperties* vkCmdInitEnumerateInstanceExtensions(InitializationStruct* initStruct, const char* const* layers, uint32_t layerCount, uint32_t* extensionCount)
+	{
+		uint32_t totalCount = 0;
+		for (uint32_t i = 0; i <= layerCount; ++i)
+		{
+			uint32_t count = 0;
+			if (initStruct->instanceTable.vkEnumerateInstanceExtensionProperties(i ? layers[i - 1] : NULL, &count, NULL) == VK_SUCCESS)
+				totalCount += count;
+		}
+
+		*extensionCount = 0;
+		VkExtensionProperties* extensions = (VkExtensionProperties*)scratchAllocate(initStruct, sizeof(VkExtensionProperties) * totalCount);
+		for (uint32_t i = 0; i <= layerCount && extensions; ++i)
+		{
+			//VK_INCOMPLETE if list grew in between, part that fit is still valid
+			uint32_t count = totalCount - *extensionCount;
+			if (initStruct->instanceTable.vkEnumerateInstanceExtensionProperties(i ? layers[i - 1] : NULL, &count, extensions + *extensionCount) >= VK_SUCCESS)
+				*extensionCount += count;
+		}
+		return extensions;
+	}
+
+	InitializationStruct* startInstance(InitializationStruct* initStruct)
+	{
+		initStruct->instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		initStruct->instanceInfo.enabledLayerCount = 0;
+		initStruct->instanceInfo.ppEnabledLayerNames = NULL;
+		initStruct->instanceInfo.pApplicationInfo = &initStruct->appInfo;
+		initStruct->instanceInfo.pNext = NULL;
+		initStruct->validationEnabled = false;
+		initStruct->validationFeaturesEnabled = false;
+
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "startInstance");
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "loadLoader");
+		bool loaded = vkCmdInitLoadLoader(initStruct);
+		vkCmdInitTraceEnd(initStruct, trace);
+		if (loaded)
+		{
+			//Referenced by instanceInfo, have to outlive vkCreateInstance
+			VkValidationFeatureEnableEXT validationFeatureEnables[3];
+			VkValidationFeaturesEXT validationFeatures = { ZERO };
+			const FeatureRequest* request = initStruct->featureRequest;
+			FeatureGrant* grant = &initStruct->featureGrant;
+
+			//Layers and extensions are enumerated once, validation and request are both resolved against same lists
+			trace = vkCmdInitTraceBegin(initStruct, "negotiateInstance");
+			ScratchMark scratch = scratchMark(initStruct);
+			uint32_t layerCount;
+			VkLayerProperties* layers = vkCmdInitEnumerateInstanceLayers(initStruct, &layerCount);
+
+			uint32_t requestedLayerCount = request ? request->requiredInstanceLayerCount + request->optionalInstanceLayerCount : 0;
+			const char** enabledLayers = (const char**)scratchAllocate(initStruct, sizeof(const char*) * (requestedLayerCount + 1));
+			uint32_t enabledLayerCount = 0;
+			const char* missing = NULL;
+			if (enabledLayers && initStruct->validationProfile != VALIDATION_PROFILE_NONE &&
+				vkCmdInitHasProperty(layers, layerCount, sizeof(VkLayerProperties), VKCMDINIT_VALIDATION_LAYER_NAME))
+			{
+				enabledLayers[enabledLayerCount++] = VKCMDINIT_VALIDATION_LAYER_NAME;
+			}
+			if (enabledLayers && request)
+			{
+				missing = vkCmdInitNegotiateNames(layers, layerCount, sizeof(VkLayerProperties), request->requiredInstanceLayers, request->requiredInstanceLayerCount, true, enabledLayers, &enabledLayerCount);
+				vkCmdInitNegotiateNames(layers, layerCount, sizeof(VkLayerProperties), request->optionalInstanceLayers, request->optionalInstanceLayerCount, false, enabledLayers, &enabledLayerCount);
+			}
+			initStruct->validationEnabled = vkCmdInitHasName(enabledLayers, enabledLayerCount, VKCMDINIT_VALIDATION_LAYER_NAME);
+
+			uint32_t extensionCount;
+			VkExtensionProperties* extensions = vkCmdInitEnumerateInstanceExtensions(initStruct, enabledLayers, enabledLayerCount, &extensionCount);
+			uint32_t requestedExtensionCount = request ? request->requiredInstanceExtensionCount + request->optionalInstanceExtensionCount : 0;
+			const char** foundExtensions = (const char**)scratchAllocate(initStruct, sizeof(const char*) * (requestedExtensionCount + 1));
+			uint32_t foundExtensionCount = 0;
+			//Out of scratch fails like a missing requirement, no instance is created
+			bool negotiated = enabledLayers && foundExtensions;
+			if (foundExtensions && request)
+			{
+				const char* missingExtension = vkCmdInitNegotiateNames(extensions, extensionCount, sizeof(VkExtensionProperties), request->requiredInstanceExtensions, request->requiredInstanceExtensionCount, true, foundExtensions, &foundExtensionCount);
+				vkCmdInitNegotiateNames(extensions, extensionCount, sizeof(VkExtensionProperties), request->optionalInstanceExtensions, request->optionalInstanceExtensionCount, false, foundExtensions, &foundExtensionCount);
+				if (!missing)
+					missing = missingExtension;
+			}
+
+			uint32_t featureCount = 0;
+			if (initStruct->validationEnabled && initStruct->validationProfile == VALIDATION_PROFILE_EXTENDED &&
+				vkCmdInitHasProperty(extensions, extensionCount, sizeof(VkExtensionProperties), VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME))
+			{
+				if (initStruct->validationFeatures & VALIDATION_FEATURE_BEST_PRACTICES)
+					validationFeatureEnables[featureCount++] = VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT;
+				if (initStruct->validationFeatures & VALIDATION_FEATURE_GPU_ASSISTED)
+					validationFeatureEnables[featureCount++] = VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT;
+				if (initStruct->validationFeatures & VALIDATION_FEATURE_SYNCHRONIZATION)
+					validationFeatureEnables[featureCount++] = VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION_EXT;
+			}
+			if (featureCount && negotiated)
+			{
+				validationFeatures.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+				validationFeatures.enabledValidationFeatureCount = featureCount;
+				validationFeatures.pEnabledValidationFeatures = validationFeatureEnables;
+				initStruct->instanceInfo.pNext = &validationFeatures;
+				foundExtensions[foundExtensionCount++] = VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME;
+				initStruct->validationFeaturesEnabled = true;
+			}
+
+			for (uint32_t i = 0; i < foundExtensionCount; ++i)
+			{
+				if (!vkCmdInitHasName(initStruct->extensionPtr, initStruct->extensionCount, foundExtensions[i]))
+					addExtension(initStruct, foundExtensions[i]);
+			}
+			grant->instanceSatisfied = negotiated && missing == NULL;
+			grant->firstMissing = missing;
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			initStruct->instanceInfo.enabledLayerCount = enabledLayerCount;
+			initStruct->instanceInfo.ppEnabledLayerNames = enabledLayers;
+			initStruct->instanceInfo.ppEnabledExtensionNames = initStruct->extensionPtr;
+			initStruct->instanceInfo.enabledExtensionCount = initStruct->extensionCount;
+
+			if (grant->instanceSatisfied)
+			{
+				trace = vkCmdInitTraceBegin(initStruct, "vkCreateInstance");
+				initStruct->instanceTable.vkCreateInstance(&initStruct->instanceInfo, initStruct->allocationCallbacks, &initStruct->instance);
+				vkCmdInitTraceEnd(initStruct, trace);
+
+				trace = vkCmdInitTraceBegin(initStruct, "loadInstanceFunctions");
+				VKCMDINIT_INSTANCE_FUNCTIONS(VKCMDINIT_LOAD_INSTANCE_FUNCTION)
+				vkCmdInitTraceEnd(initStruct, trace);
+			}
+
+			if (initStruct->instance)
+			{
+				grant->instanceLayers = vkCmdInitCopyNames(initStruct, enabledLayers, enabledLayerCount, &grant->instanceLayerCount);
+				grant->instanceExtensions = vkCmdInitCopyNames(initStruct, initStruct->extensionPtr, initStruct->extensionCount, &grant->instanceExtensionCount);
+			}
+			scratchRewind(initStruct, scratch);
+		}
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		vkCmdInitHostFree(initStruct, (void*)initStruct->extensionPtr);
+		initStruct->extensionPtr = NULL;
+		initStruct->extensionCapacity = 0;
+		initStruct->instanceInfo.ppEnabledExtensionNames = NULL;
+		initStruct->instanceInfo.ppEnabledLayerNames = NULL;
+		initStruct->instanceInfo.pNext = NULL;
+		return initStruct;
+	}
+
+	//Defined next to the allocator below
+	static void vkCmdInitDestroyMemoryAllocator(InitializationStruct* initStruct);
+	//Defined next to the job system below
+	static void vkCmdInitDestroyDebugSink(InitializationStruct* initStruct);
+
+	void destroyDevice(InitializationStruct* initStruct)
+	{
+		collectRetiredSwapchains(initStruct, UINT64_MAX);
+		vkCmdInitHostFree(initStruct, initStruct->retiredSwapchains);
+		initStruct->retiredSwapchains = NULL;
+		initStruct->retiredSwapchainCapacity = 0;
+
+		vkCmdInitDestroyMemoryAllocator(initStruct);
+
+		if (initStruct->pipelineCache)
+		{
+			savePipelineCache(initStruct);
+			initStruct->deviceTable.vkDestroyPipelineCache(initStruct->device, initStruct->pipelineCache, initStruct->allocationCallbacks);
+			initStruct->pipelineCache = VK_NULL_HANDLE;
+		}
+
+		//Stays null (with its functions unloaded) if negotiation failed
+		if (initStruct->device)
+			initStruct->deviceTable.vkDestroyDevice(initStruct->device, initStruct->allocationCallbacks);
+		initStruct->device = VK_NULL_HANDLE;
+
+		vkCmdInitHostFree(initStruct, initStruct->defaultQueueIndices);
+		initStruct->defaultQueueIndices = NULL;
+	}
+
+	void destroySurface(InitializationStruct* initStruct)
+	{
+		if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
+		{
+			initStruct->instanceTable.vkDestroySurfaceKHR(initStruct->instance, initStruct->surface, initStruct->allocationCallbacks);
+			initStruct->instanceOptionalFlags = (InstanceOptionalFlags)(initStruct->instanceOptionalFlags & ~INSTANCE_OPTIONAL_FLAGS_SURFACE);
+			initStruct->surface = VK_NULL_HANDLE;
+		}
+	}
+
+	void terminateInstance(InitializationStruct* initStruct)
+	{
+		destroyDevice(initStruct);
+		destroySurface(initStruct);
+
+		if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_DEBUG_MESSENGER)
+		{
+			initStruct->instanceTable.vkDestroyDebugUtilsMessengerEXT(initStruct->instance, initStruct->debugMessenger, initStruct->allocationCallbacks);
+		}
+		//No more messages can arrive once messenger is gone
+		vkCmdInitDestroyDebugSink(initStruct);
+
+		//Stays null (with its functions unloaded) if negotiation failed
+		if (initStruct->instance)
+			initStruct->instanceTable.vkDestroyInstance(initStruct->instance, initStruct->allocationCallbacks);
+		vkCmdInitUnloadLoader(initStruct);
+
+		vkCmdInitHostFree(initStruct, (void*)initStruct->featureGrant.instanceLayers);
+		vkCmdInitHostFree(initStruct, (void*)initStruct->featureGrant.instanceExtensions);
+		vkCmdInitHostFree(initStruct, (void*)initStruct->featureGrant.deviceExtensions);
+		memset(&initStruct->featureGrant, 0, sizeof(initStruct->featureGrant));
+
+		if (initStruct->initTrace)
+		{
+			vkCmdInitHostFree(initStruct, initStruct->initTrace->events);
+			vkCmdInitHostFree(initStruct, initStruct->initTrace);
+			initStruct->initTrace = NULL;
+		}
+
+		ScratchMark emptyMark = { ZERO };
+		scratchRewind(initStruct, emptyMark);
+		vkCmdInitDestroyAllocationTracker(initStruct);
+	}
+
+	static void vkCmdInitScorePhysicalDevice(InitializationStruct* initStruct, const DeviceSelectionPolicy* policy, VkPhysicalDevice physicalDevice, PhysicalDeviceScore* score)
+	{
+		memset(score, 0, sizeof(*score));
+		score->physicalDevice = physicalDevice;
+		uint32_t scoreTrace = vkCmdInitTraceBegin(initStruct, "scorePhysicalDevice");
+		ScratchMark scratch = scratchMark(initStruct);
+
+		VkPhysicalDeviceProperties properties;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceProperties");
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		vkCmdInitTraceEnd(initStruct, trace);
+		memcpy(score->deviceName, properties.deviceName, sizeof(score->deviceName));
+		score->deviceType = properties.deviceType;
+
+		switch (properties.deviceType)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: score->score += policy->discreteGpuScore; break;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score->score += policy->integratedGpuScore; break;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: score->score += policy->virtualGpuScore; break;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU: score->score += policy->cpuScore; break;
+		default: score->score += policy->otherScore; break;
+		}
+
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceMemoryProperties");
+		initStruct->instanceTable.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+		vkCmdInitTraceEnd(initStruct, trace);
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+		{
+			if ((memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && memoryProperties.memoryHeaps[i].size > score->deviceLocalHeapSize)
+				score->deviceLocalHeapSize = memoryProperties.memoryHeaps[i].size;
+		}
+		uint64_t deviceLocalGiB = score->deviceLocalHeapSize >> 30;
+		score->score += policy->scorePerDeviceLocalGiB * (int64_t)(deviceLocalGiB < policy->deviceLocalGiBLimit ? deviceLocalGiB : policy->deviceLocalGiBLimit);
+
+		uint32_t queueFamilyCount = 0;
+		trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceQueueFamilyProperties");
+		initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, NULL);
+		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)scratchAllocate(initStruct, sizeof(VkQueueFamilyProperties) * queueFamilyCount);
+		//Device that couldn't be inspected is never suitable
+		bool inspected = queueFamilies != NULL;
+		if (queueFamilies)
+			initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies);
+		else
+			queueFamilyCount = 0;
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		bool hasSurface = (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE) != 0;
+		for (uint32_t i = 0; i < queueFamilyCount; ++i)
+		{
+			VkQueueFlags flags = queueFamilies[i].queueFlags;
+			if (flags & VK_QUEUE_GRAPHICS_BIT)
+				score->hasGraphicsQueue = true;
+			if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+				score->hasDedicatedComputeQueue = true;
+			if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+				score->hasDedicatedTransferQueue = true;
+
+			if (hasSurface && !score->supportsPresentation)
+			{
+				VkBool32 supported = VK_FALSE;
+				trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceSurfaceSupportKHR");
+				initStruct->instanceTable.vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, initStruct->surface, &supported);
+				vkCmdInitTraceEnd(initStruct, trace);
+				score->supportsPresentation = supported == VK_TRUE;
+			}
+		}
+
+		score->score += score->hasDedicatedComputeQueue ? policy->dedicatedComputeQueueScore : 0;
+		score->score += score->hasDedicatedTransferQueue ? policy->dedicatedTransferQueueScore : 0;
+		score->score += score->supportsPresentation ? policy->presentationSupportScore : 0;
+
+		if (policy->requiredExtensionCount)
+		{
+			uint32_t extensionCount = 0;
+			trace = vkCmdInitTraceBegin(initStruct, "vkEnumerateDeviceExtensionProperties");
+			initStruct->instanceTable.vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionCount, NULL);
+			VkExtensionProperties* extensions = (VkExtensionProperties*)scratchAllocate(initStruct, sizeof(VkExtensionProperties) * extensionCount);
+			inspected = inspected && extensions;
+			if (extensions)
+				initStruct->instanceTable.vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionCount, extensions);
+			else
+				extensionCount = 0;
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			for (uint32_t i = 0; i < policy->requiredExtensionCount; ++i)
+			{
+				bool found = false;
+				for (uint32_t j = 0; j < extensionCount && !found; ++j)
+					found = strcmp(policy->requiredExtensions[i], extensions[j].extensionName) == 0;
+				score->missingExtensionCount += found ? 0 : 1;
+			}
+		}
+		scratchRewind(initStruct, scratch);
+
+		score->suitable = inspected && score->missingExtensionCount == 0 &&
+			(score->hasGraphicsQueue || !policy->requireGraphicsQueue) &&
+			(score->supportsPresentation || !policy->requirePresentationSupport || !hasSurface);
+		vkCmdInitTraceEnd(initStruct, scoreTrace);
+	}
+
+	DeviceSelectionPolicy defaultDeviceSelectionPolicy()
+	{
+		DeviceSelectionPolicy policy = { ZERO };
+		//Device type dominates, memory and queues only break ties between devices of same type.
+		//Smallest type gap is 1000, memory and queues add at most 32 * 10 + 200 + 200 + 100 = 820
+		policy.discreteGpuScore = 10000;
+		policy.integratedGpuScore = 5000;
+		policy.virtualGpuScore = 2500;
+		policy.cpuScore = 1000;
+		policy.otherScore = 0;
+		policy.scorePerDeviceLocalGiB = 10;
+		policy.deviceLocalGiBLimit = 32;
+		policy.dedicatedComputeQueueScore = 200;
+		policy.dedicatedTransferQueueScore = 200;
+		policy.presentationSupportScore = 100;
+		policy.requiredExtensions = NULL;
+		policy.requiredExtensionCount = 0;
+		policy.requireGraphicsQueue = true;
+		policy.requirePresentationSupport = true;
+		return policy;
+	}
+
+	void scorePhysicalDevices(InitializationStruct* initStruct, /*can be null, if so, uses default policy*/ const DeviceSelectionPolicy* policy, uint32_t* scoreCount, /*can be null*/ PhysicalDeviceScore* scores)
+	{
+		uint32_t deviceCount = 0;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkEnumeratePhysicalDevices");
+		initStruct->instanceTable.vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, NULL);
+		vkCmdInitTraceEnd(initStruct, trace);
+		if (!scores)
+		{
+			*scoreCount = deviceCount;
+			return;
+		}
+
+		ScratchMark scratch = scratchMark(initStruct);
+		VkPhysicalDevice* devicesAvailable = (VkPhysicalDevice*)scratchAllocate(initStruct, deviceCount * sizeof(VkPhysicalDevice));
+		trace = vkCmdInitTraceBegin(initStruct, "vkEnumeratePhysicalDevices");
+		initStruct->instanceTable.vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, devicesAvailable);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		DeviceSelectionPolicy defaultPolicy = defaultDeviceSelectionPolicy();
+		if (!policy)
+			policy = &defaultPolicy;
+
+		if (deviceCount > *scoreCount)
+			deviceCount = *scoreCount;
+		for (uint32_t i = 0; i < deviceCount; ++i)
+			vkCmdInitScorePhysicalDevice(initStruct, policy, devicesAvailable[i], &scores[i]);
+
+		*scoreCount = deviceCount;
+		scratchRewind(initStruct, scratch);
+	}
+
+	InitializationStruct* selectPhysicalDevices(InitializationStruct* initStruct, /*can be NULL. If so, selects highest scored device (see scorePhysicalDevices), VK_NULL_HANDLE if none is suitable*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices, size_t deviceCount, /*ex. required device extensions*/ void* additionalData), /*if device enumerator is null, can be const DeviceSelectionPolicy* or null for default policy*/ void* additionalData)
+	{
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "selectPhysicalDevices");
+		ScratchMark scratch = scratchMark(initStruct);
+		if (deviceEnumerator)
+		{
+			uint32_t deviceCount;
+			uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkEnumeratePhysicalDevices");
+			initStruct->instanceTable.vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, NULL);
+			VkPhysicalDevice* devicesAvailable = (VkPhysicalDevice*)scratchAllocate(initStruct, deviceCount * sizeof(VkPhysicalDevice));
+			initStruct->instanceTable.vkEnumeratePhysicalDevices(initStruct->instance, &deviceCount, devicesAvailable);
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			trace = vkCmdInitTraceBegin(initStruct, "deviceEnumerator");
+			initStruct->physicalDevice = deviceEnumerator(devicesAvailable, deviceCount, additionalData);
+			vkCmdInitTraceEnd(initStruct, trace);
+		}
+		else
+		{
+			uint32_t scoreCount = 0;
+			scorePhysicalDevices(initStruct, (const DeviceSelectionPolicy*)additionalData, &scoreCount, NULL);
+			PhysicalDeviceScore* scores = (PhysicalDeviceScore*)scratchAllocate(initStruct, sizeof(PhysicalDeviceScore) * scoreCount);
+			scorePhysicalDevices(initStruct, (const DeviceSelectionPolicy*)additionalData, &scoreCount, scores);
+
+			const PhysicalDeviceScore* best = NULL;
+			for (uint32_t i = 0; i < scoreCount; ++i)
+			{
+				if (scores[i].suitable && (!best || scores[i].score > best->score))
+					best = &scores[i];
+			}
+			initStruct->physicalDevice = best ? best->physicalDevice : VK_NULL_HANDLE;
+		}
+
+		scratchRewind(initStruct, scratch);
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		return initStruct;
+	}
+
+	//Everything default createDevice path chains into VkDeviceCreateInfo, has to outlive vkCreateDevice
+	typedef struct VkCmdInitDeviceFeatureChain
+	{
+		VkPhysicalDeviceFeatures2 features;
+		VkPhysicalDeviceVulkan11Features features11;
+		VkPhysicalDeviceVulkan12Features features12;
+		VkPhysicalDeviceVulkan13Features features13;
+		//Below 1.2 only, otherwise folded into features12
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore;
+		VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexing;
+	} VkCmdInitDeviceFeatureChain;
+
+	//Count of VkBool32 members from first to last, sType/pNext header and tail padding are left out
+#define VKCMDINIT_FEATURE_COUNT(type, first, last) ((uint32_t)((offsetof(type, last) - offsetof(type, first)) / sizeof(VkBool32) + 1))
+
+	//enabled = (required | optional) & supported, false if some required feature isn't supported
+	static bool vkCmdInitMergeFeatures(VkBool32* enabled, const VkBool32* required, const VkBool32* optional, const VkBool32* supported, uint32_t featureCount)
+	{
+		bool satisfied = true;
+		for (uint32_t i = 0; i < featureCount; ++i)
+		{
+			if (required[i] && !supported[i])
+				satisfied = false;
+			enabled[i] = ((required[i] || optional[i]) && supported[i]) ? VK_TRUE : VK_FALSE;
+		}
+		return satisfied;
+	}
+
+	//Resolves request (or legacy "every 1.0 feature") against one query of device extensions and features, fills extensions,
+	//pEnabledFeatures/pNext of deviceCreateInfo and grant. Extension list lives in scratch, caller rewinds after vkCreateDevice
+	static bool vkCmdInitNegotiateDevice(InitializationStruct* initStruct, VkDeviceCreateInfo* deviceCreateInfo, VkCmdInitDeviceFeatureChain* chain, const char* const* deviceExtensions, uint32_t deviceExtensionCount)
+	{
+		FeatureGrant* grant = &initStruct->featureGrant;
+		const FeatureRequest* request = initStruct->featureRequest;
+		FeatureRequest legacyRequest;
+		if (!request)
+		{
+			memset(&legacyRequest, 0, sizeof(legacyRequest));
+			VkBool32* optional = &legacyRequest.optionalFeatures.robustBufferAccess;
+			for (uint32_t i = 0; i < VKCMDINIT_FEATURE_COUNT(VkPhysicalDeviceFeatures, robustBufferAccess, inheritedQueries); ++i)
+				optional[i] = VK_TRUE;
+			request = &legacyRequest;
+		}
+
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkEnumerateDeviceExtensionProperties");
+		uint32_t extensionCount = 0;
+		initStruct->instanceTable.vkEnumerateDeviceExtensionProperties(initStruct->physicalDevice, NULL, &extensionCount, NULL);
+		VkExtensionProperties* extensions = (VkExtensionProperties*)scratchAllocate(initStruct, sizeof(VkExtensionProperties) * extensionCount);
+		if (!extensions || initStruct->instanceTable.vkEnumerateDeviceExtensionProperties(initStruct->physicalDevice, NULL, &extensionCount, extensions) < VK_SUCCESS)
+			extensionCount = 0;
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		uint32_t maxExtensionCount = deviceExtensionCount + request->requiredDeviceExtensionCount + request->optionalDeviceExtensionCount;
+		const char** enabledExtensions = (const char**)scratchAllocate(initStruct, sizeof(const char*) * (maxExtensionCount + 1));
+		uint32_t enabledExtensionCount = 0;
+		if (!enabledExtensions)
+			return false;
+		const char* missing = vkCmdInitNegotiateNames(extensions, extensionCount, sizeof(VkExtensionProperties), deviceExtensions, deviceExtensionCount, true, enabledExtensions, &enabledExtensionCount);
+		const char* missingExtension = vkCmdInitNegotiateNames(extensions, extensionCount, sizeof(VkExtensionProperties), request->requiredDeviceExtensions, request->requiredDeviceExtensionCount, true, enabledExtensions, &enabledExtensionCount);
+		vkCmdInitNegotiateNames(extensions, extensionCount, sizeof(VkExtensionProperties), request->optionalDeviceExtensions, request->optionalDeviceExtensionCount, false, enabledExtensions, &enabledExtensionCount);
+		if (!missing)
+			missing = missingExtension;
+
+		//Feature structs of a version can only be queried and chained if both instance and device have it
+		VkPhysicalDeviceProperties properties;
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+		uint32_t apiVersion = initStruct->appInfo.apiVersion ? initStruct->appInfo.apiVersion : VK_API_VERSION_1_0;
+		if (properties.apiVersion < apiVersion)
+			apiVersion = properties.apiVersion;
+
+		VkCmdInitDeviceFeatureChain supported;
+		memset(&supported, 0, sizeof(supported));
+		memset(chain, 0, sizeof(*chain));
+		supported.features.sType = chain->features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supported.features11.sType = chain->features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		supported.features12.sType = chain->features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		supported.features13.sType = chain->features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+		if (apiVersion >= VK_API_VERSION_1_2)
+		{
+			supported.features.pNext = &supported.features11;
+			supported.features11.pNext = &supported.features12;
+			chain->features.pNext = &chain->features11;
+			chain->features11.pNext = &chain->features12;
+		}
+		if (apiVersion >= VK_API_VERSION_1_3)
+		{
+			supported.features12.pNext = &supported.features13;
+			chain->features12.pNext = &chain->features13;
+		}
+
+		trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceFeatures2");
+		if (apiVersion >= VK_API_VERSION_1_1 && initStruct->instanceTable.vkGetPhysicalDeviceFeatures2)
+			initStruct->instanceTable.vkGetPhysicalDeviceFeatures2(initStruct->physicalDevice, &supported.features);
+		else
+			initStruct->instanceTable.vkGetPhysicalDeviceFeatures(initStruct->physicalDevice, &supported.features.features);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		//withTimelineSemaphores/withBindlessDescriptors become required 1.2 features, chaining their own structs next to
+		//VkPhysicalDeviceVulkan12Features isn't allowed
+		bool core12 = apiVersion >= VK_API_VERSION_1_2;
+		VkPhysicalDeviceVulkan12Features required12 = request->requiredFeatures12;
+		VkPhysicalDeviceVulkan12Features* legacy12 = core12 ? &required12 : &chain->features12;
+		if (initStruct->enableTimelineSemaphore)
+		{
+			legacy12->timelineSemaphore = VK_TRUE;
+		}
+		if (initStruct->enableBindless)
+		{
+			legacy12->shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			legacy12->shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+			legacy12->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			legacy12->descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+			legacy12->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			legacy12->descriptorBindingPartiallyBound = VK_TRUE;
+			legacy12->runtimeDescriptorArray = VK_TRUE;
+		}
+
+		if (!vkCmdInitMergeFeatures(&chain->features.features.robustBufferAccess, &request->requiredFeatures.robustBufferAccess, &request->optionalFeatures.robustBufferAccess,
+			&supported.features.features.robustBufferAccess, VKCMDINIT_FEATURE_COUNT(VkPhysicalDeviceFeatures, robustBufferAccess, inheritedQueries)) && !missing)
+			missing = "VkPhysicalDeviceFeatures";
+		if (!vkCmdInitMergeFeatures(&chain->features11.storageBuffer16BitAccess, &request->requiredFeatures11.storageBuffer16BitAccess, &request->optionalFeatures11.storageBuffer16BitAccess,
+			&supported.features11.storageBuffer16BitAccess, VKCMDINIT_FEATURE_COUNT(VkPhysicalDeviceVulkan11Features, storageBuffer16BitAccess, shaderDrawParameters)) && !missing)
+			missing = "VkPhysicalDeviceVulkan11Features";
+		//Below 1.2 merge only finds missing required ones, chain->features12 keeps mirroring the legacy structs
+		VkPhysicalDeviceVulkan12Features unchained12;
+		VkPhysicalDeviceVulkan12Features* enabled12 = core12 ? &chain->features12 : &unchained12;
+		if (!vkCmdInitMergeFeatures(&enabled12->samplerMirrorClampToEdge, &required12.samplerMirrorClampToEdge, &request->optionalFeatures12.samplerMirrorClampToEdge,
+			&supported.features12.samplerMirrorClampToEdge, VKCMDINIT_FEATURE_COUNT(VkPhysicalDeviceVulkan12Features, samplerMirrorClampToEdge, subgroupBroadcastDynamicId)) && !missing)
+			missing = "VkPhysicalDeviceVulkan12Features";
+		if (!vkCmdInitMergeFeatures(&chain->features13.robustImageAccess, &request->requiredFeatures13.robustImageAccess, &request->optionalFeatures13.robustImageAccess,
+			&supported.features13.robustImageAccess, VKCMDINIT_FEATURE_COUNT(VkPhysicalDeviceVulkan13Features, robustImageAccess, maintenance4)) && !missing)
+			missing = "VkPhysicalDeviceVulkan13Features";
+
+		if (apiVersion >= VK_API_VERSION_1_1)
+		{
+			//VkPhysicalDeviceFeatures2 in pNext replaces pEnabledFeatures
+			deviceCreateInfo->pNext = &chain->features;
+			deviceCreateInfo->pEnabledFeatures = NULL;
+		}
+		else
+		{
+			deviceCreateInfo->pEnabledFeatures = &chain->features.features;
+		}
+
+		if (!core12 && initStruct->enableTimelineSemaphore)
+		{
+			chain->timelineSemaphore.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+			chain->timelineSemaphore.timelineSemaphore = VK_TRUE;
+			chain->timelineSemaphore.pNext = (void*)deviceCreateInfo->pNext;
+			deviceCreateInfo->pNext = &chain->timelineSemaphore;
+		}
+		if (!core12 && initStruct->enableBindless)
+		{
+			chain->descriptorIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+			chain->descriptorIndexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			chain->descriptorIndexing.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+			chain->descriptorIndexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			chain->descriptorIndexing.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+			chain->descriptorIndexing.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			chain->descriptorIndexing.descriptorBindingPartiallyBound = VK_TRUE;
+			chain->descriptorIndexing.runtimeDescriptorArray = VK_TRUE;
+			chain->descriptorIndexing.pNext = (void*)deviceCreateInfo->pNext;
+			deviceCreateInfo->pNext = &chain->descriptorIndexing;
+		}
+
+		deviceCreateInfo->ppEnabledExtensionNames = enabledExtensions;
+		deviceCreateInfo->enabledExtensionCount = enabledExtensionCount;
+
+		grant->deviceSatisfied = missing == NULL;
+		if (!grant->firstMissing)
+			grant->firstMissing = missing;
+		grant->apiVersion = apiVersion;
+		if (grant->deviceSatisfied)
+		{
+			vkCmdInitHostFree(initStruct, (void*)grant->deviceExtensions);
+			grant->deviceExtensions = vkCmdInitCopyNames(initStruct, enabledExtensions, enabledExtensionCount, &grant->deviceExtensionCount);
+			grant->features = chain->features.features;
+			grant->features11 = chain->features11;
+			grant->features12 = chain->features12;
+			grant->features13 = chain->features13;
+			grant->features11.pNext = NULL;
+			grant->features12.pNext = NULL;
+			grant->features13.pNext = NULL;
+		}
+		return grant->deviceSatisfied;
+	}
+
+	//beginAsyncInit creates pipeline cache on a worker instead
+	static InitializationStruct* vkCmdInitCreateDevice(InitializationStruct* initStruct, void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount), const char* const* deviceExtensions, uint32_t deviceExtensionCount, bool createPipelineCache)
+	{
+		VkDeviceCreateInfo deviceCreateInfo = { ZERO };
+		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+
+		//Referenced by deviceCreateInfo, have to outlive vkCreateDevice
+		VkCmdInitDeviceFeatureChain featureChain;
+		VkDeviceQueueCreateInfo queueCreateinfos[4];
+		float queuePriorities[4][VKCMDINIT_MAX_QUEUES_PER_FAMILY];
+		ScratchMark negotiationScratch = scratchMark(initStruct);
+		bool satisfied = true;
+
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "createDevice");
+		uint32_t trace;
+		if (deviceDesigner)
+		{
+			trace = vkCmdInitTraceBegin(initStruct, "deviceDesigner");
+			initStruct->queueIndices = deviceDesigner(initStruct->physicalDevice, &deviceCreateInfo, deviceExtensions, deviceExtensionCount);
+			vkCmdInitTraceEnd(initStruct, trace);
+		}
+		else
+		{
+			trace = vkCmdInitTraceBegin(initStruct, "negotiateDevice");
+			satisfied = vkCmdInitNegotiateDevice(initStruct, &deviceCreateInfo, &featureChain, deviceExtensions, deviceExtensionCount);
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			uint32_t queueFamilyCount;
+			trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceQueueFamilyProperties");
+			initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, NULL);
+			ScratchMark scratch = scratchMark(initStruct);
+			VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)scratchAllocate(initStruct, sizeof(VkQueueFamilyProperties) * queueFamilyCount);
+			if (queueFamilies)
+				initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, queueFamilies);
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			//Out of scratch, families can't be picked so the device isn't created
+			if (!queueFamilies)
+			{
+				queueFamilyCount = 0;
+				satisfied = false;
+			}
+
+			uint32_t graphicQueueIndex = UINT32_MAX;
+			uint32_t presentationQueueIndex = UINT32_MAX;
+			uint32_t computeQueueIndex = UINT32_MAX;
+			uint32_t transferQueueIndex = UINT32_MAX;
+			bool hasSurface = (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE) != 0;
+
+			for (uint32_t i = 0; i < queueFamilyCount; ++i)
+			{
+				//Do NOT use else if, there's a possibility that both queue families have same index (i.e. there's a universal queue family for 2)
+				VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+				//First graphics family is the universal one on every known implementation
+				if ((flags & VK_QUEUE_GRAPHICS_BIT) && graphicQueueIndex == UINT32_MAX)
+				{
+					graphicQueueIndex = i;
+				}
+
+				//Async compute, runs next to graphics
+				if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) && computeQueueIndex == UINT32_MAX)
+				{
+					computeQueueIndex = i;
+				}
+
+				//DMA engine, uploads without taking graphics/compute time
+				if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && transferQueueIndex == UINT32_MAX)
+				{
+					transferQueueIndex = i;
+				}
+
+				if (hasSurface)
+				{
+					VkBool32 supported = VK_FALSE;
+					trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceSurfaceSupportKHR");
+					initStruct->instanceTable.vkGetPhysicalDeviceSurfaceSupportKHR(initStruct->physicalDevice, i, initStruct->surface, &supported);
+					vkCmdInitTraceEnd(initStruct, trace);
+					//Presenting from graphics family avoids concurrent sharing of swapchain images
+					if (supported && (presentationQueueIndex == UINT32_MAX || i == graphicQueueIndex))
+						presentationQueueIndex = i;
+				}
+			}
+
+			if (graphicQueueIndex == UINT32_MAX)
+				graphicQueueIndex = 0;
+			if (presentationQueueIndex == UINT32_MAX)
+				presentationQueueIndex = graphicQueueIndex;
+			if (computeQueueIndex == UINT32_MAX)
+				computeQueueIndex = graphicQueueIndex;
+			if (transferQueueIndex == UINT32_MAX)
+				transferQueueIndex = graphicQueueIndex;
+
+			//One create info per distinct family, presentation gets a single queue unless it shares family with a role
+			uint32_t families[] = { graphicQueueIndex, computeQueueIndex, transferQueueIndex, presentationQueueIndex };
+			uint32_t queueCreateInfoCount = 0;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				uint32_t slot = 0;
+				while (slot < queueCreateInfoCount && queueCreateinfos[slot].queueFamilyIndex != families[i])
+					++slot;
+
+				if (slot == queueCreateInfoCount)
+				{
+					VkDeviceQueueCreateInfo queueCreateInfo = { ZERO };
+					queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+					queueCreateInfo.pQueuePriorities = queuePriorities[slot];
+					queueCreateInfo.queueCount = 0;
+					queueCreateInfo.queueFamilyIndex = families[i];
+					queueCreateinfos[queueCreateInfoCount++] = queueCreateInfo;
+				}
+
+				uint32_t requested = (i < QUEUE_ROLE_COUNT) ? initStruct->queueRequestCounts[i] : 1;
+				const float* requestedPriorities = (i < QUEUE_ROLE_COUNT) ? initStruct->queueRequestPriorities[i] : NULL;
+				if (requested == 0)
+					requested = 1;
+				if (queueFamilies && requested > queueFamilies[families[i]].queueCount)
+					requested = queueFamilies[families[i]].queueCount;
+				if (requested > VKCMDINIT_MAX_QUEUES_PER_FAMILY)
+					requested = VKCMDINIT_MAX_QUEUES_PER_FAMILY;
+
+				//Merge with roles already sharing this family
+				uint32_t existing = queueCreateinfos[slot].queueCount;
+				for (uint32_t q = 0; q < requested; ++q)
+				{
+					float priority = requestedPriorities ? requestedPriorities[q] : 1.0f;
+					if (q >= existing || priority > queuePriorities[slot][q])
+						queuePriorities[slot][q] = priority;
+				}
+				if (requested > existing)
+					queueCreateinfos[slot].queueCount = requested;
+			}
+
+			scratchRewind(initStruct, scratch);
+
+			deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
+			deviceCreateInfo.pQueueCreateInfos = queueCreateinfos;
+
+
+			DefaultQueueIndices defaultQueueIndices;
+
+			defaultQueueIndices.graphicQueueIndex = graphicQueueIndex;
+			defaultQueueIndices.presentationFamilyIndex = presentationQueueIndex;
+			defaultQueueIndices.computeFamilyIndex = computeQueueIndex;
+			defaultQueueIndices.transferFamilyIndex = transferQueueIndex;
+			defaultQueueIndices.graphicsQueueCount = 1;
+			defaultQueueIndices.computeQueueCount = 1;
+			defaultQueueIndices.transferQueueCount = 1;
+			for (uint32_t i = 0; i < queueCreateInfoCount; ++i)
+			{
+				if (queueCreateinfos[i].queueFamilyIndex == graphicQueueIndex)
+					defaultQueueIndices.graphicsQueueCount = queueCreateinfos[i].queueCount;
+				if (queueCreateinfos[i].queueFamilyIndex == computeQueueIndex)
+					defaultQueueIndices.computeQueueCount = queueCreateinfos[i].queueCount;
+				if (queueCreateinfos[i].queueFamilyIndex == transferQueueIndex)
+					defaultQueueIndices.transferQueueCount = queueCreateinfos[i].queueCount;
+			}
+
+			//Without it default queue helpers can't be used, fail device creation instead
+			initStruct->defaultQueueIndices = (DefaultQueueIndices*)vkCmdInitHostAllocate(initStruct, sizeof(defaultQueueIndices), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+			if (initStruct->defaultQueueIndices)
+				*initStruct->defaultQueueIndices = defaultQueueIndices;
+			else
+				satisfied = false;
+
+		}
+		//Missing required extension or feature, vkCreateDevice would fail anyway
+		if (satisfied)
+		{
+			trace = vkCmdInitTraceBegin(initStruct, "vkCreateDevice");
+			initStruct->instanceTable.vkCreateDevice(initStruct->physicalDevice, &deviceCreateInfo, initStruct->allocationCallbacks, &initStruct->device);
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			trace = vkCmdInitTraceBegin(initStruct, "loadDeviceFunctions");
+			VKCMDINIT_DEVICE_FUNCTIONS(VKCMDINIT_LOAD_DEVICE_FUNCTION)
+			VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(vkGetSemaphoreCounterValue, vkGetSemaphoreCounterValueKHR)
+			VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(vkWaitSemaphores, vkWaitSemaphoresKHR)
+			VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(vkSignalSemaphore, vkSignalSemaphoreKHR)
+			VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(vkGetBufferMemoryRequirements2, vkGetBufferMemoryRequirements2KHR)
+			VKCMDINIT_LOAD_DEVICE_FUNCTION_ALIAS(vkGetImageMemoryRequirements2, vkGetImageMemoryRequirements2KHR)
+			vkCmdInitTraceEnd(initStruct, trace);
+
+			if (createPipelineCache && initStruct->pipelineCachePath)
+			{
+				trace = vkCmdInitTraceBegin(initStruct, "createPipelineCache");
+				vkCmdInitCreatePipelineCache(initStruct);
+				vkCmdInitTraceEnd(initStruct, trace);
+			}
+		}
+		scratchRewind(initStruct, negotiationScratch);
+
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		return initStruct;
+	}
+
+	InitializationStruct* createDevice(InitializationStruct* initStruct, /*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount), const char* const* deviceExtensions, uint32_t deviceExtensionCount)
+	{
+		return vkCmdInitCreateDevice(initStruct, deviceDesigner, deviceExtensions, deviceExtensionCount, true);
+	}
+
+	void retrieveQueues(InitializationStruct* initStruct, /*if queueRetriever isn't custom, should be array of a graphics queue and a presentation queue (non-initialized if VkSurfaceKHR isn't present)*/ VkQueue* queues, uint32_t** familyIndices, /*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices))
+	{
+		if (queueRetriever)
+		{
+			queueRetriever(initStruct->queueIndices, initStruct->device, queues, familyIndices);
+		}
+		else
+		{
+			initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->graphicQueueIndex, 0, &queues[0]);
+			if (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE)
+				initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->presentationFamilyIndex, 0, &queues[1]);
+			*((DefaultQueueIndices**)familyIndices) = initStruct->defaultQueueIndices;
+		}
+	}
+
+	void retrieveDefaultQueues(InitializationStruct* initStruct, DefaultQueueRetrieveStruct* queues, uint32_t** familyIndices)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return;
+
+		VkQueue pair[2] = { VK_NULL_HANDLE, queues->presentationQueue };
+		retrieveQueues(initStruct, pair, familyIndices, NULL);
+		queues->graphicsQueue = pair[0];
+		queues->presentationQueue = pair[1];
+		initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->computeFamilyIndex, 0, &queues->computeQueue);
+		initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, initStruct->defaultQueueIndices->transferFamilyIndex, 0, &queues->transferQueue);
+	}
+
+	InitializationStruct* withQueueCount(InitializationStruct* initStruct, QueueRole role, uint32_t queueCount, /*can be null (all 1.0f), otherwise queueCount priorities in [0, 1], has to stay alive until createDevice*/ const float* priorities)
+	{
+		if ((uint32_t)role < QUEUE_ROLE_COUNT)
+		{
+			initStruct->queueRequestCounts[role] = queueCount;
+			initStruct->queueRequestPriorities[role] = priorities;
+		}
+		return initStruct;
+	}
+
+	static void vkCmdInitQueueRoleFamily(const DefaultQueueIndices* queueIndices, QueueRole role, uint32_t* familyIndex, uint32_t* queueCount)
+	{
+		switch (role)
+		{
+		case QUEUE_ROLE_COMPUTE:
+			*familyIndex = queueIndices->computeFamilyIndex;
+			*queueCount = queueIndices->computeQueueCount;
+			break;
+		case QUEUE_ROLE_TRANSFER:
+			*familyIndex = queueIndices->transferFamilyIndex;
+			*queueCount = queueIndices->transferQueueCount;
+			break;
+		case QUEUE_ROLE_GRAPHICS:
+			*familyIndex = queueIndices->graphicQueueIndex;
+			*queueCount = queueIndices->graphicsQueueCount;
+			break;
+		default:
+			*familyIndex = UINT32_MAX;
+			*queueCount = 0;
+			break;
+		}
+	}
+
+	VkQueue retrieveQueue(InitializationStruct* initStruct, QueueRole role, uint32_t queueIndex)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return VK_NULL_HANDLE;
+
+		uint32_t familyIndex, queueCount;
+		vkCmdInitQueueRoleFamily(initStruct->defaultQueueIndices, role, &familyIndex, &queueCount);
+		if (queueIndex >= queueCount)
+			return VK_NULL_HANDLE;
+
+		VkQueue queue = VK_NULL_HANDLE;
+		initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, familyIndex, queueIndex, &queue);
+		return queue;
+	}
+
+	uint32_t retrieveWorkerQueues(InitializationStruct* initStruct, QueueRole role, uint32_t workerCount, /*can be null*/ VkQueue* workerQueues)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return 0;
+
+		uint32_t familyIndex, queueCount;
+		vkCmdInitQueueRoleFamily(initStruct->defaultQueueIndices, role, &familyIndex, &queueCount);
+
+		//Compute and transfer fall back to graphics family, their queue 0 would then be the one retrieveQueues hands to frame loop
+		bool hasSurface = (initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE) != 0;
+		uint32_t firstQueue = familyIndex == initStruct->defaultQueueIndices->graphicQueueIndex ||
+			(hasSurface && familyIndex == initStruct->defaultQueueIndices->presentationFamilyIndex) ? 1 : 0;
+		if (queueCount <= firstQueue)
+			return 0;
+		queueCount -= firstQueue;
+
+		if (workerQueues)
+		{
+			for (uint32_t i = 0; i < workerCount; ++i)
+				initStruct->deviceTable.vkGetDeviceQueue(initStruct->device, familyIndex, firstQueue + i % queueCount, &workerQueues[i]);
+		}
+		return queueCount;
+	}
+
+	InitializationStruct* withMemoryAllocator(InitializationStruct* initStruct, VkDeviceSize blockSize)
+	{
+		initStruct->memoryBlockSize = blockSize;
+		return initStruct;
+	}
+
+	InitializationStruct* withSwapchainReadback(InitializationStruct* initStruct)
+	{
+		initStruct->swapchainImageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		return initStruct;
+	}
+
+	InitializationStruct* withTimelineSemaphores(InitializationStruct* initStruct)
+	{
+		initStruct->enableTimelineSemaphore = true;
+		return initStruct;
+	}
+
+	InitializationStruct* withBindlessDescriptors(InitializationStruct* initStruct)
+	{
+		initStruct->enableBindless = true;
+		return initStruct;
+	}
+
+	FeatureRequest defaultFeatureRequest()
+	{
+		FeatureRequest request;
+		memset(&request, 0, sizeof(request));
+		request.requiredFeatures11.sType = request.optionalFeatures11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		request.requiredFeatures12.sType = request.optionalFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		request.requiredFeatures13.sType = request.optionalFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+		request.optionalFeatures.samplerAnisotropy = VK_TRUE;
+		request.optionalFeatures.multiDrawIndirect = VK_TRUE;
+		request.optionalFeatures.drawIndirectFirstInstance = VK_TRUE;
+		request.optionalFeatures12.drawIndirectCount = VK_TRUE;
+		request.optionalFeatures12.timelineSemaphore = VK_TRUE;
+		request.optionalFeatures12.bufferDeviceAddress = VK_TRUE;
+		request.optionalFeatures12.scalarBlockLayout = VK_TRUE;
+		request.optionalFeatures12.hostQueryReset = VK_TRUE;
+		request.optionalFeatures12.descriptorIndexing = VK_TRUE;
+		request.optionalFeatures12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		request.optionalFeatures12.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+		request.optionalFeatures12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		request.optionalFeatures12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+		request.optionalFeatures12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		request.optionalFeatures12.descriptorBindingPartiallyBound = VK_TRUE;
+		request.optionalFeatures12.runtimeDescriptorArray = VK_TRUE;
+		request.optionalFeatures13.synchronization2 = VK_TRUE;
+		request.optionalFeatures13.dynamicRendering = VK_TRUE;
+		request.optionalFeatures13.maintenance4 = VK_TRUE;
+		request.optionalFeatures13.pipelineCreationCacheControl = VK_TRUE;
+		return request;
+	}
+
+	InitializationStruct* withFeatureRequest(InitializationStruct* initStruct, const FeatureRequest* request)
+	{
+		initStruct->featureRequest = request;
+		return initStruct;
+	}
+
+	InitializationStruct* withInitTracing(InitializationStruct* initStruct)
+	{
+		if (!initStruct->initTrace)
+		{
+			initStruct->initTrace = (InitTrace*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(InitTrace), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+			if (initStruct->initTrace)
+				initStruct->initTrace->originNanoseconds = vkCmdInitNanoseconds();
+		}
+		return initStruct;
+	}
+
+	uint32_t beginTraceScope(InitializationStruct* initStruct, /*has to outlive the trace*/ const char* name)
+	{
+		return vkCmdInitTraceBegin(initStruct, name);
+	}
+
+	void endTraceScope(InitializationStruct* initStruct, uint32_t traceScope)
+	{
+		vkCmdInitTraceEnd(initStruct, traceScope);
+	}
+
+	//Complete ("X") event of Chrome trace event format, viewer nests events by time so depth isn't written. Timestamps are in microseconds
+	static void vkCmdInitWriteTraceEvent(FILE* file, const char* name, const char* category, uint32_t threadId, uint64_t startNanoseconds, uint64_t durationNanoseconds, bool last)
+	{
+		fputs("{\"name\":\"", file);
+		for (const char* c = name; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				fputc('\\', file);
+			if ((unsigned char)*c >= 0x20)
+				fputc(*c, file);
+		}
+		fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u}%s\n", category, threadId,
+			(unsigned long long)(startNanoseconds / 1000), (unsigned)(startNanoseconds % 1000),
+			(unsigned long long)(durationNanoseconds / 1000), (unsigned)(durationNanoseconds % 1000),
+			last ? "" : ",");
+	}
+
+	VkResult exportInitTrace(const InitializationStruct* initStruct, const char* path)
+	{
+		const InitTrace* trace = initStruct->initTrace;
+		if (!trace)
+			return VK_ERROR_INITIALIZATION_FAILED;
+
+		FILE* file = fopen(path, "wb");
+		if (!file)
+			return VK_ERROR_INITIALIZATION_FAILED;
+
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		for (uint32_t i = 0; i < trace->eventCount; ++i)
+		{
+			const InitTraceEvent* event = &trace->events[i];
+			vkCmdInitWriteTraceEvent(file, event->name, "init", 1, event->startNanoseconds, event->durationNanoseconds, i + 1 == trace->eventCount);
+		}
+		fprintf(file, "]}\n");
+
+		bool written = !ferror(file);
+		return (fclose(file) == 0 && written) ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED;
+	}
+
+	InitializationStruct* withPipelineCache(InitializationStruct* initStruct, const char* cachePath)
+	{
+		initStruct->pipelineCachePath = cachePath;
+		if (initStruct->device && !initStruct->pipelineCache)
+			vkCmdInitCreatePipelineCache(initStruct);
+		return initStruct;
+	}
+
+	VkResult savePipelineCache(InitializationStruct* initStruct)
+	{
+		if (!initStruct->pipelineCache || !initStruct->pipelineCachePath)
+			return VK_ERROR_INITIALIZATION_FAILED;
+
+		size_t dataSize = 0;
+		VkResult result = initStruct->deviceTable.vkGetPipelineCacheData(initStruct->device, initStruct->pipelineCache, &dataSize, NULL);
+		if (result != VK_SUCCESS)
+			return result;
+
+		uint8_t* fileData = (uint8_t*)vkCmdInitHostAllocate(initStruct, sizeof(VkCmdInitPipelineCacheFileHeader) + dataSize, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+		if (!fileData)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		result = initStruct->deviceTable.vkGetPipelineCacheData(initStruct->device, initStruct->pipelineCache, &dataSize, fileData + sizeof(VkCmdInitPipelineCacheFileHeader));
+		if (result == VK_SUCCESS)
+		{
+			VkPhysicalDeviceProperties properties;
+			initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+
+			VkCmdInitPipelineCacheFileHeader header = { ZERO };
+			header.magic = VKCMDINIT_PIPELINE_CACHE_MAGIC;
+			header.fileVersion = VKCMDINIT_PIPELINE_CACHE_FILE_VERSION;
+			header.vendorID = properties.vendorID;
+			header.deviceID = properties.deviceID;
+			header.driverVersion = properties.driverVersion;
+			header.headerSize = sizeof(header);
+			header.dataSize = dataSize;
+			header.dataHash = vkCmdInitHash(fileData + sizeof(header), dataSize, VKCMDINIT_HASH_SEED);
+			memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+			memcpy(fileData, &header, sizeof(header));
+
+			if (vkCmdInitWriteFileAtomic(initStruct, initStruct->pipelineCachePath, fileData, sizeof(header) + dataSize))
+				initStruct->pipelineCacheStats.savedBytes = dataSize;
+			else
+				result = VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		vkCmdInitHostFree(initStruct, fileData);
+		return result;
+	}
+
+	void recordPipelineCacheFeedback(InitializationStruct* initStruct, const VkPipelineCreationFeedbackEXT* pipelineFeedback)
+	{
+		if (!(pipelineFeedback->flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+			return;
+
+		if (pipelineFeedback->flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+			initStruct->pipelineCacheStats.hits += 1;
+		else
+			initStruct->pipelineCacheStats.misses += 1;
+	}
+
+	InitializationStruct* withDebugOutput(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc, void* userData, VkDebugUtilsMessageSeverityFlagsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType)
+	{
+		VkDebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfo = { ZERO };
+		debugUtilsMessengerCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+		debugUtilsMessengerCreateInfo.messageSeverity = messageSeverity;
+		debugUtilsMessengerCreateInfo.messageType = messageType;
+		debugUtilsMessengerCreateInfo.pfnUserCallback = debugOutputProc;
+		debugUtilsMessengerCreateInfo.pUserData = userData;
+
+
+		//NULL if VK_EXT_debug_utils wasn't added with addExtension
+		if (!initStruct->instanceTable.vkCreateDebugUtilsMessengerEXT)
+			return initStruct;
+
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkCreateDebugUtilsMessengerEXT");
+		initStruct->instanceTable.vkCreateDebugUtilsMessengerEXT(initStruct->instance, &debugUtilsMessengerCreateInfo, initStruct->allocationCallbacks, &initStruct->debugMessenger);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_DEBUG_MESSENGER;
+
+		return initStruct;
+	}
+
+	InitializationStruct* withDebugOutput1(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc, void* userData)
+	{
+		//Default options from vulkan-tutorial.com
+		//Thanks!
+		return withDebugOutput(initStruct, debugOutputProc, userData, VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT, VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT);
+	}
+
+	InitializationStruct* withDebugOutput2(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc)
+	{
+		return withDebugOutput1(initStruct, debugOutputProc, NULL);
+	}
+
+#ifdef VKCMDINIT_GLFW
+	InitializationStruct* withSurfaceGLFW(InitializationStruct* initStruct, GLFWwindow* window)
+	{
+		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_SURFACE;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "glfwCreateWindowSurface");
+		glfwCreateWindowSurface(initStruct->instance, window, initStruct->allocationCallbacks, &initStruct->surface);
+		vkCmdInitTraceEnd(initStruct, trace);
+		return initStruct;
+	}
+#endif
+
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+	//FIXME: Untested
+	InitializationStruct* withSurfaceWin32(InitializationStruct* initStruct, HINSTANCE processHandle, HWND windowHandle)
+	{
+
+		initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_SURFACE;
+
+		VkWin32SurfaceCreateInfoKHR win32SurfaceCreateInfo = { ZERO };
+		win32SurfaceCreateInfo.hinstance = processHandle;
+		win32SurfaceCreateInfo.hwnd = windowHandle;
+		win32SurfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+		PFN_vkCreateWin32SurfaceKHR vkCreateWin32SurfaceKHR = (PFN_vkCreateWin32SurfaceKHR)initStruct->instanceTable.vkGetInstanceProcAddr(initStruct->instance, "vkCreateWin32SurfaceKHR");
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkCreateWin32SurfaceKHR");
+		vkCreateWin32SurfaceKHR(initStruct->instance, &win32SurfaceCreateInfo, initStruct->allocationCallbacks, &initStruct->surface);
+		vkCmdInitTraceEnd(initStruct, trace);
+		return initStruct;
+	}
+
+	//TODO: Add Linux and Mac OS support
+
+#endif
+
+	InitializationStruct* withSurfaceHeadless(InitializationStruct* initStruct)
+	{
+		//NULL if VK_EXT_headless_surface wasn't added with addExtension
+		if (!initStruct->instanceTable.vkCreateHeadlessSurfaceEXT)
+			return initStruct;
+
+		VkHeadlessSurfaceCreateInfoEXT headlessSurfaceCreateInfo = { ZERO };
+		headlessSurfaceCreateInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkCreateHeadlessSurfaceEXT");
+		if (initStruct->instanceTable.vkCreateHeadlessSurfaceEXT(initStruct->instance, &headlessSurfaceCreateInfo, initStruct->allocationCallbacks, &initStruct->surface) == VK_SUCCESS)
+			initStruct->instanceOptionalFlags |= INSTANCE_OPTIONAL_FLAGS_SURFACE;
+		vkCmdInitTraceEnd(initStruct, trace);
+		return initStruct;
+	}
+
+	//Creates swapchain from format/present mode cached by createSwapchainKHR. Image array is reused when swapchainImagesAllocated is set
+	//imageCapacity 0 means arrays are (re)allocated, otherwise they are app's arrays of that many elements
+	static VkSwapchainKHR vkCmdInitBuildSwapchain(InitializationStruct* initStruct, const VkSurfaceCapabilitiesKHR* surfaceCapabilities, VkExtent2D extent, uint32_t imageCount, VkSwapchainKHR oldSwapchain, uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage** swapchainImages, bool swapchainImagesAllocated, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		VkSwapchainCreateInfoKHR swapchainCreateinfo = { ZERO };
+		swapchainCreateinfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+		swapchainCreateinfo.clipped = VK_TRUE;
+		swapchainCreateinfo.minImageCount = imageCount;
+		swapchainCreateinfo.imageExtent = extent;
+		swapchainCreateinfo.surface = initStruct->surface;
+		swapchainCreateinfo.imageColorSpace = initStruct->swapchainFormat.colorSpace;
+		swapchainCreateinfo.imageFormat = initStruct->swapchainFormat.format;
+		swapchainCreateinfo.presentMode = initStruct->swapchainPresentMode;
+		swapchainCreateinfo.imageArrayLayers = 1; //It's some strange thing so I won't touch it..
+		//Extra usage the surface can't provide is dropped rather than failing swapchain creation
+		swapchainCreateinfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (initStruct->swapchainImageUsage & surfaceCapabilities->supportedUsageFlags);
+		initStruct->swapchainGrantedUsage = swapchainCreateinfo.imageUsage;
+		//Once again, thanks vulkan-tutorial for this code piece
+		if (initStruct->defaultQueueIndices->graphicQueueIndex != initStruct->defaultQueueIndices->presentationFamilyIndex)
+		{
+			swapchainCreateinfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+			swapchainCreateinfo.queueFamilyIndexCount = 2;
+			swapchainCreateinfo.pQueueFamilyIndices = (uint32_t*)initStruct->defaultQueueIndices;
+		}
+		else
+		{
+			swapchainCreateinfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			swapchainCreateinfo.queueFamilyIndexCount = 0;
+			swapchainCreateinfo.pQueueFamilyIndices = NULL;
+		}
+		//TODO: Make this customizable
+		swapchainCreateinfo.preTransform = surfaceCapabilities->currentTransform;
+		swapchainCreateinfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+
+		//Lets driver hand over resources and keep presenting old images while the new swapchain is created
+		swapchainCreateinfo.oldSwapchain = oldSwapchain;
+
+		VkSwapchainKHR swapchain;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkCreateSwapchainKHR");
+		VkResult result = initStruct->deviceTable.vkCreateSwapchainKHR(initStruct->device, &swapchainCreateinfo, initStruct->allocationCallbacks, &swapchain);
+		vkCmdInitTraceEnd(initStruct, trace);
+		if (result != VK_SUCCESS)
+		{
+			*swapchainImageCount = 0;
+			return VK_NULL_HANDLE;
+		}
+
+		trace = vkCmdInitTraceBegin(initStruct, "vkGetSwapchainImagesKHR");
+		initStruct->deviceTable.vkGetSwapchainImagesKHR(initStruct->device, swapchain, swapchainImageCount, NULL);
+		if (imageCapacity && *swapchainImageCount > imageCapacity)
+		{
+			vkCmdInitTraceEnd(initStruct, trace);
+			initStruct->deviceTable.vkDestroySwapchainKHR(initStruct->device, swapchain, initStruct->allocationCallbacks);
+			*swapchainImageCount = 0;
+			return VK_NULL_HANDLE;
+		}
+		//realloc keeps the block when image count didn't change, which is the usual resize case
+		if (!imageCapacity)
+			*swapchainImages = (VkImage*)realloc(swapchainImagesAllocated ? *swapchainImages : NULL, sizeof(VkImage) * (*swapchainImageCount));
+		initStruct->deviceTable.vkGetSwapchainImagesKHR(initStruct->device, swapchain, swapchainImageCount, *swapchainImages);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		if (swapchainImageViews)
+		{
+			if (!imageCapacity)
+				*swapchainImageViews = (VkImageView*)realloc(swapchainImagesAllocated ? *swapchainImageViews : NULL, sizeof(VkImageView) * (*swapchainImageCount));
+			vkCmdInitCreateImageViews(initStruct, *swapchainImages, *swapchainImageCount, initStruct->swapchainFormat.format, *swapchainImageViews);
+		}
+
+		return swapchain;
+	}
+
+//PROVIDES UNIVERSAL, DEFAULT WAY OF CREATING A SWAPCHAIN
+//IF YOU NEED SOMETHING MORE CUSTOM, JUST WRITE YOUR OWN FUNCTION
+	VkSurfaceFormatKHR selectDefaultSurfaceFormat(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount)
+	{
+		for (size_t i = 0; i < surfaceFormatCount; ++i)
+		{
+			VkSurfaceFormatKHR format = surfaceFormats[i];
+			if (format.colorSpace == VK_COLORSPACE_SRGB_NONLINEAR_KHR /*preferred*/)
+			{
+				if (format.format == VK_FORMAT_B8G8R8A8_UNORM || format.format == VK_FORMAT_B8G8R8A8_SRGB || format.format == VK_FORMAT_B8G8R8A8_SNORM)
+					return format;
+			}
+		}
+		return surfaceFormats[0];
+	}
+
+	VkPresentModeKHR selectDefaultPresentMode(VkPresentModeKHR* presentModes, size_t presentModeCount)
+	{
+		for (size_t i = 0; i < presentModeCount; ++i)
+		{
+			VkPresentModeKHR mode = presentModes[i];
+			if (mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR || mode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+				; //ignore!
+			else
+			{
+				//MAILBOX or FIFO will do!
+				return mode;
+			}
+		}
+		return VK_PRESENT_MODE_FIFO_KHR; //always supported
+	}
+
+	//Format and present mode are chosen, only capabilities are left to query
+	static VkSwapchainKHR vkCmdInitCreateSwapchainWithFormat(InitializationStruct* initStruct, VkSurfaceFormatKHR surfaceFormat, VkPresentModeKHR presentMode, void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		VkSurfaceCapabilitiesKHR surfaceCapabilities;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(initStruct->physicalDevice, initStruct->surface, &surfaceCapabilities);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		//Remembered for recreateSwapchainKHR, format and present mode don't change on resize
+		initStruct->swapchainFormat = surfaceFormat;
+		initStruct->swapchainPresentMode = presentMode;
+		initStruct->swapchainSurfaceDesigner = surfaceDesigner;
+
+		VkExtent2D extent = { 0,0 };
+		uint32_t imageCount = 0;
+		surfaceDesigner(&surfaceCapabilities, &extent, &imageCount);
+
+		return vkCmdInitBuildSwapchain(initStruct, &surfaceCapabilities, extent, imageCount, VK_NULL_HANDLE, imageCapacity, swapchainImageCount, swapchainImages, false, swapchainImageViews);
+	}
+
+	static VkSwapchainKHR vkCmdInitCreateSwapchain(InitializationStruct* initStruct, VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount), VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount), void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		if (!(initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE))
+			return VK_NULL_HANDLE;
+
+		//Thanks vulkan-tutorial.com for that piece of code
+
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "createSwapchainKHR");
+
+		uint32_t surfaceFormatCount = 0;
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceSurfaceFormatsKHR");
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct->physicalDevice, initStruct->surface, &surfaceFormatCount, NULL);
+		ScratchMark scratch = scratchMark(initStruct);
+		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)scratchAllocate(initStruct, surfaceFormatCount * sizeof(VkSurfaceFormatKHR));
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct->physicalDevice, initStruct->surface, &surfaceFormatCount, surfaceFormats);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		uint32_t presentModeCount = 0;
+		trace = vkCmdInitTraceBegin(initStruct, "vkGetPhysicalDeviceSurfacePresentModesKHR");
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct->physicalDevice, initStruct->surface, &presentModeCount, NULL);
+		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)scratchAllocate(initStruct, presentModeCount * sizeof(VkPresentModeKHR));
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct->physicalDevice, initStruct->surface, &presentModeCount, presentModes);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		if (presentModeCount == 0 || surfaceFormatCount == 0)
+		{
+			scratchRewind(initStruct, scratch);
+			vkCmdInitTraceEnd(initStruct, stepTrace);
+			return VK_NULL_HANDLE;
+		}
+
+		VkSurfaceFormatKHR chosenFormat = surfaceFormatSelector ? surfaceFormatSelector(surfaceFormats, surfaceFormatCount) : selectDefaultSurfaceFormat(surfaceFormats, surfaceFormatCount);
+		VkPresentModeKHR chosenMode = presentModeSelector ? presentModeSelector(presentModes, presentModeCount) : selectDefaultPresentMode(presentModes, presentModeCount);
+		scratchRewind(initStruct, scratch);
+
+		VkSwapchainKHR swapchain = vkCmdInitCreateSwapchainWithFormat(initStruct, chosenFormat, chosenMode, surfaceDesigner, imageCapacity, swapchainImageCount, swapchainImages, swapchainImageViews);
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		return swapchain;
+	}
+
+	VkSwapchainKHR createSwapchainKHR(InitializationStruct* initStruct, /*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount), /*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount), /*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		return vkCmdInitCreateSwapchain(initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, 0, swapchainImageCount, swapchainImages, swapchainImageViews);
+	}
+
+	VkSwapchainKHR createSwapchainKHRWithFormat(InitializationStruct* initStruct, VkSurfaceFormatKHR surfaceFormat, VkPresentModeKHR presentMode, /*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		if (!(initStruct->instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE))
+			return VK_NULL_HANDLE;
+
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "createSwapchainKHR");
+		VkSwapchainKHR swapchain = vkCmdInitCreateSwapchainWithFormat(initStruct, surfaceFormat, presentMode, surfaceDesigner, 0, swapchainImageCount, swapchainImages, swapchainImageViews);
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		return swapchain;
+	}
+
+	VkSwapchainKHR createSwapchainKHRInPlace(InitializationStruct* initStruct, /*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount), /*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount), /*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount), uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage* swapchainImages, /*can be null*/ VkImageView* swapchainImageViews)
+	{
+		*swapchainImageCount = 0;
+		if (imageCapacity == 0)
+			return VK_NULL_HANDLE;
+		return vkCmdInitCreateSwapchain(initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, imageCapacity, swapchainImageCount, &swapchainImages, swapchainImageViews ? &swapchainImageViews : NULL);
+	}
+
+	//Defined next to enqueueSubmit below
+	static bool vkCmdInitReserve(const InitializationStruct* initStruct, void** data, uint32_t* capacity, uint32_t required, size_t elementSize, VkSystemAllocationScope scope);
+
+	static VkSwapchainKHR vkCmdInitRecreateSwapchain(InitializationStruct* initStruct, VkSwapchainKHR oldSwapchain, uint64_t retireAfterFrame, uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		if (!initStruct->swapchainSurfaceDesigner)
+			return VK_NULL_HANDLE;
+
+		//Only capabilities change on resize, formats and present modes aren't queried again
+		VkSurfaceCapabilitiesKHR surfaceCapabilities;
+		initStruct->instanceTable.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(initStruct->physicalDevice, initStruct->surface, &surfaceCapabilities);
+
+		VkExtent2D extent = { 0,0 };
+		uint32_t imageCount = 0;
+		initStruct->swapchainSurfaceDesigner(&surfaceCapabilities, &extent, &imageCount);
+
+		//Minimized window, keep presenting to nothing with old swapchain until it has size again
+		if (extent.width == 0 || extent.height == 0)
+			return VK_NULL_HANDLE;
+
+		//Old swapchain is retired by the create call even if it fails, so it's queued for destruction first. Without room to
+		//queue it, recreate fails and old swapchain stays usable. List only grows and views usually fit inline, so steady
+		//resizing doesn't allocate
+		if (!vkCmdInitReserve(initStruct, (void**)&initStruct->retiredSwapchains, &initStruct->retiredSwapchainCapacity, initStruct->retiredSwapchainCount + 1, sizeof(RetiredSwapchain), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE))
+			return VK_NULL_HANDLE;
+
+		uint32_t imageViewCount = swapchainImageViews ? *swapchainImageCount : 0;
+		VkImageView* imageViews = NULL;
+		if (imageViewCount > VKCMDINIT_MAX_SWAPCHAIN_IMAGES)
+		{
+			imageViews = (VkImageView*)vkCmdInitHostAllocate(initStruct, sizeof(VkImageView) * imageViewCount, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+			if (!imageViews)
+				return VK_NULL_HANDLE;
+			memcpy(imageViews, *swapchainImageViews, sizeof(VkImageView) * imageViewCount);
+		}
+
+		RetiredSwapchain* retired = &initStruct->retiredSwapchains[initStruct->retiredSwapchainCount++];
+		retired->swapchain = oldSwapchain;
+		retired->imageViewCount = imageViewCount;
+		retired->imageViews = imageViews;
+		retired->retireAfterFrame = retireAfterFrame;
+		if (!imageViews && imageViewCount)
+			memcpy(retired->inlineImageViews, *swapchainImageViews, sizeof(VkImageView) * imageViewCount);
+
+		return vkCmdInitBuildSwapchain(initStruct, &surfaceCapabilities, extent, imageCount, oldSwapchain, imageCapacity, swapchainImageCount, swapchainImages, true, swapchainImageViews);
+	}
+
+	VkSwapchainKHR recreateSwapchainKHR(InitializationStruct* initStruct, VkSwapchainKHR oldSwapchain, uint64_t retireAfterFrame, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		return vkCmdInitRecreateSwapchain(initStruct, oldSwapchain, retireAfterFrame, 0, swapchainImageCount, swapchainImages, swapchainImageViews);
+	}
+
+	VkSwapchainKHR recreateSwapchainKHRInPlace(InitializationStruct* initStruct, VkSwapchainKHR oldSwapchain, uint64_t retireAfterFrame, uint32_t imageCapacity, uint32_t* swapchainImageCount, VkImage* swapchainImages, /*can be null*/ VkImageView* swapchainImageViews)
+	{
+		if (imageCapacity == 0)
+			return VK_NULL_HANDLE;
+		return vkCmdInitRecreateSwapchain(initStruct, oldSwapchain, retireAfterFrame, imageCapacity, swapchainImageCount, &swapchainImages, swapchainImageViews ? &swapchainImageViews : NULL);
+	}
+
+	void collectRetiredSwapchains(InitializationStruct* initStruct, uint64_t completedFrame)
+	{
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < initStruct->retiredSwapchainCount; ++i)
+		{
+			RetiredSwapchain* retired = &initStruct->retiredSwapchains[i];
+			if (retired->retireAfterFrame > completedFrame)
+			{
+				initStruct->retiredSwapchains[kept++] = *retired;
+				continue;
+			}
+
+			const VkImageView* imageViews = retired->imageViews ? retired->imageViews : retired->inlineImageViews;
+			for (uint32_t j = 0; j < retired->imageViewCount; ++j)
+				initStruct->deviceTable.vkDestroyImageView(initStruct->device, imageViews[j], initStruct->allocationCallbacks);
+			vkCmdInitHostFree(initStruct, retired->imageViews);
+			initStruct->deviceTable.vkDestroySwapchainKHR(initStruct->device, retired->swapchain, initStruct->allocationCallbacks);
+		}
+		initStruct->retiredSwapchainCount = kept;
+	}
+
+	OffscreenSwapchain* createOffscreenSwapchain(InitializationStruct* initStruct, VkFormat format, VkExtent2D extent, uint32_t imageCount, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		//acquireOffscreenImage hands images out modulo count
+		if (!imageCount)
+			return NULL;
+
+		OffscreenSwapchain* offscreenSwapchain = (OffscreenSwapchain*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(OffscreenSwapchain), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!offscreenSwapchain)
+			return NULL;
+		offscreenSwapchain->images = (VkImage*)vkCmdInitHostAllocateZeroed(initStruct, imageCount, sizeof(VkImage), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!offscreenSwapchain->images)
+		{
+			vkCmdInitHostFree(initStruct, offscreenSwapchain);
+			return NULL;
+		}
+		offscreenSwapchain->imageCount = imageCount;
+		offscreenSwapchain->format = format;
+		offscreenSwapchain->extent = extent;
+
+		VkImageCreateInfo imageCreateInfo = { ZERO };
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = format;
+		imageCreateInfo.extent.width = extent.width;
+		imageCreateInfo.extent.height = extent.height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		//Transfer source so frames can be read back or blitted, same as what swapchains usually support
+		imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		//Every image has identical requirements, so one allocation with aligned slots backs the whole ring
+		VkMemoryRequirements memoryRequirements = { ZERO };
+		bool created = true;
+		for (uint32_t i = 0; i < imageCount && created; ++i)
+		{
+			created = initStruct->deviceTable.vkCreateImage(initStruct->device, &imageCreateInfo, initStruct->allocationCallbacks, &offscreenSwapchain->images[i]) == VK_SUCCESS;
+			if (created && i == 0)
+				initStruct->deviceTable.vkGetImageMemoryRequirements(initStruct->device, offscreenSwapchain->images[0], &memoryRequirements);
+		}
+
+		VkDeviceSize slotSize = (memoryRequirements.size + memoryRequirements.alignment - 1) & ~(memoryRequirements.alignment - 1);
+		uint32_t memoryType = created ? vkCmdInitFindMemoryType(initStruct, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) : UINT32_MAX;
+		//Software implementations may not report device local memory at all
+		if (created && memoryType == UINT32_MAX)
+			memoryType = vkCmdInitFindMemoryType(initStruct, memoryRequirements.memoryTypeBits, 0);
+
+		if (memoryType != UINT32_MAX)
+		{
+			VkMemoryAllocateInfo memoryAllocateInfo = { ZERO };
+			memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			memoryAllocateInfo.allocationSize = slotSize * imageCount;
+			memoryAllocateInfo.memoryTypeIndex = memoryType;
+			created = initStruct->deviceTable.vkAllocateMemory(initStruct->device, &memoryAllocateInfo, initStruct->allocationCallbacks, &offscreenSwapchain->memory) == VK_SUCCESS;
+		}
+		else
+			created = false;
+
+		for (uint32_t i = 0; i < imageCount && created; ++i)
+			created = initStruct->deviceTable.vkBindImageMemory(initStruct->device, offscreenSwapchain->images[i], offscreenSwapchain->memory, slotSize * i) == VK_SUCCESS;
+
+		if (!created)
+		{
+			destroyOffscreenSwapchain(initStruct, offscreenSwapchain);
+			return NULL;
+		}
+
+		//Output arrays are app's, freed with free() like the ones createSwapchainKHR returns
+		VkImage* images = (VkImage*)malloc(sizeof(VkImage) * imageCount);
+		VkImageView* imageViews = swapchainImageViews ? (VkImageView*)malloc(sizeof(VkImageView) * imageCount) : NULL;
+		if (!images || (swapchainImageViews && !imageViews))
+		{
+			free(images);
+			free(imageViews);
+			destroyOffscreenSwapchain(initStruct, offscreenSwapchain);
+			return NULL;
+		}
+
+		*swapchainImageCount = imageCount;
+		*swapchainImages = images;
+		memcpy(*swapchainImages, offscreenSwapchain->images, sizeof(VkImage) * imageCount);
+
+		if (swapchainImageViews)
+		{
+			*swapchainImageViews = imageViews;
+			vkCmdInitCreateImageViews(initStruct, *swapchainImages, imageCount, format, *swapchainImageViews);
+		}
+
+		return offscreenSwapchain;
+	}
+
+	VkResult acquireOffscreenImage(InitializationStruct* initStruct, OffscreenSwapchain* offscreenSwapchain, VkQueue queue, VkSemaphore semaphore, VkFence fence, uint32_t* imageIndex)
+	{
+		*imageIndex = offscreenSwapchain->nextImage;
+		offscreenSwapchain->nextImage = (offscreenSwapchain->nextImage + 1) % offscreenSwapchain->imageCount;
+
+		if (!semaphore && !fence)
+			return VK_SUCCESS;
+
+		//Image is free as soon as previous work on it is ordered before, queue order takes care of that
+		VkSubmitInfo submitInfo = { ZERO };
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.signalSemaphoreCount = semaphore ? 1 : 0;
+		submitInfo.pSignalSemaphores = &semaphore;
+		return initStruct->deviceTable.vkQueueSubmit(queue, 1, &submitInfo, fence);
+	}
+
+	VkResult presentOffscreenImage(InitializationStruct* initStruct, OffscreenSwapchain* offscreenSwapchain, VkQueue queue, uint32_t waitSemaphoreCount, const VkSemaphore* waitSemaphores, uint32_t imageIndex)
+	{
+		if (imageIndex >= offscreenSwapchain->imageCount)
+			return VK_ERROR_OUT_OF_DATE_KHR;
+
+		if (!waitSemaphoreCount)
+			return VK_SUCCESS;
+
+		VkPipelineStageFlags waitStages[8];
+		uint32_t batchSize = sizeof(waitStages) / sizeof(waitStages[0]);
+		for (uint32_t i = 0; i < batchSize; ++i)
+			waitStages[i] = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		VkResult result = VK_SUCCESS;
+		for (uint32_t first = 0; first < waitSemaphoreCount && result == VK_SUCCESS; first += batchSize)
+		{
+			VkSubmitInfo submitInfo = { ZERO };
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.waitSemaphoreCount = (waitSemaphoreCount - first < batchSize) ? waitSemaphoreCount - first : batchSize;
+			submitInfo.pWaitSemaphores = waitSemaphores + first;
+			submitInfo.pWaitDstStageMask = waitStages;
+			result = initStruct->deviceTable.vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+		}
+		return result;
+	}
+
+	void destroyOffscreenSwapchain(InitializationStruct* initStruct, OffscreenSwapchain* offscreenSwapchain)
+	{
+		for (uint32_t i = 0; i < offscreenSwapchain->imageCount; ++i)
+		{
+			if (offscreenSwapchain->images[i])
+				initStruct->deviceTable.vkDestroyImage(initStruct->device, offscreenSwapchain->images[i], initStruct->allocationCallbacks);
+		}
+
+		if (offscreenSwapchain->memory)
+			initStruct->deviceTable.vkFreeMemory(initStruct->device, offscreenSwapchain->memory, initStruct->allocationCallbacks);
+
+		vkCmdInitHostFree(initStruct, offscreenSwapchain->images);
+		vkCmdInitHostFree(initStruct, offscreenSwapchain);
+	}
+
+
+	//Grows per-image semaphore array, old semaphores are kept because presentation may still wait on them
+	static VkResult vkCmdInitReserveRenderCompleteSemaphores(InitializationStruct* initStruct, FrameContext* frameContext, uint32_t imageCount)
+	{
+		if (imageCount <= frameContext->renderCompleteSemaphoreCount)
+			return VK_SUCCESS;
+
+		VkSemaphore* renderCompleteSemaphores = (VkSemaphore*)vkCmdInitHostReallocate(initStruct, frameContext->renderCompleteSemaphores, sizeof(VkSemaphore) * imageCount, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!renderCompleteSemaphores)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		frameContext->renderCompleteSemaphores = renderCompleteSemaphores;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = { ZERO };
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		VkResult result = VK_SUCCESS;
+		for (uint32_t i = frameContext->renderCompleteSemaphoreCount; i < imageCount && result == VK_SUCCESS; ++i)
+		{
+			result = initStruct->deviceTable.vkCreateSemaphore(initStruct->device, &semaphoreCreateInfo, initStruct->allocationCallbacks, &frameContext->renderCompleteSemaphores[i]);
+			if (result == VK_SUCCESS)
+				frameContext->renderCompleteSemaphoreCount += 1;
+		}
+		return result;
+	}
+
+	FrameContext* createFrameContext(InitializationStruct* initStruct, const DefaultQueueRetrieveStruct* queues, uint32_t framesInFlight, VkSwapchainKHR swapchain, /*can be null*/ OffscreenSwapchain* offscreenSwapchain, uint32_t swapchainImageCount)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return NULL;
+
+		FrameContext* frameContext = (FrameContext*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(FrameContext), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!frameContext)
+			return NULL;
+		frameContext->frames = (FrameData*)vkCmdInitHostAllocateZeroed(initStruct, framesInFlight ? framesInFlight : 1, sizeof(FrameData), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!frameContext->frames)
+		{
+			vkCmdInitHostFree(initStruct, frameContext);
+			return NULL;
+		}
+		frameContext->framesInFlight = framesInFlight ? framesInFlight : 1;
+		frameContext->graphicsQueue = queues->graphicsQueue;
+		frameContext->presentationQueue = queues->presentationQueue ? queues->presentationQueue : queues->graphicsQueue;
+		frameContext->swapchain = swapchain;
+		frameContext->offscreenSwapchain = swapchain ? NULL : offscreenSwapchain;
+
+		VkCommandPoolCreateInfo commandPoolCreateInfo = { ZERO };
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		//Buffers live for one frame and are never reset one by one
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = initStruct->defaultQueueIndices->graphicQueueIndex;
+
+		VkFenceCreateInfo fenceCreateInfo = { ZERO };
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		//Signaled, so the first beginFrame on each slot doesn't wait forever
+		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = { ZERO };
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		VkResult result = VK_SUCCESS;
+		for (uint32_t i = 0; i < frameContext->framesInFlight && result == VK_SUCCESS; ++i)
+		{
+			FrameData* frame = &frameContext->frames[i];
+			result = initStruct->deviceTable.vkCreateCommandPool(initStruct->device, &commandPoolCreateInfo, initStruct->allocationCallbacks, &frame->commandPool);
+			if (result != VK_SUCCESS)
+				break;
+
+			VkCommandBufferAllocateInfo commandBufferAllocateInfo = { ZERO };
+			commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			commandBufferAllocateInfo.commandPool = frame->commandPool;
+			commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			commandBufferAllocateInfo.commandBufferCount = 1;
+			result = initStruct->deviceTable.vkAllocateCommandBuffers(initStruct->device, &commandBufferAllocateInfo, &frame->commandBuffer);
+
+			if (result == VK_SUCCESS)
+				result = initStruct->deviceTable.vkCreateFence(initStruct->device, &fenceCreateInfo, initStruct->allocationCallbacks, &frame->inFlightFence);
+			if (result == VK_SUCCESS && frameContext->swapchain)
+				result = initStruct->deviceTable.vkCreateSemaphore(initStruct->device, &semaphoreCreateInfo, initStruct->allocationCallbacks, &frame->imageAcquiredSemaphore);
+		}
+
+		//Offscreen images are ordered by queue submission alone, semaphores would only cost extra submits
+		if (result == VK_SUCCESS && frameContext->swapchain)
+			result = vkCmdInitReserveRenderCompleteSemaphores(initStruct, frameContext, swapchainImageCount);
+
+		if (result != VK_SUCCESS)
+		{
+			destroyFrameContext(initStruct, frameContext);
+			return NULL;
+		}
+
+		return frameContext;
+	}
+
+	VkResult beginFrame(InitializationStruct* initStruct, FrameContext* frameContext, VkCommandBuffer* commandBuffer, uint32_t* imageIndex)
+	{
+		frameContext->frameIndex = (uint32_t)(frameContext->frameNumber % frameContext->framesInFlight);
+		FrameData* frame = &frameContext->frames[frameContext->frameIndex];
+
+		VkResult result = initStruct->deviceTable.vkWaitForFences(initStruct->device, 1, &frame->inFlightFence, VK_TRUE, UINT64_MAX);
+		if (result != VK_SUCCESS)
+			return result;
+
+		//Frame that used this slot before is done, so is everything submitted before it
+		if (frameContext->frameNumber >= frameContext->framesInFlight)
+			collectRetiredSwapchains(initStruct, frameContext->frameNumber - frameContext->framesInFlight);
+
+		if (frameContext->swapchain)
+			result = initStruct->deviceTable.vkAcquireNextImageKHR(initStruct->device, frameContext->swapchain, UINT64_MAX, frame->imageAcquiredSemaphore, VK_NULL_HANDLE, &frameContext->imageIndex);
+		else
+			result = acquireOffscreenImage(initStruct, frameContext->offscreenSwapchain, frameContext->graphicsQueue, VK_NULL_HANDLE, VK_NULL_HANDLE, &frameContext->imageIndex);
+
+		//Suboptimal image is still acquired and semaphore will be signaled, so frame goes on
+		if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+			return result;
+
+		//Fence is reset only once there's guaranteed submit that signals it again, otherwise early return above would deadlock next beginFrame
+		initStruct->deviceTable.vkResetFences(initStruct->device, 1, &frame->inFlightFence);
+		initStruct->deviceTable.vkResetCommandPool(initStruct->device, frame->commandPool, 0);
+
+		VkCommandBufferBeginInfo commandBufferBeginInfo = { ZERO };
+		commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		initStruct->deviceTable.vkBeginCommandBuffer(frame->commandBuffer, &commandBufferBeginInfo);
+
+		*commandBuffer = frame->commandBuffer;
+		*imageIndex = frameContext->imageIndex;
+		return VK_SUCCESS;
+	}
+
+	VkResult endFrame(InitializationStruct* initStruct, FrameContext* frameContext)
+	{
+		FrameData* frame = &frameContext->frames[frameContext->frameIndex];
+		initStruct->deviceTable.vkEndCommandBuffer(frame->commandBuffer);
+
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		VkSemaphore renderCompleteSemaphore = frameContext->swapchain ? frameContext->renderCompleteSemaphores[frameContext->imageIndex] : VK_NULL_HANDLE;
+
+		VkSubmitInfo submitInfo = { ZERO };
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &frame->commandBuffer;
+		if (frameContext->swapchain)
+		{
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &frame->imageAcquiredSemaphore;
+			submitInfo.pWaitDstStageMask = &waitStage;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &renderCompleteSemaphore;
+		}
+
+		VkResult result = initStruct->deviceTable.vkQueueSubmit(frameContext->graphicsQueue, 1, &submitInfo, frame->inFlightFence);
+		if (result != VK_SUCCESS)
+		{
+			//beginFrame reset the fence already, signal it with empty submit (consuming acquire semaphore) so the slot can be reused
+			submitInfo.commandBufferCount = 0;
+			submitInfo.signalSemaphoreCount = 0;
+			initStruct->deviceTable.vkQueueSubmit(frameContext->graphicsQueue, 1, &submitInfo, frame->inFlightFence);
+			return result;
+		}
+		frameContext->frameNumber += 1;
+
+		if (!frameContext->swapchain)
+			return presentOffscreenImage(initStruct, frameContext->offscreenSwapchain, frameContext->presentationQueue, 0, NULL, frameContext->imageIndex);
+
+		VkPresentInfoKHR presentInfo = { ZERO };
+		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		presentInfo.waitSemaphoreCount = 1;
+		presentInfo.pWaitSemaphores = &renderCompleteSemaphore;
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = &frameContext->swapchain;
+		presentInfo.pImageIndices = &frameContext->imageIndex;
+		return initStruct->deviceTable.vkQueuePresentKHR(frameContext->presentationQueue, &presentInfo);
+	}
+
+	VkResult recreateFrameSwapchain(InitializationStruct* initStruct, FrameContext* frameContext, uint32_t* swapchainImageCount, VkImage** swapchainImages, /*can be null*/ VkImageView** swapchainImageViews)
+	{
+		//Frames begun so far may still use old swapchain, the next one won't
+		VkSwapchainKHR swapchain = recreateSwapchainKHR(initStruct, frameContext->swapchain, frameContext->frameNumber, swapchainImageCount, swapchainImages, swapchainImageViews);
+		if (!swapchain)
+			return VK_ERROR_OUT_OF_DATE_KHR;
+
+		frameContext->swapchain = swapchain;
+		return vkCmdInitReserveRenderCompleteSemaphores(initStruct, frameContext, *swapchainImageCount);
+	}
+
+	void destroyFrameContext(InitializationStruct* initStruct, FrameContext* frameContext)
+	{
+		for (uint32_t i = 0; i < frameContext->framesInFlight; ++i)
+		{
+			FrameData* frame = &frameContext->frames[i];
+			if (frame->inFlightFence)
+			{
+				initStruct->deviceTable.vkWaitForFences(initStruct->device, 1, &frame->inFlightFence, VK_TRUE, UINT64_MAX);
+				initStruct->deviceTable.vkDestroyFence(initStruct->device, frame->inFlightFence, initStruct->allocationCallbacks);
+			}
+			if (frame->imageAcquiredSemaphore)
+				initStruct->deviceTable.vkDestroySemaphore(initStruct->device, frame->imageAcquiredSemaphore, initStruct->allocationCallbacks);
+			if (frame->commandPool)
+				initStruct->deviceTable.vkDestroyCommandPool(initStruct->device, frame->commandPool, initStruct->allocationCallbacks);
+		}
+
+		//Present engine doesn't signal fences, queue has to drain before semaphores it waits on are destroyed
+		if (frameContext->renderCompleteSemaphoreCount)
+			initStruct->deviceTable.vkQueueWaitIdle(frameContext->presentationQueue);
+
+		for (uint32_t i = 0; i < frameContext->renderCompleteSemaphoreCount; ++i)
+			initStruct->deviceTable.vkDestroySemaphore(initStruct->device, frameContext->renderCompleteSemaphores[i], initStruct->allocationCallbacks);
+
+		vkCmdInitHostFree(initStruct, frameContext->renderCompleteSemaphores);
+		vkCmdInitHostFree(initStruct, frameContext->frames);
+		vkCmdInitHostFree(initStruct, frameContext);
+	}
+
+	//Grows array to hold at least required elements, capacity doubles so enqueueSubmit is amortized O(1).
+	//Memory comes from host callbacks, free it with vkCmdInitHostFree
+	static bool vkCmdInitReserve(const InitializationStruct* initStruct, void** data, uint32_t* capacity, uint32_t required, size_t elementSize, VkSystemAllocationScope scope)
+	{
+		if (required <= *capacity)
+			return true;
+
+		uint32_t newCapacity = *capacity ? *capacity * 2 : 16;
+		while (newCapacity < required)
+			newCapacity *= 2;
+
+		void* newData = vkCmdInitHostReallocate(initStruct, *data, newCapacity * elementSize, scope);
+		if (!newData)
+			return false;
+
+		*data = newData;
+		*capacity = newCapacity;
+		return true;
+	}
+
+	TimelineQueue* createTimelineQueue(InitializationStruct* initStruct, VkQueue queue)
+	{
+		VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = { ZERO };
+		semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		semaphoreTypeCreateInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = { ZERO };
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+		VkSemaphore timeline = VK_NULL_HANDLE;
+		if (initStruct->deviceTable.vkCreateSemaphore(initStruct->device, &semaphoreCreateInfo, initStruct->allocationCallbacks, &timeline) != VK_SUCCESS)
+			return NULL;
+
+		TimelineQueue* timelineQueue = (TimelineQueue*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(TimelineQueue), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!timelineQueue)
+		{
+			initStruct->deviceTable.vkDestroySemaphore(initStruct->device, timeline, initStruct->allocationCallbacks);
+			return NULL;
+		}
+
+		timelineQueue->initStruct = initStruct;
+		timelineQueue->queue = queue;
+		timelineQueue->timeline = timeline;
+		return timelineQueue;
+	}
+
+	TimelineWait timelinePoint(const TimelineQueue* timelineQueue, uint64_t value, VkPipelineStageFlags stageMask)
+	{
+		TimelineWait wait;
+		wait.semaphore = timelineQueue->timeline;
+		wait.value = value;
+		wait.stageMask = stageMask;
+		return wait;
+	}
+
+	uint64_t enqueueSubmit(TimelineQueue* timelineQueue, const VkCommandBuffer* commandBuffers, uint32_t commandBufferCount, /*can be null*/ const TimelineWait* waits, uint32_t waitCount, /*can be VK_NULL_HANDLE, ex. semaphore presentation waits on*/ VkSemaphore binarySignalSemaphore)
+	{
+		const InitializationStruct* initStruct = timelineQueue->initStruct;
+		if (!vkCmdInitReserve(initStruct, (void**)&timelineQueue->pendingSubmits, &timelineQueue->pendingSubmitCapacity, timelineQueue->pendingSubmitCount + 1, sizeof(TimelinePendingSubmit), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) ||
+			!vkCmdInitReserve(initStruct, (void**)&timelineQueue->pendingCommandBuffers, &timelineQueue->pendingCommandBufferCapacity, timelineQueue->pendingCommandBufferCount + commandBufferCount, sizeof(VkCommandBuffer), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) ||
+			!vkCmdInitReserve(initStruct, (void**)&timelineQueue->pendingWaits, &timelineQueue->pendingWaitCapacity, timelineQueue->pendingWaitCount + waitCount, sizeof(TimelineWait), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return 0;
+
+		TimelinePendingSubmit* submit = &timelineQueue->pendingSubmits[timelineQueue->pendingSubmitCount++];
+		submit->firstCommandBuffer = timelineQueue->pendingCommandBufferCount;
+		submit->commandBufferCount = commandBufferCount;
+		submit->firstWait = timelineQueue->pendingWaitCount;
+		submit->waitCount = waitCount;
+		submit->signalValue = ++timelineQueue->enqueuedValue;
+		submit->binarySignalSemaphore = binarySignalSemaphore;
+
+		if (commandBufferCount)
+			memcpy(timelineQueue->pendingCommandBuffers + timelineQueue->pendingCommandBufferCount, commandBuffers, sizeof(VkCommandBuffer) * commandBufferCount);
+		if (waitCount)
+			memcpy(timelineQueue->pendingWaits + timelineQueue->pendingWaitCount, waits, sizeof(TimelineWait) * waitCount);
+		timelineQueue->pendingCommandBufferCount += commandBufferCount;
+		timelineQueue->pendingWaitCount += waitCount;
+
+		return submit->signalValue;
+	}
+
+	VkResult flushTimelineQueue(InitializationStruct* initStruct, TimelineQueue* timelineQueue, /*can be VK_NULL_HANDLE*/ VkFence fence)
+	{
+		uint32_t submitCount = timelineQueue->pendingSubmitCount;
+		uint32_t waitCount = timelineQueue->pendingWaitCount;
+		if (!submitCount)
+		{
+			if (fence)
+				return initStruct->deviceTable.vkQueueSubmit(timelineQueue->queue, 0, NULL, fence);
+			return VK_SUCCESS;
+		}
+
+		//One block for everything vkQueueSubmit reads, arrays of TimelineQueue can't be used as they're interleaved per submit.
+		//Kept between flushes so steady state submission doesn't allocate
+		size_t size = (sizeof(VkSubmitInfo) + sizeof(VkTimelineSemaphoreSubmitInfo) + (sizeof(VkSemaphore) + sizeof(uint64_t)) * 2) * submitCount +
+			(sizeof(VkSemaphore) + sizeof(uint64_t) + sizeof(VkPipelineStageFlags)) * waitCount;
+		if (size > UINT32_MAX || !vkCmdInitReserve(initStruct, (void**)&timelineQueue->submitBlock, &timelineQueue->submitBlockCapacity, (uint32_t)size, 1, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		char* block = timelineQueue->submitBlock;
+
+		VkSubmitInfo* submitInfos = (VkSubmitInfo*)block;
+		VkTimelineSemaphoreSubmitInfo* timelineInfos = (VkTimelineSemaphoreSubmitInfo*)(submitInfos + submitCount);
+		uint64_t* signalValues = (uint64_t*)(timelineInfos + submitCount);
+		uint64_t* waitValues = signalValues + submitCount * 2;
+		VkSemaphore* signalSemaphores = (VkSemaphore*)(waitValues + waitCount);
+		VkSemaphore* waitSemaphores = signalSemaphores + submitCount * 2;
+		VkPipelineStageFlags* waitStages = (VkPipelineStageFlags*)(waitSemaphores + waitCount);
+
+		for (uint32_t i = 0; i < waitCount; ++i)
+		{
+			waitSemaphores[i] = timelineQueue->pendingWaits[i].semaphore;
+			waitValues[i] = timelineQueue->pendingWaits[i].value;
+			waitStages[i] = timelineQueue->pendingWaits[i].stageMask;
+		}
+
+		for (uint32_t i = 0; i < submitCount; ++i)
+		{
+			const TimelinePendingSubmit* submit = &timelineQueue->pendingSubmits[i];
+			uint32_t signalCount = submit->binarySignalSemaphore ? 2 : 1;
+			signalSemaphores[i * 2] = timelineQueue->timeline;
+			signalSemaphores[i * 2 + 1] = submit->binarySignalSemaphore;
+			signalValues[i * 2] = submit->signalValue;
+			signalValues[i * 2 + 1] = 0;
+
+			VkTimelineSemaphoreSubmitInfo timelineInfo = { ZERO };
+			timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+			timelineInfo.waitSemaphoreValueCount = submit->waitCount;
+			timelineInfo.pWaitSemaphoreValues = waitValues + submit->firstWait;
+			timelineInfo.signalSemaphoreValueCount = signalCount;
+			timelineInfo.pSignalSemaphoreValues = signalValues + i * 2;
+			timelineInfos[i] = timelineInfo;
+
+			VkSubmitInfo submitInfo = { ZERO };
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.pNext = &timelineInfos[i];
+			submitInfo.waitSemaphoreCount = submit->waitCount;
+			submitInfo.pWaitSemaphores = waitSemaphores + submit->firstWait;
+			submitInfo.pWaitDstStageMask = waitStages + submit->firstWait;
+			submitInfo.commandBufferCount = submit->commandBufferCount;
+			submitInfo.pCommandBuffers = timelineQueue->pendingCommandBuffers + submit->firstCommandBuffer;
+			submitInfo.signalSemaphoreCount = signalCount;
+			submitInfo.pSignalSemaphores = signalSemaphores + i * 2;
+			submitInfos[i] = submitInfo;
+		}
+
+		VkResult result = initStruct->deviceTable.vkQueueSubmit(timelineQueue->queue, submitCount, submitInfos, fence);
+
+		//On failure submissions stay pending, caller decides whether to retry or tear down
+		if (result == VK_SUCCESS)
+		{
+			timelineQueue->submittedValue = timelineQueue->pendingSubmits[submitCount - 1].signalValue;
+			timelineQueue->pendingSubmitCount = 0;
+			timelineQueue->pendingCommandBufferCount = 0;
+			timelineQueue->pendingWaitCount = 0;
+		}
+		return result;
+	}
+
+	bool isTimelinePointReached(InitializationStruct* initStruct, TimelineQueue* timelineQueue, uint64_t value)
+	{
+		if (value <= timelineQueue->completedValue)
+			return true;
+		if (value > timelineQueue->submittedValue)
+			return false;
+
+		uint64_t counter = 0;
+		if (initStruct->deviceTable.vkGetSemaphoreCounterValue(initStruct->device, timelineQueue->timeline, &counter) == VK_SUCCESS && counter > timelineQueue->completedValue)
+			timelineQueue->completedValue = counter;
+		return value <= timelineQueue->completedValue;
+	}
+
+	VkResult waitTimelinePoint(InitializationStruct* initStruct, TimelineQueue* timelineQueue, uint64_t value, uint64_t timeout)
+	{
+		if (value <= timelineQueue->completedValue)
+			return VK_SUCCESS;
+		if (value > timelineQueue->enqueuedValue)
+			return VK_NOT_READY;
+
+		VkResult result = VK_SUCCESS;
+		if (value > timelineQueue->submittedValue)
+			result = flushTimelineQueue(initStruct, timelineQueue, VK_NULL_HANDLE);
+		if (result != VK_SUCCESS)
+			return result;
+
+		VkSemaphoreWaitInfo waitInfo = { ZERO };
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &timelineQueue->timeline;
+		waitInfo.pValues = &value;
+		result = initStruct->deviceTable.vkWaitSemaphores(initStruct->device, &waitInfo, timeout);
+		if (result == VK_SUCCESS)
+			timelineQueue->completedValue = value;
+		return result;
+	}
+
+	void destroyTimelineQueue(InitializationStruct* initStruct, TimelineQueue* timelineQueue)
+	{
+		flushTimelineQueue(initStruct, timelineQueue, VK_NULL_HANDLE);
+		if (timelineQueue->submittedValue)
+			waitTimelinePoint(initStruct, timelineQueue, timelineQueue->submittedValue, UINT64_MAX);
+
+		initStruct->deviceTable.vkDestroySemaphore(initStruct->device, timelineQueue->timeline, initStruct->allocationCallbacks);
+		vkCmdInitHostFree(initStruct, timelineQueue->pendingSubmits);
+		vkCmdInitHostFree(initStruct, timelineQueue->pendingCommandBuffers);
+		vkCmdInitHostFree(initStruct, timelineQueue->pendingWaits);
+		vkCmdInitHostFree(initStruct, timelineQueue->submitBlock);
+		vkCmdInitHostFree(initStruct, timelineQueue);
+	}
+
+	static uint32_t vkCmdInitMsb(uint64_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63u - (uint32_t)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (uint32_t)index;
+#else
+		uint32_t index = 0;
+		while (value >>= 1)
+			++index;
+		return index;
+#endif
+	}
+
+	static uint32_t vkCmdInitLsb(uint64_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return (uint32_t)__builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (uint32_t)index;
+#else
+		uint32_t index = 0;
+		while (!(value & 1))
+		{
+			value >>= 1;
+			++index;
+		}
+		return index;
+#endif
+	}
+
+//Two level segregated fit (TLSF): first level is power of two of the size, second level splits it linearly into 16 lists.
+//Finding a fitting free range is two bitmap scans, free ranges are merged with physical neighbours immediately.
+//Nodes live in a CPU-side array, device memory is never touched
+#define VKCMDINIT_TLSF_MIN_LOG2 8
+#define VKCMDINIT_TLSF_MIN_SIZE (1ull << VKCMDINIT_TLSF_MIN_LOG2)
+#define VKCMDINIT_TLSF_SL_LOG2 4
+#define VKCMDINIT_TLSF_SL_COUNT (1u << VKCMDINIT_TLSF_SL_LOG2)
+#define VKCMDINIT_TLSF_FL_COUNT (64 - VKCMDINIT_TLSF_MIN_LOG2)
+#define VKCMDINIT_NULL_NODE UINT32_MAX
+#define VKCMDINIT_DEFAULT_MEMORY_BLOCK_SIZE (64ull * 1024 * 1024)
+
+	typedef struct VkCmdInitTlsfNode
+	{
+		VkDeviceSize offset;
+		VkDeviceSize size;
+		uint32_t prevPhysical;
+		uint32_t nextPhysical;
+		uint32_t prevFree;
+		uint32_t nextFree; //also links unused nodes
+		bool free;
+	} VkCmdInitTlsfNode;
+
+	struct GpuMemoryBlock
+	{
+		VkDeviceMemory memory;
+		VkDeviceSize size;
+		void* mappedData;
+		uint32_t memoryTypeIndex;
+		bool linear;
+		uint32_t allocationCount;
+		VkDeviceSize usedBytes;
+
+		uint64_t flBitmap;
+		uint32_t slBitmap[VKCMDINIT_TLSF_FL_COUNT];
+		uint32_t freeHeads[VKCMDINIT_TLSF_FL_COUNT][VKCMDINIT_TLSF_SL_COUNT];
+
+		//Node 0 always starts at offset 0, merging keeps the lower node
+		VkCmdInitTlsfNode* nodes;
+		uint32_t nodeCount;
+		uint32_t nodeCapacity;
+		uint32_t unusedNode;
+	};
+
+	typedef struct VkCmdInitMemoryPool
+	{
+		GpuMemoryBlock** blocks;
+		uint32_t blockCount;
+		uint32_t blockCapacity;
+	} VkCmdInitMemoryPool;
+
+	struct GpuMemoryAllocator
+	{
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		VkDeviceSize preferredBlockSize;
+		//Buffers and optimal images never share a block, so bufferImageGranularity can't be violated
+		VkCmdInitMemoryPool pools[VK_MAX_MEMORY_TYPES][2];
+		uint32_t dedicatedAllocationCount[VK_MAX_MEMORY_TYPES];
+		VkDeviceSize dedicatedBytes[VK_MAX_MEMORY_TYPES];
+	};
+
+	static void vkCmdInitTlsfMapping(VkDeviceSize size, uint32_t* fl, uint32_t* sl)
+	{
+		uint32_t msb = vkCmdInitMsb(size);
+		*fl = msb - VKCMDINIT_TLSF_MIN_LOG2;
+		*sl = (uint32_t)(size >> (msb - VKCMDINIT_TLSF_SL_LOG2)) & (VKCMDINIT_TLSF_SL_COUNT - 1);
+	}
+
+	static void vkCmdInitTlsfInsertFree(GpuMemoryBlock* block, uint32_t index)
+	{
+		VkCmdInitTlsfNode* node = &block->nodes[index];
+		uint32_t fl, sl;
+		vkCmdInitTlsfMapping(node->size, &fl, &sl);
+
+		node->free = true;
+		node->prevFree = VKCMDINIT_NULL_NODE;
+		node->nextFree = block->freeHeads[fl][sl];
+		if (node->nextFree != VKCMDINIT_NULL_NODE)
+			block->nodes[node->nextFree].prevFree = index;
+		block->freeHeads[fl][sl] = index;
+		block->flBitmap |= 1ull << fl;
+		block->slBitmap[fl] |= 1u << sl;
+	}
+
+	static void vkCmdInitTlsfRemoveFree(GpuMemoryBlock* block, uint32_t index)
+	{
+		VkCmdInitTlsfNode* node = &block->nodes[index];
+		uint32_t fl, sl;
+		vkCmdInitTlsfMapping(node->size, &fl, &sl);
+
+		if (node->prevFree != VKCMDINIT_NULL_NODE)
+			block->nodes[node->prevFree].nextFree = node->nextFree;
+		else
+			block->freeHeads[fl][sl] = node->nextFree;
+		if (node->nextFree != VKCMDINIT_NULL_NODE)
+			block->nodes[node->nextFree].prevFree = node->prevFree;
+
+		if (block->freeHeads[fl][sl] == VKCMDINIT_NULL_NODE)
+		{
+			block->slBitmap[fl] &= ~(1u << sl);
+			if (!block->slBitmap[fl])
+				block->flBitmap &= ~(1ull << fl);
+		}
+		node->free = false;
+	}
+
+	static uint32_t vkCmdInitTlsfFindFree(const GpuMemoryBlock* block, VkDeviceSize size)
+	{
+		//Round up to next list boundary, so head of any list found fits without walking it
+		size += (1ull << (vkCmdInitMsb(size) - VKCMDINIT_TLSF_SL_LOG2)) - 1;
+		uint32_t fl, sl;
+		vkCmdInitTlsfMapping(size, &fl, &sl);
+		if (fl >= VKCMDINIT_TLSF_FL_COUNT)
+			return VKCMDINIT_NULL_NODE;
+
+		uint32_t slMap = block->slBitmap[fl] & (~0u << sl);
+		if (!slMap)
+		{
+			uint64_t flMap = block->flBitmap & (~0ull << (fl + 1));
+			if (!flMap)
+				return VKCMDINIT_NULL_NODE;
+			fl = vkCmdInitLsb(flMap);
+			slMap = block->slBitmap[fl];
+		}
+		return block->freeHeads[fl][vkCmdInitLsb(slMap)];
+	}
+
+	//Capacity has to be reserved beforehand
+	static uint32_t vkCmdInitTlsfNewNode(GpuMemoryBlock* block)
+	{
+		if (block->unusedNode != VKCMDINIT_NULL_NODE)
+		{
+			uint32_t index = block->unusedNode;
+			block->unusedNode = block->nodes[index].nextFree;
+			return index;
+		}
+		return block->nodeCount++;
+	}
+
+	static void vkCmdInitTlsfReleaseNode(GpuMemoryBlock* block, uint32_t index)
+	{
+		block->nodes[index].nextFree = block->unusedNode;
+		block->unusedNode = index;
+	}
+
+	//size and alignment are multiples of VKCMDINIT_TLSF_MIN_SIZE
+	static bool vkCmdInitTlsfAllocate(const InitializationStruct* initStruct, GpuMemoryBlock* block, VkDeviceSize size, VkDeviceSize alignment, uint32_t* allocatedNode)
+	{
+		//Up to two splits, reserve nodes now so a failed realloc can't leave half split range behind
+		if (!vkCmdInitReserve(initStruct, (void**)&block->nodes, &block->nodeCapacity, block->nodeCount + 2, sizeof(VkCmdInitTlsfNode), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE))
+			return false;
+
+		//Offsets are multiples of VKCMDINIT_TLSF_MIN_SIZE, so padding never exceeds alignment - VKCMDINIT_TLSF_MIN_SIZE
+		uint32_t index = vkCmdInitTlsfFindFree(block, size + alignment - VKCMDINIT_TLSF_MIN_SIZE);
+		if (index == VKCMDINIT_NULL_NODE)
+			return false;
+		vkCmdInitTlsfRemoveFree(block, index);
+
+		VkDeviceSize alignedOffset = (block->nodes[index].offset + alignment - 1) & ~(alignment - 1);
+		VkDeviceSize padding = alignedOffset - block->nodes[index].offset;
+		if (padding)
+		{
+			uint32_t front = vkCmdInitTlsfNewNode(block);
+			VkCmdInitTlsfNode* node = &block->nodes[index];
+			VkCmdInitTlsfNode* frontNode = &block->nodes[front];
+			frontNode->offset = node->offset;
+			frontNode->size = padding;
+			frontNode->prevPhysical = node->prevPhysical;
+			frontNode->nextPhysical = index;
+			if (node->prevPhysical != VKCMDINIT_NULL_NODE)
+				block->nodes[node->prevPhysical].nextPhysical = front;
+			node->prevPhysical = front;
+			node->offset = alignedOffset;
+			node->size -= padding;
+			vkCmdInitTlsfInsertFree(block, front);
+		}
+
+		if (block->nodes[index].size > size)
+		{
+			uint32_t back = vkCmdInitTlsfNewNode(block);
+			VkCmdInitTlsfNode* node = &block->nodes[index];
+			VkCmdInitTlsfNode* backNode = &block->nodes[back];
+			backNode->offset = node->offset + size;
+			backNode->size = node->size - size;
+			backNode->prevPhysical = index;
+			backNode->nextPhysical = node->nextPhysical;
+			if (node->nextPhysical != VKCMDINIT_NULL_NODE)
+				block->nodes[node->nextPhysical].prevPhysical = back;
+			node->nextPhysical = back;
+			node->size = size;
+			vkCmdInitTlsfInsertFree(block, back);
+		}
+
+		*allocatedNode = index;
+		return true;
+	}
+
+	static void vkCmdInitTlsfFree(GpuMemoryBlock* block, uint32_t index)
+	{
+		VkCmdInitTlsfNode* nodes = block->nodes;
+
+		uint32_t prev = nodes[index].prevPhysical;
+		if (prev != VKCMDINIT_NULL_NODE && nodes[prev].free)
+		{
+			vkCmdInitTlsfRemoveFree(block, prev);
+			nodes[prev].size += nodes[index].size;
+			nodes[prev].nextPhysical = nodes[index].nextPhysical;
+			if (nodes[index].nextPhysical != VKCMDINIT_NULL_NODE)
+				nodes[nodes[index].nextPhysical].prevPhysical = prev;
+			vkCmdInitTlsfReleaseNode(block, index);
+			index = prev;
+		}
+
+		uint32_t next = nodes[index].nextPhysical;
+		if (next != VKCMDINIT_NULL_NODE && nodes[next].free)
+		{
+			vkCmdInitTlsfRemoveFree(block, next);
+			nodes[index].size += nodes[next].size;
+			nodes[index].nextPhysical = nodes[next].nextPhysical;
+			if (nodes[next].nextPhysical != VKCMDINIT_NULL_NODE)
+				nodes[nodes[next].nextPhysical].prevPhysical = index;
+			vkCmdInitTlsfReleaseNode(block, next);
+		}
+
+		vkCmdInitTlsfInsertFree(block, index);
+	}
+
+	static GpuMemoryAllocator* vkCmdInitGetMemoryAllocator(InitializationStruct* initStruct)
+	{
+		if (!initStruct->memoryAllocator)
+		{
+			GpuMemoryAllocator* allocator = (GpuMemoryAllocator*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(GpuMemoryAllocator), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+			if (!allocator)
+				return NULL;
+			initStruct->instanceTable.vkGetPhysicalDeviceMemoryProperties(initStruct->physicalDevice, &allocator->memoryProperties);
+			allocator->preferredBlockSize = initStruct->memoryBlockSize ? initStruct->memoryBlockSize : VKCMDINIT_DEFAULT_MEMORY_BLOCK_SIZE;
+			initStruct->memoryAllocator = allocator;
+		}
+		return initStruct->memoryAllocator;
+	}
+
+	static VkDeviceSize vkCmdInitMemoryBlockSize(const GpuMemoryAllocator* allocator, uint32_t memoryType)
+	{
+		VkDeviceSize heapSize = allocator->memoryProperties.memoryHeaps[allocator->memoryProperties.memoryTypes[memoryType].heapIndex].size;
+		VkDeviceSize blockSize = allocator->preferredBlockSize;
+		//Small heaps (ex. 256 MiB BAR) would be eaten by a couple of blocks
+		if (blockSize > heapSize / 8)
+			blockSize = heapSize / 8;
+		return (blockSize + VKCMDINIT_TLSF_MIN_SIZE - 1) & ~(VKCMDINIT_TLSF_MIN_SIZE - 1);
+	}
+
+	static uint32_t vkCmdInitSelectMemoryType(const GpuMemoryAllocator* allocator, uint32_t typeBits, GpuMemoryUsage usage)
+	{
+		VkMemoryPropertyFlags required = 0;
+		VkMemoryPropertyFlags preferred = 0;
+		VkMemoryPropertyFlags avoided = 0;
+		switch (usage)
+		{
+		case GPU_MEMORY_USAGE_UPLOAD:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			//Write-combined memory is faster to write sequentially
+			avoided = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+			break;
+		case GPU_MEMORY_USAGE_READBACK:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+			break;
+		default:
+			preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			break;
+		}
+
+		uint32_t bestType = UINT32_MAX;
+		uint32_t bestCost = UINT32_MAX;
+		for (uint32_t i = 0; i < allocator->memoryProperties.memoryTypeCount; ++i)
+		{
+			VkMemoryPropertyFlags flags = allocator->memoryProperties.memoryTypes[i].propertyFlags;
+			if (!(typeBits & (1u << i)) || (flags & required) != required)
+				continue;
+
+			uint32_t cost = ((flags & preferred) != preferred ? 2 : 0) + ((flags & avoided) ? 1 : 0);
+			if (cost < bestCost)
+			{
+				bestType = i;
+				bestCost = cost;
+			}
+		}
+		return bestType;
+	}
+
+	static GpuMemoryBlock* vkCmdInitCreateMemoryBlock(InitializationStruct* initStruct, GpuMemoryAllocator* allocator, uint32_t memoryType, bool linear, VkDeviceSize minSize)
+	{
+		VkDeviceSize size = vkCmdInitMemoryBlockSize(allocator, memoryType);
+		if (size < minSize)
+			size = minSize;
+
+		VkMemoryAllocateInfo allocateInfo = { ZERO };
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.allocationSize = size;
+		allocateInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (initStruct->deviceTable.vkAllocateMemory(initStruct->device, &allocateInfo, initStruct->allocationCallbacks, &memory) != VK_SUCCESS)
+			return NULL;
+
+		GpuMemoryBlock* block = (GpuMemoryBlock*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(GpuMemoryBlock), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+		if (!block || !vkCmdInitReserve(initStruct, (void**)&block->nodes, &block->nodeCapacity, 1, sizeof(VkCmdInitTlsfNode), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE))
+		{
+			vkCmdInitHostFree(initStruct, block);
+			initStruct->deviceTable.vkFreeMemory(initStruct->device, memory, initStruct->allocationCallbacks);
+			return NULL;
+		}
+
+		block->memory = memory;
+		block->size = size;
+		block->memoryTypeIndex = memoryType;
+		block->linear = linear;
+		block->unusedNode = VKCMDINIT_NULL_NODE;
+		memset(block->freeHeads, 0xFF, sizeof(block->freeHeads));
+
+		if (allocator->memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			initStruct->deviceTable.vkMapMemory(initStruct->device, memory, 0, VK_WHOLE_SIZE, 0, &block->mappedData);
+
+		uint32_t first = vkCmdInitTlsfNewNode(block);
+		block->nodes[first].offset = 0;
+		block->nodes[first].size = size;
+		block->nodes[first].prevPhysical = VKCMDINIT_NULL_NODE;
+		block->nodes[first].nextPhysical = VKCMDINIT_NULL_NODE;
+		vkCmdInitTlsfInsertFree(block, first);
+		return block;
+	}
+
+	static void vkCmdInitDestroyMemoryBlock(InitializationStruct* initStruct, GpuMemoryBlock* block)
+	{
+		if (block->mappedData)
+			initStruct->deviceTable.vkUnmapMemory(initStruct->device, block->memory);
+		initStruct->deviceTable.vkFreeMemory(initStruct->device, block->memory, initStruct->allocationCallbacks);
+		vkCmdInitHostFree(initStruct, block->nodes);
+		vkCmdInitHostFree(initStruct, block);
+	}
+
+	static void vkCmdInitDestroyMemoryAllocator(InitializationStruct* initStruct)
+	{
+		GpuMemoryAllocator* allocator = initStruct->memoryAllocator;
+		if (!allocator)
+			return;
+
+		for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; ++i)
+		{
+			for (uint32_t j = 0; j < 2; ++j)
+			{
+				VkCmdInitMemoryPool* pool = &allocator->pools[i][j];
+				for (uint32_t k = 0; k < pool->blockCount; ++k)
+					vkCmdInitDestroyMemoryBlock(initStruct, pool->blocks[k]);
+				vkCmdInitHostFree(initStruct, pool->blocks);
+			}
+		}
+		vkCmdInitHostFree(initStruct, allocator);
+		initStruct->memoryAllocator = NULL;
+	}
+
+	static bool vkCmdInitAllocateFromBlock(const InitializationStruct* initStruct, GpuMemoryBlock* block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize requestedSize, GpuAllocation* allocation)
+	{
+		uint32_t node;
+		if (!vkCmdInitTlsfAllocate(initStruct, block, size, alignment, &node))
+			return false;
+
+		block->allocationCount += 1;
+		block->usedBytes += block->nodes[node].size;
+
+		allocation->memory = block->memory;
+		allocation->offset = block->nodes[node].offset;
+		allocation->size = requestedSize;
+		allocation->mappedData = block->mappedData ? (char*)block->mappedData + allocation->offset : NULL;
+		allocation->memoryTypeIndex = block->memoryTypeIndex;
+		allocation->block = block;
+		allocation->node = node;
+		return true;
+	}
+
+	static VkResult vkCmdInitAllocate(InitializationStruct* initStruct, const VkMemoryRequirements* memoryRequirements, GpuMemoryUsage usage, bool linear, /*null unless driver asked for dedicated allocation*/ const VkMemoryDedicatedAllocateInfo* dedicatedAllocateInfo, GpuAllocation* allocation)
+	{
+		memset(allocation, 0, sizeof(*allocation));
+
+		GpuMemoryAllocator* allocator = vkCmdInitGetMemoryAllocator(initStruct);
+		if (!allocator)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		uint32_t memoryType = vkCmdInitSelectMemoryType(allocator, memoryRequirements->memoryTypeBits, usage);
+		//Software implementations may not report device local memory at all
+		if (memoryType == UINT32_MAX && usage == GPU_MEMORY_USAGE_DEVICE_LOCAL)
+			memoryType = vkCmdInitFindMemoryType(initStruct, memoryRequirements->memoryTypeBits, 0);
+		if (memoryType == UINT32_MAX)
+			return VK_ERROR_FEATURE_NOT_PRESENT;
+
+		VkDeviceSize size = (memoryRequirements->size + VKCMDINIT_TLSF_MIN_SIZE - 1) & ~(VKCMDINIT_TLSF_MIN_SIZE - 1);
+		VkDeviceSize alignment = memoryRequirements->alignment > VKCMDINIT_TLSF_MIN_SIZE ? memoryRequirements->alignment : VKCMDINIT_TLSF_MIN_SIZE;
+
+		if (!dedicatedAllocateInfo && size <= vkCmdInitMemoryBlockSize(allocator, memoryType) / 2)
+		{
+			VkCmdInitMemoryPool* pool = &allocator->pools[memoryType][linear ? 1 : 0];
+			for (uint32_t i = 0; i < pool->blockCount; ++i)
+			{
+				if (vkCmdInitAllocateFromBlock(initStruct, pool->blocks[i], size, alignment, memoryRequirements->size, allocation))
+					return VK_SUCCESS;
+			}
+
+			if (!vkCmdInitReserve(initStruct, (void**)&pool->blocks, &pool->blockCapacity, pool->blockCount + 1, sizeof(GpuMemoryBlock*), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE))
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+			GpuMemoryBlock* block = vkCmdInitCreateMemoryBlock(initStruct, allocator, memoryType, linear, size + alignment - VKCMDINIT_TLSF_MIN_SIZE);
+			if (!block)
+				return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+			pool->blocks[pool->blockCount++] = block;
+
+			if (vkCmdInitAllocateFromBlock(initStruct, block, size, alignment, memoryRequirements->size, allocation))
+				return VK_SUCCESS;
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
+
+		VkMemoryAllocateInfo allocateInfo = { ZERO };
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.pNext = dedicatedAllocateInfo;
+		allocateInfo.allocationSize = memoryRequirements->size;
+		allocateInfo.memoryTypeIndex = memoryType;
+
+		VkResult result = initStruct->deviceTable.vkAllocateMemory(initStruct->device, &allocateInfo, initStruct->allocationCallbacks, &allocation->memory);
+		if (result != VK_SUCCESS)
+			return result;
+
+		allocation->size = memoryRequirements->size;
+		allocation->memoryTypeIndex = memoryType;
+		if (allocator->memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			initStruct->deviceTable.vkMapMemory(initStruct->device, allocation->memory, 0, VK_WHOLE_SIZE, 0, &allocation->mappedData);
+
+		allocator->dedicatedAllocationCount[memoryType] += 1;
+		allocator->dedicatedBytes[memoryType] += allocation->size;
+		return VK_SUCCESS;
+	}
+
+	VkResult allocateBufferMemory(InitializationStruct* initStruct, VkBuffer buffer, GpuMemoryUsage usage, GpuAllocation* allocation)
+	{
+		VkMemoryRequirements memoryRequirements;
+		VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo = { ZERO };
+		bool dedicated = false;
+
+		if (initStruct->deviceTable.vkGetBufferMemoryRequirements2)
+		{
+			VkMemoryDedicatedRequirements dedicatedRequirements = { ZERO };
+			dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+			VkMemoryRequirements2 memoryRequirements2 = { ZERO };
+			memoryRequirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+			memoryRequirements2.pNext = &dedicatedRequirements;
+
+			VkBufferMemoryRequirementsInfo2 requirementsInfo = { ZERO };
+			requirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+			requirementsInfo.buffer = buffer;
+
+			initStruct->deviceTable.vkGetBufferMemoryRequirements2(initStruct->device, &requirementsInfo, &memoryRequirements2);
+			memoryRequirements = memoryRequirements2.memoryRequirements;
+			dedicated = dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+		}
+		else
+		{
+			initStruct->deviceTable.vkGetBufferMemoryRequirements(initStruct->device, buffer, &memoryRequirements);
+		}
+
+		dedicatedAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedAllocateInfo.buffer = buffer;
+
+		VkResult result = vkCmdInitAllocate(initStruct, &memoryRequirements, usage, true, dedicated ? &dedicatedAllocateInfo : NULL, allocation);
+		if (result != VK_SUCCESS)
+			return result;
+
+		result = initStruct->deviceTable.vkBindBufferMemory(initStruct->device, buffer, allocation->memory, allocation->offset);
+		if (result != VK_SUCCESS)
+			freeAllocation(initStruct, allocation);
+		return result;
+	}
+
+	VkResult allocateImageMemory(InitializationStruct* initStruct, VkImage image, GpuMemoryUsage usage, GpuAllocation* allocation)
+	{
+		VkMemoryRequirements memoryRequirements;
+		VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo = { ZERO };
+		bool dedicated = false;
+
+		if (initStruct->deviceTable.vkGetImageMemoryRequirements2)
+		{
+			VkMemoryDedicatedRequirements dedicatedRequirements = { ZERO };
+			dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+			VkMemoryRequirements2 memoryRequirements2 = { ZERO };
+			memoryRequirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+			memoryRequirements2.pNext = &dedicatedRequirements;
+
+			VkImageMemoryRequirementsInfo2 requirementsInfo = { ZERO };
+			requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+			requirementsInfo.image = image;
+
+			initStruct->deviceTable.vkGetImageMemoryRequirements2(initStruct->device, &requirementsInfo, &memoryRequirements2);
+			memoryRequirements = memoryRequirements2.memoryRequirements;
+			//Render targets on some drivers get compression only in their own allocation
+			dedicated = dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+		}
+		else
+		{
+			initStruct->deviceTable.vkGetImageMemoryRequirements(initStruct->device, image, &memoryRequirements);
+		}
+
+		dedicatedAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedAllocateInfo.image = image;
+
+		VkResult result = vkCmdInitAllocate(initStruct, &memoryRequirements, usage, false, dedicated ? &dedicatedAllocateInfo : NULL, allocation);
+		if (result != VK_SUCCESS)
+			return result;
+
+		result = initStruct->deviceTable.vkBindImageMemory(initStruct->device, image, allocation->memory, allocation->offset);
+		if (result != VK_SUCCESS)
+			freeAllocation(initStruct, allocation);
+		return result;
+	}
+
+	void freeAllocation(InitializationStruct* initStruct, GpuAllocation* allocation)
+	{
+		GpuMemoryAllocator* allocator = initStruct->memoryAllocator;
+		if (!allocation->memory || !allocator)
+			return;
+
+		GpuMemoryBlock* block = allocation->block;
+		if (!block)
+		{
+			if (allocation->mappedData)
+				initStruct->deviceTable.vkUnmapMemory(initStruct->device, allocation->memory);
+			initStruct->deviceTable.vkFreeMemory(initStruct->device, allocation->memory, initStruct->allocationCallbacks);
+			allocator->dedicatedAllocationCount[allocation->memoryTypeIndex] -= 1;
+			allocator->dedicatedBytes[allocation->memoryTypeIndex] -= allocation->size;
+		}
+		else
+		{
+			block->allocationCount -= 1;
+			block->usedBytes -= block->nodes[allocation->node].size;
+			vkCmdInitTlsfFree(block, allocation->node);
+
+			//Keep one block per pool around even if empty, so alloc/free pair at the edge doesn't hit vkAllocateMemory every time
+			VkCmdInitMemoryPool* pool = &allocator->pools[block->memoryTypeIndex][block->linear ? 1 : 0];
+			if (!block->allocationCount && pool->blockCount > 1)
+			{
+				for (uint32_t i = 0; i < pool->blockCount; ++i)
+				{
+					if (pool->blocks[i] == block)
+					{
+						pool->blocks[i] = pool->blocks[--pool->blockCount];
+						break;
+					}
+				}
+				vkCmdInitDestroyMemoryBlock(initStruct, block);
+			}
+		}
+
+		memset(allocation, 0, sizeof(*allocation));
+	}
+
+	GpuLinearArena* createLinearArena(InitializationStruct* initStruct, VkDeviceSize capacity, GpuMemoryUsage usage, /*0 = raw memory*/ VkBufferUsageFlags bufferUsage)
+	{
+		GpuLinearArena* arena = (GpuLinearArena*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(GpuLinearArena), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!arena)
+			return NULL;
+		arena->capacity = capacity;
+
+		VkResult result;
+		if (bufferUsage)
+		{
+			VkBufferCreateInfo bufferCreateInfo = { ZERO };
+			bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferCreateInfo.size = capacity;
+			bufferCreateInfo.usage = bufferUsage;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			result = initStruct->deviceTable.vkCreateBuffer(initStruct->device, &bufferCreateInfo, initStruct->allocationCallbacks, &arena->buffer);
+			if (result == VK_SUCCESS)
+				result = allocateBufferMemory(initStruct, arena->buffer, usage, &arena->allocation);
+		}
+		else
+		{
+			VkMemoryRequirements memoryRequirements;
+			memoryRequirements.size = capacity;
+			memoryRequirements.alignment = VKCMDINIT_TLSF_MIN_SIZE;
+			memoryRequirements.memoryTypeBits = UINT32_MAX;
+			result = vkCmdInitAllocate(initStruct, &memoryRequirements, usage, false, NULL, &arena->allocation);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			destroyLinearArena(initStruct, arena);
+			return NULL;
+		}
+		return arena;
+	}
+
+	VkResult allocateFromArena(GpuLinearArena* arena, VkDeviceSize size, /*power of two*/ VkDeviceSize alignment, VkDeviceSize* offset, /*can be null*/ void** mappedData)
+	{
+		//Buffer offsets are aligned relative to the buffer, raw memory offsets relative to the memory object
+		VkDeviceSize base = arena->buffer ? 0 : arena->allocation.offset;
+		VkDeviceSize mask = alignment ? alignment - 1 : 0;
+		VkDeviceSize alignedOffset = ((base + arena->head + mask) & ~mask) - base;
+		if (alignedOffset + size > arena->capacity)
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		arena->head = alignedOffset + size;
+		if (arena->head > arena->highWatermark)
+			arena->highWatermark = arena->head;
+
+		*offset = alignedOffset;
+		if (mappedData)
+			*mappedData = arena->allocation.mappedData ? (char*)arena->allocation.mappedData + alignedOffset : NULL;
+		return VK_SUCCESS;
+	}
+
+	void resetLinearArena(GpuLinearArena* arena)
+	{
+		arena->head = 0;
+	}
+
+	void destroyLinearArena(InitializationStruct* initStruct, GpuLinearArena* arena)
+	{
+		if (arena->buffer)
+			initStruct->deviceTable.vkDestroyBuffer(initStruct->device, arena->buffer, initStruct->allocationCallbacks);
+		freeAllocation(initStruct, &arena->allocation);
+		vkCmdInitHostFree(initStruct, arena);
+	}
+
+	static void vkCmdInitAddMemoryStats(GpuMemoryStats* stats, const GpuMemoryStats* other)
+	{
+		stats->blockCount += other->blockCount;
+		stats->allocationCount += other->allocationCount;
+		stats->dedicatedAllocationCount += other->dedicatedAllocationCount;
+		stats->freeRangeCount += other->freeRangeCount;
+		stats->blockBytes += other->blockBytes;
+		stats->usedBytes += other->usedBytes;
+		stats->dedicatedBytes += other->dedicatedBytes;
+		stats->freeBytes += other->freeBytes;
+		if (other->largestFreeRange > stats->largestFreeRange)
+			stats->largestFreeRange = other->largestFreeRange;
+		stats->fragmentation = stats->freeBytes ? 1.0f - (float)stats->largestFreeRange / (float)stats->freeBytes : 0.0f;
+	}
+
+	void getMemoryStats(InitializationStruct* initStruct, /*can be null, otherwise VK_MAX_MEMORY_TYPES entries*/ GpuMemoryStats* memoryTypeStats, /*can be null*/ GpuMemoryStats* totalStats)
+	{
+		GpuMemoryStats total;
+		memset(&total, 0, sizeof(total));
+
+		GpuMemoryAllocator* allocator = initStruct->memoryAllocator;
+		for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; ++i)
+		{
+			GpuMemoryStats stats;
+			memset(&stats, 0, sizeof(stats));
+
+			if (allocator)
+			{
+				stats.dedicatedAllocationCount = allocator->dedicatedAllocationCount[i];
+				stats.dedicatedBytes = allocator->dedicatedBytes[i];
+
+				for (uint32_t j = 0; j < 2; ++j)
+				{
+					const VkCmdInitMemoryPool* pool = &allocator->pools[i][j];
+					for (uint32_t k = 0; k < pool->blockCount; ++k)
+					{
+						const GpuMemoryBlock* block = pool->blocks[k];
+						stats.blockCount += 1;
+						stats.blockBytes += block->size;
+						stats.allocationCount += block->allocationCount;
+						stats.usedBytes += block->usedBytes;
+
+						for (uint32_t node = 0; node != VKCMDINIT_NULL_NODE; node = block->nodes[node].nextPhysical)
+						{
+							if (!block->nodes[node].free)
+								continue;
+							stats.freeRangeCount += 1;
+							stats.freeBytes += block->nodes[node].size;
+							if (block->nodes[node].size > stats.largestFreeRange)
+								stats.largestFreeRange = block->nodes[node].size;
+						}
+					}
+				}
+				stats.fragmentation = stats.freeBytes ? 1.0f - (float)stats.largestFreeRange / (float)stats.freeBytes : 0.0f;
+			}
+
+			if (memoryTypeStats)
+				memoryTypeStats[i] = stats;
+			vkCmdInitAddMemoryStats(&total, &stats);
+		}
+
+		if (totalStats)
+			*totalStats = total;
+	}
+
+	UploadRing* createUploadRing(InitializationStruct* initStruct, /*can be VK_NULL_HANDLE*/ VkQueue queue, /*ignored if queue is VK_NULL_HANDLE*/ uint32_t queueFamilyIndex, VkDeviceSize capacity)
+	{
+		if (!queue)
+		{
+			if (!initStruct->defaultQueueIndices)
+				return NULL;
+			queue = retrieveQueue(initStruct, QUEUE_ROLE_TRANSFER, 0);
+			queueFamilyIndex = initStruct->defaultQueueIndices->transferFamilyIndex;
+		}
+
+		UploadRing* uploadRing = (UploadRing*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(UploadRing), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!uploadRing)
+			return NULL;
+		uploadRing->capacity = capacity;
+		uploadRing->queueFamilyIndex = queueFamilyIndex;
+
+		VkPhysicalDeviceProperties properties;
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+		uploadRing->copyAlignment = properties.limits.optimalBufferCopyOffsetAlignment > 16 ? properties.limits.optimalBufferCopyOffsetAlignment : 16;
+
+		VkBufferCreateInfo bufferCreateInfo = { ZERO };
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.size = capacity;
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkCommandPoolCreateInfo commandPoolCreateInfo = { ZERO };
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		//Command buffers are recycled one by one as their batches complete
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+		VkResult result = initStruct->deviceTable.vkCreateBuffer(initStruct->device, &bufferCreateInfo, initStruct->allocationCallbacks, &uploadRing->buffer);
+		if (result == VK_SUCCESS)
+			result = allocateBufferMemory(initStruct, uploadRing->buffer, GPU_MEMORY_USAGE_UPLOAD, &uploadRing->allocation);
+		if (result == VK_SUCCESS)
+			result = initStruct->deviceTable.vkCreateCommandPool(initStruct->device, &commandPoolCreateInfo, initStruct->allocationCallbacks, &uploadRing->commandPool);
+		if (result == VK_SUCCESS)
+		{
+			uploadRing->timelineQueue = createTimelineQueue(initStruct, queue);
+			if (!uploadRing->timelineQueue)
+				result = VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			destroyUploadRing(initStruct, uploadRing);
+			return NULL;
+		}
+		return uploadRing;
+	}
+
+	//Moves tail past every batch GPU finished, without blocking
+	static void vkCmdInitReclaimUploads(InitializationStruct* initStruct, UploadRing* uploadRing)
+	{
+		uint32_t completed = 0;
+		while (completed < uploadRing->batchCount && isTimelinePointReached(initStruct, uploadRing->timelineQueue, uploadRing->batches[completed].timelineValue))
+		{
+			uploadRing->tail = uploadRing->batches[completed].ringEnd;
+			//Capacity for it was reserved when batch was pushed
+			uploadRing->freeCommandBuffers[uploadRing->freeCommandBufferCount++] = uploadRing->batches[completed].commandBuffer;
+			++completed;
+		}
+
+		if (completed)
+		{
+			uploadRing->batchCount -= completed;
+			memmove(uploadRing->batches, uploadRing->batches + completed, sizeof(UploadBatch) * uploadRing->batchCount);
+		}
+	}
+
+	//Reserves size bytes in the ring, flushing and waiting for GPU only if the ring is full
+	static VkResult vkCmdInitReserveUpload(InitializationStruct* initStruct, UploadRing* uploadRing, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* offset)
+	{
+		if (size > uploadRing->capacity)
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		for (;;)
+		{
+			//Allocation never wraps, if it doesn't fit before the end, the rest of the ring is skipped
+			VkDeviceSize position = uploadRing->head % uploadRing->capacity;
+			VkDeviceSize padding = ((position + alignment - 1) / alignment) * alignment - position;
+			if (position + padding + size > uploadRing->capacity)
+				padding = uploadRing->capacity - position;
+			VkDeviceSize required = padding + size;
+
+			if (uploadRing->head + required - uploadRing->tail <= uploadRing->capacity)
+			{
+				*offset = (uploadRing->head + padding) % uploadRing->capacity;
+				uploadRing->head += required;
+				return VK_SUCCESS;
+			}
+
+			vkCmdInitReclaimUploads(initStruct, uploadRing);
+			if (uploadRing->head + required - uploadRing->tail <= uploadRing->capacity)
+				continue;
+
+			//Ring is full of copies GPU hasn't finished (or even seen yet)
+			VkResult result = flushUploads(initStruct, uploadRing, NULL);
+			if (result != VK_SUCCESS)
+				return result;
+			if (!uploadRing->batchCount)
+				return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+			uploadRing->stallCount += 1;
+			result = waitTimelinePoint(initStruct, uploadRing->timelineQueue, uploadRing->batches[0].timelineValue, UINT64_MAX);
+			if (result != VK_SUCCESS)
+				return result;
+		}
+	}
+
+	static VkCommandBuffer vkCmdInitUploadCommandBuffer(InitializationStruct* initStruct, UploadRing* uploadRing)
+	{
+		if (uploadRing->recordingCommandBuffer)
+			return uploadRing->recordingCommandBuffer;
+
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (uploadRing->freeCommandBufferCount)
+		{
+			commandBuffer = uploadRing->freeCommandBuffers[--uploadRing->freeCommandBufferCount];
+			initStruct->deviceTable.vkResetCommandBuffer(commandBuffer, 0);
+		}
+		else
+		{
+			VkCommandBufferAllocateInfo commandBufferAllocateInfo = { ZERO };
+			commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			commandBufferAllocateInfo.commandPool = uploadRing->commandPool;
+			commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			commandBufferAllocateInfo.commandBufferCount = 1;
+			if (initStruct->deviceTable.vkAllocateCommandBuffers(initStruct->device, &commandBufferAllocateInfo, &commandBuffer) != VK_SUCCESS)
+				return VK_NULL_HANDLE;
+		}
+
+		VkCommandBufferBeginInfo commandBufferBeginInfo = { ZERO };
+		commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		initStruct->deviceTable.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
+
+		uploadRing->recordingCommandBuffer = commandBuffer;
+		return commandBuffer;
+	}
+
+	VkResult uploadToBuffer(InitializationStruct* initStruct, UploadRing* uploadRing, VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size, /*VK_QUEUE_FAMILY_IGNORED if buffer is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex)
+	{
+		if (!size)
+			return VK_SUCCESS;
+
+		//Half the ring, so next chunk can be written while GPU copies previous one
+		VkDeviceSize chunkSize = uploadRing->capacity / 2;
+		for (VkDeviceSize done = 0; done < size; done += chunkSize)
+		{
+			VkDeviceSize copySize = size - done < chunkSize ? size - done : chunkSize;
+
+			VkDeviceSize offset;
+			VkResult result = vkCmdInitReserveUpload(initStruct, uploadRing, copySize, 4, &offset);
+			if (result != VK_SUCCESS)
+				return result;
+
+			VkCommandBuffer commandBuffer = vkCmdInitUploadCommandBuffer(initStruct, uploadRing);
+			if (!commandBuffer)
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+			memcpy((char*)uploadRing->allocation.mappedData + offset, (const char*)data + done, (size_t)copySize);
+
+			VkBufferCopy copy;
+			copy.srcOffset = offset;
+			copy.dstOffset = dstOffset + done;
+			copy.size = copySize;
+			initStruct->deviceTable.vkCmdCopyBuffer(commandBuffer, uploadRing->buffer, dstBuffer, 1, &copy);
+
+			uploadRing->pendingCopyCount += 1;
+			uploadRing->uploadedBytes += copySize;
+		}
+
+		if (dstQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED && dstQueueFamilyIndex != uploadRing->queueFamilyIndex)
+		{
+			VkBufferMemoryBarrier releaseBarrier = { ZERO };
+			releaseBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			releaseBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			releaseBarrier.srcQueueFamilyIndex = uploadRing->queueFamilyIndex;
+			releaseBarrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+			releaseBarrier.buffer = dstBuffer;
+			releaseBarrier.offset = dstOffset;
+			releaseBarrier.size = size;
+			initStruct->deviceTable.vkCmdPipelineBarrier(uploadRing->recordingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 1, &releaseBarrier, 0, NULL);
+		}
+		return VK_SUCCESS;
+	}
+
+	VkResult uploadToImage(InitializationStruct* initStruct, UploadRing* uploadRing, VkImage dstImage, const VkBufferImageCopy* region, const void* data, VkDeviceSize size, /*VK_IMAGE_LAYOUT_UNDEFINED discards previous contents*/ VkImageLayout oldLayout, VkImageLayout finalLayout, /*VK_QUEUE_FAMILY_IGNORED if image is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex)
+	{
+		//Layers (or slices of 3D image) are the only split that is exact for every format, block compressed included
+		bool layered = region->imageExtent.depth <= 1;
+		uint32_t sliceCount = layered ? region->imageSubresource.layerCount : region->imageExtent.depth;
+		VkDeviceSize sliceSize = sliceCount && size % sliceCount == 0 ? size / sliceCount : size;
+		if (sliceSize == size)
+			sliceCount = 1;
+		uint32_t slicesPerChunk = sliceCount;
+		if (size > uploadRing->capacity / 2 && sliceCount > 1)
+		{
+			slicesPerChunk = (uint32_t)(uploadRing->capacity / 2 / sliceSize);
+			slicesPerChunk = slicesPerChunk ? slicesPerChunk : 1;
+		}
+
+		VkImageSubresourceRange subresourceRange;
+		subresourceRange.aspectMask = region->imageSubresource.aspectMask;
+		subresourceRange.baseMipLevel = region->imageSubresource.mipLevel;
+		subresourceRange.levelCount = 1;
+		subresourceRange.baseArrayLayer = region->imageSubresource.baseArrayLayer;
+		subresourceRange.layerCount = region->imageSubresource.layerCount;
+
+		VkImageMemoryBarrier barrier = { ZERO };
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = dstImage;
+		barrier.subresourceRange = subresourceRange;
+
+		//Chunks may end up in different submits, queue submission order keeps layout transitions around them valid
+		for (uint32_t slice = 0; slice < sliceCount; slice += slicesPerChunk)
+		{
+			uint32_t chunkSlices = sliceCount - slice < slicesPerChunk ? sliceCount - slice : slicesPerChunk;
+			VkDeviceSize copySize = sliceCount > 1 ? sliceSize * chunkSlices : size;
+
+			VkDeviceSize offset;
+			VkResult result = vkCmdInitReserveUpload(initStruct, uploadRing, copySize, uploadRing->copyAlignment, &offset);
+			if (result != VK_SUCCESS)
+				return result;
+
+			VkCommandBuffer commandBuffer = vkCmdInitUploadCommandBuffer(initStruct, uploadRing);
+			if (!commandBuffer)
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+			memcpy((char*)uploadRing->allocation.mappedData + offset, (const char*)data + sliceSize * slice, (size_t)copySize);
+
+			if (slice == 0)
+				initStruct->deviceTable.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+			VkBufferImageCopy copy = *region;
+			copy.bufferOffset = offset;
+			copy.bufferRowLength = 0;
+			copy.bufferImageHeight = 0;
+			if (sliceCount > 1 && layered)
+			{
+				copy.imageSubresource.baseArrayLayer += slice;
+				copy.imageSubresource.layerCount = chunkSlices;
+			}
+			else if (sliceCount > 1)
+			{
+				copy.imageOffset.z += (int32_t)slice;
+				copy.imageExtent.depth = chunkSlices;
+			}
+			initStruct->deviceTable.vkCmdCopyBufferToImage(commandBuffer, uploadRing->buffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+			uploadRing->pendingCopyCount += 1;
+			uploadRing->uploadedBytes += copySize;
+		}
+
+		//Layout transition to finalLayout doubles as ownership release
+		bool release = dstQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED && dstQueueFamilyIndex != uploadRing->queueFamilyIndex;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = finalLayout;
+		barrier.srcQueueFamilyIndex = release ? uploadRing->queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = release ? dstQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+		initStruct->deviceTable.vkCmdPipelineBarrier(uploadRing->recordingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+		return VK_SUCCESS;
+	}
+
+	VkResult flushUploads(InitializationStruct* initStruct, UploadRing* uploadRing, /*can be null*/ uint64_t* timelineValue)
+	{
+		if (timelineValue)
+			*timelineValue = 0;
+		if (!uploadRing->pendingCopyCount)
+			return VK_SUCCESS;
+
+		//Reserve both before submitting, so a completed batch always has somewhere to go
+		if (!vkCmdInitReserve(initStruct, (void**)&uploadRing->batches, &uploadRing->batchCapacity, uploadRing->batchCount + 1, sizeof(UploadBatch), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) ||
+			!vkCmdInitReserve(initStruct, (void**)&uploadRing->freeCommandBuffers, &uploadRing->freeCommandBufferCapacity, uploadRing->batchCount + uploadRing->freeCommandBufferCount + 1, sizeof(VkCommandBuffer), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		VkCommandBuffer commandBuffer = uploadRing->recordingCommandBuffer;
+		uploadRing->recordingCommandBuffer = VK_NULL_HANDLE;
+		uploadRing->pendingCopyCount = 0;
+
+		VkResult result = initStruct->deviceTable.vkEndCommandBuffer(commandBuffer);
+		uint64_t value = result == VK_SUCCESS ? enqueueSubmit(uploadRing->timelineQueue, &commandBuffer, 1, NULL, 0, VK_NULL_HANDLE) : 0;
+		if (!value)
+		{
+			//Copies never reach the queue, so their ring space (everything past last batch) and command buffer are free again
+			initStruct->deviceTable.vkResetCommandBuffer(commandBuffer, 0);
+			uploadRing->freeCommandBuffers[uploadRing->freeCommandBufferCount++] = commandBuffer;
+			uploadRing->head = uploadRing->batchCount ? uploadRing->batches[uploadRing->batchCount - 1].ringEnd : uploadRing->tail;
+			return result == VK_SUCCESS ? VK_ERROR_OUT_OF_HOST_MEMORY : result;
+		}
+
+		//Enqueued submission is owned by timeline queue even if vkQueueSubmit fails now, waitTimelinePoint flushes it again
+		UploadBatch* batch = &uploadRing->batches[uploadRing->batchCount++];
+		batch->timelineValue = value;
+		batch->ringEnd = uploadRing->head;
+		batch->commandBuffer = commandBuffer;
+		uploadRing->flushCount += 1;
+
+		if (timelineValue)
+			*timelineValue = value;
+		return flushTimelineQueue(initStruct, uploadRing->timelineQueue, VK_NULL_HANDLE);
+	}
+
+	void destroyUploadRing(InitializationStruct* initStruct, UploadRing* uploadRing)
+	{
+		if (uploadRing->timelineQueue)
+		{
+			flushUploads(initStruct, uploadRing, NULL);
+			destroyTimelineQueue(initStruct, uploadRing->timelineQueue);
+		}
+		if (uploadRing->commandPool)
+			initStruct->deviceTable.vkDestroyCommandPool(initStruct->device, uploadRing->commandPool, initStruct->allocationCallbacks);
+		if (uploadRing->buffer)
+			initStruct->deviceTable.vkDestroyBuffer(initStruct->device, uploadRing->buffer, initStruct->allocationCallbacks);
+		freeAllocation(initStruct, &uploadRing->allocation);
+
+		vkCmdInitHostFree(initStruct, uploadRing->batches);
+		vkCmdInitHostFree(initStruct, uploadRing->freeCommandBuffers);
+		vkCmdInitHostFree(initStruct, uploadRing);
+	}
+
+	//Bytes per texel of formats swapchains and render targets commonly use, 0 if unknown
+	static uint32_t vkCmdInitFormatSize(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+		case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+			return 4;
+		case VK_FORMAT_R16G16B16A16_UNORM:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+			return 8;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	ReadbackRing* createReadbackRing(InitializationStruct* initStruct, uint32_t slotCount, VkDeviceSize slotSize, /*can be null*/ ReadbackCallback callback, void* userData)
+	{
+		ReadbackRing* readbackRing = (ReadbackRing*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(ReadbackRing), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!readbackRing)
+			return NULL;
+		readbackRing->slots = (ReadbackSlot*)vkCmdInitHostAllocateZeroed(initStruct, slotCount, sizeof(ReadbackSlot), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		readbackRing->slotCount = slotCount;
+		readbackRing->slotSize = slotSize;
+		readbackRing->callback = callback;
+		readbackRing->userData = userData;
+
+		VkPhysicalDeviceProperties properties;
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+		readbackRing->nonCoherentAtomSize = properties.limits.nonCoherentAtomSize ? properties.limits.nonCoherentAtomSize : 1;
+
+		VkBufferCreateInfo bufferCreateInfo = { ZERO };
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.size = slotSize;
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkResult result = readbackRing->slots ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+		for (uint32_t i = 0; i < slotCount && result == VK_SUCCESS; ++i)
+		{
+			result = initStruct->deviceTable.vkCreateBuffer(initStruct->device, &bufferCreateInfo, initStruct->allocationCallbacks, &readbackRing->slots[i].buffer);
+			if (result == VK_SUCCESS)
+				result = allocateBufferMemory(initStruct, readbackRing->slots[i].buffer, GPU_MEMORY_USAGE_READBACK, &readbackRing->slots[i].allocation);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			destroyReadbackRing(initStruct, readbackRing);
+			return NULL;
+		}
+
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		initStruct->instanceTable.vkGetPhysicalDeviceMemoryProperties(initStruct->physicalDevice, &memoryProperties);
+		readbackRing->coherent = slotCount == 0 || (memoryProperties.memoryTypes[readbackRing->slots[0].allocation.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+		return readbackRing;
+	}
+
+	VkResult recordImageReadback(InitializationStruct* initStruct, ReadbackRing* readbackRing, VkCommandBuffer commandBuffer, VkImage image, /*ex. VK_IMAGE_LAYOUT_PRESENT_SRC_KHR after render pass*/ VkImageLayout imageLayout, VkFormat format, VkExtent2D extent, uint64_t frameNumber)
+	{
+		uint32_t texelSize = vkCmdInitFormatSize(format);
+		if (!texelSize)
+			return VK_ERROR_FORMAT_NOT_SUPPORTED;
+
+		VkDeviceSize size = (VkDeviceSize)extent.width * extent.height * texelSize;
+		if (size > readbackRing->slotSize)
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		//Surface may not support transfer source, swapchain is created without it then
+		if (imageLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR && initStruct->swapchainGrantedUsage && !(initStruct->swapchainGrantedUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+			return VK_ERROR_FEATURE_NOT_PRESENT;
+
+		ReadbackSlot* slot = NULL;
+		for (uint32_t i = 0; i < readbackRing->slotCount && !slot; ++i)
+		{
+			uint32_t index = (readbackRing->nextSlot + i) % readbackRing->slotCount;
+			if (readbackRing->slots[index].state == READBACK_SLOT_STATE_FREE)
+			{
+				slot = &readbackRing->slots[index];
+				readbackRing->nextSlot = (index + 1) % readbackRing->slotCount;
+			}
+		}
+
+		//Render thread must never wait for the consumer, drop the capture instead
+		if (!slot)
+		{
+			readbackRing->droppedCount += 1;
+			return VK_NOT_READY;
+		}
+
+		slot->state = READBACK_SLOT_STATE_PENDING;
+		slot->frameNumber = frameNumber;
+		slot->extent = extent;
+		slot->format = format;
+		slot->size = size;
+
+		VkImageMemoryBarrier imageBarrier = { ZERO };
+		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		imageBarrier.oldLayout = imageLayout;
+		imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.image = image;
+		imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageBarrier.subresourceRange.levelCount = 1;
+		imageBarrier.subresourceRange.layerCount = 1;
+		initStruct->deviceTable.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &imageBarrier);
+
+		VkBufferImageCopy copy = { ZERO };
+		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.layerCount = 1;
+		copy.imageExtent.width = extent.width;
+		copy.imageExtent.height = extent.height;
+		copy.imageExtent.depth = 1;
+		initStruct->deviceTable.vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer, 1, &copy);
+
+		//Back to the layout caller left it in, presentation waits on semaphore so no access has to be made visible
+		imageBarrier.srcAccessMask = 0;
+		imageBarrier.dstAccessMask = 0;
+		imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		imageBarrier.newLayout = imageLayout;
+
+		VkBufferMemoryBarrier bufferBarrier = { ZERO };
+		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.buffer = slot->buffer;
+		bufferBarrier.size = VK_WHOLE_SIZE;
+		initStruct->deviceTable.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 1, &bufferBarrier, 1, &imageBarrier);
+		return VK_SUCCESS;
+	}
+
+	uint32_t pollReadbacks(InitializationStruct* initStruct, ReadbackRing* readbackRing, uint64_t completedFrameNumber)
+	{
+		//Frame number minus frames in flight wrapped around, no frame is done yet
+		if (completedFrameNumber >> 63)
+			return 0;
+
+		uint32_t readyCount = 0;
+		for (uint32_t i = 0; i < readbackRing->slotCount; ++i)
+		{
+			ReadbackSlot* slot = &readbackRing->slots[i];
+			if (slot->state != READBACK_SLOT_STATE_PENDING || slot->frameNumber > completedFrameNumber)
+				continue;
+
+			if (!readbackRing->coherent)
+			{
+				//Sub-allocations start at multiples of 256, atom size is at most 256
+				VkMappedMemoryRange range = { ZERO };
+				range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+				range.memory = slot->allocation.memory;
+				range.offset = slot->allocation.offset;
+				range.size = ((slot->size + readbackRing->nonCoherentAtomSize - 1) / readbackRing->nonCoherentAtomSize) * readbackRing->nonCoherentAtomSize;
+				if (slot->allocation.offset + range.size > slot->allocation.offset + slot->allocation.size)
+					range.size = VK_WHOLE_SIZE;
+				initStruct->deviceTable.vkInvalidateMappedMemoryRanges(initStruct->device, 1, &range);
+			}
+
+			slot->state = READBACK_SLOT_STATE_READY;
+			readyCount += 1;
+
+			if (readbackRing->callback)
+			{
+				ReadbackResult result;
+				result.data = slot->allocation.mappedData;
+				result.size = slot->size;
+				result.rowPitch = slot->extent.width * vkCmdInitFormatSize(slot->format);
+				result.extent = slot->extent;
+				result.format = slot->format;
+				result.frameNumber = slot->frameNumber;
+				result.slotIndex = i;
+				readbackRing->callback(&result, readbackRing->userData);
+
+				slot->state = READBACK_SLOT_STATE_FREE;
+				readbackRing->deliveredCount += 1;
+			}
+		}
+		return readyCount;
+	}
+
+	uint32_t pollFrameReadbacks(InitializationStruct* initStruct, ReadbackRing* readbackRing, const FrameContext* frameContext)
+	{
+		//Frame that used current slot before is done, so is everything before it
+		if (frameContext->frameNumber < frameContext->framesInFlight)
+			return 0;
+		return pollReadbacks(initStruct, readbackRing, frameContext->frameNumber - frameContext->framesInFlight);
+	}
+
+	bool acquireReadback(ReadbackRing* readbackRing, ReadbackResult* result)
+	{
+		ReadbackSlot* oldest = NULL;
+		uint32_t oldestIndex = 0;
+		for (uint32_t i = 0; i < readbackRing->slotCount; ++i)
+		{
+			ReadbackSlot* slot = &readbackRing->slots[i];
+			if (slot->state == READBACK_SLOT_STATE_READY && (!oldest || slot->frameNumber < oldest->frameNumber))
+			{
+				oldest = slot;
+				oldestIndex = i;
+			}
+		}
+		if (!oldest)
+			return false;
+
+		oldest->state = READBACK_SLOT_STATE_ACQUIRED;
+		result->data = oldest->allocation.mappedData;
+		result->size = oldest->size;
+		result->rowPitch = oldest->extent.width * vkCmdInitFormatSize(oldest->format);
+		result->extent = oldest->extent;
+		result->format = oldest->format;
+		result->frameNumber = oldest->frameNumber;
+		result->slotIndex = oldestIndex;
+		return true;
+	}
+
+	void releaseReadback(ReadbackRing* readbackRing, const ReadbackResult* result)
+	{
+		if (result->slotIndex < readbackRing->slotCount && readbackRing->slots[result->slotIndex].state == READBACK_SLOT_STATE_ACQUIRED)
+		{
+			readbackRing->slots[result->slotIndex].state = READBACK_SLOT_STATE_FREE;
+			readbackRing->deliveredCount += 1;
+		}
+	}
+
+	void destroyReadbackRing(InitializationStruct* initStruct, ReadbackRing* readbackRing)
+	{
+		for (uint32_t i = 0; readbackRing->slots && i < readbackRing->slotCount; ++i)
+		{
+			if (readbackRing->slots[i].buffer)
+				initStruct->deviceTable.vkDestroyBuffer(initStruct->device, readbackRing->slots[i].buffer, initStruct->allocationCallbacks);
+			freeAllocation(initStruct, &readbackRing->slots[i].allocation);
+		}
+		vkCmdInitHostFree(initStruct, readbackRing->slots);
+		vkCmdInitHostFree(initStruct, readbackRing);
+	}
+
+	static const DescriptorPoolRatio vkCmdInitDefaultPoolRatios[] =
+	{
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f }
+	};
+
+#define VKCMDINIT_MAX_SETS_PER_POOL 4096
+
+	DescriptorAllocator* createDescriptorAllocator(InitializationStruct* initStruct, /*can be null*/ const DescriptorPoolRatio* ratios, uint32_t ratioCount, uint32_t initialSetsPerPool)
+	{
+		if (!ratios)
+		{
+			ratios = vkCmdInitDefaultPoolRatios;
+			ratioCount = sizeof(vkCmdInitDefaultPoolRatios) / sizeof(vkCmdInitDefaultPoolRatios[0]);
+		}
+
+		DescriptorAllocator* descriptorAllocator = (DescriptorAllocator*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(DescriptorAllocator), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!descriptorAllocator)
+			return NULL;
+
+		descriptorAllocator->ratios = (DescriptorPoolRatio*)vkCmdInitHostAllocate(initStruct, sizeof(DescriptorPoolRatio) * ratioCount, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!descriptorAllocator->ratios)
+		{
+			vkCmdInitHostFree(initStruct, descriptorAllocator);
+			return NULL;
+		}
+		memcpy(descriptorAllocator->ratios, ratios, sizeof(DescriptorPoolRatio) * ratioCount);
+		descriptorAllocator->ratioCount = ratioCount;
+		descriptorAllocator->setsPerPool = initialSetsPerPool ? initialSetsPerPool : 64;
+		return descriptorAllocator;
+	}
+
+	static VkResult vkCmdInitNextDescriptorPool(InitializationStruct* initStruct, DescriptorAllocator* descriptorAllocator)
+	{
+		if (descriptorAllocator->currentPool)
+		{
+			if (!vkCmdInitReserve(initStruct, (void**)&descriptorAllocator->fullPools, &descriptorAllocator->fullPoolCapacity, descriptorAllocator->fullPoolCount + 1, sizeof(VkDescriptorPool), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+			descriptorAllocator->fullPools[descriptorAllocator->fullPoolCount++] = descriptorAllocator->currentPool;
+			descriptorAllocator->currentPool = VK_NULL_HANDLE;
+		}
+		descriptorAllocator->currentPoolSetCount = 0;
+
+		if (descriptorAllocator->freePoolCount)
+		{
+			descriptorAllocator->currentPool = descriptorAllocator->freePools[--descriptorAllocator->freePoolCount];
+			return VK_SUCCESS;
+		}
+
+		VkDescriptorPoolSize* poolSizes = (VkDescriptorPoolSize*)vkCmdInitHostAllocate(initStruct, sizeof(VkDescriptorPoolSize) * descriptorAllocator->ratioCount, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+		if (!poolSizes)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		uint32_t poolSizeCount = 0;
+		for (uint32_t i = 0; i < descriptorAllocator->ratioCount; ++i)
+		{
+			uint32_t descriptorCount = (uint32_t)(descriptorAllocator->ratios[i].ratio * (float)descriptorAllocator->setsPerPool + 0.999f);
+			if (!descriptorCount)
+				continue;
+			poolSizes[poolSizeCount].type = descriptorAllocator->ratios[i].type;
+			poolSizes[poolSizeCount].descriptorCount = descriptorCount;
+			poolSizeCount += 1;
+		}
+
+		VkDescriptorPoolCreateInfo poolCreateInfo = { ZERO };
+		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolCreateInfo.flags = descriptorAllocator->poolFlags;
+		poolCreateInfo.maxSets = descriptorAllocator->setsPerPool;
+		poolCreateInfo.poolSizeCount = poolSizeCount;
+		poolCreateInfo.pPoolSizes = poolSizes;
+
+		VkResult result = initStruct->deviceTable.vkCreateDescriptorPool(initStruct->device, &poolCreateInfo, initStruct->allocationCallbacks, &descriptorAllocator->currentPool);
+		vkCmdInitHostFree(initStruct, poolSizes);
+		if (result != VK_SUCCESS)
+			return result;
+
+		descriptorAllocator->poolCount += 1;
+		if (descriptorAllocator->setsPerPool < VKCMDINIT_MAX_SETS_PER_POOL)
+		{
+			descriptorAllocator->setsPerPool *= 2;
+			if (descriptorAllocator->setsPerPool > VKCMDINIT_MAX_SETS_PER_POOL)
+				descriptorAllocator->setsPerPool = VKCMDINIT_MAX_SETS_PER_POOL;
+		}
+		return VK_SUCCESS;
+	}
+
+	VkResult allocateDescriptorSet(InitializationStruct* initStruct, DescriptorAllocator* descriptorAllocator, VkDescriptorSetLayout layout, VkDescriptorSet* descriptorSet)
+	{
+		VkResult result = VK_SUCCESS;
+		if (!descriptorAllocator->currentPool)
+		{
+			result = vkCmdInitNextDescriptorPool(initStruct, descriptorAllocator);
+			if (result != VK_SUCCESS)
+				return result;
+		}
+
+		VkDescriptorSetAllocateInfo allocateInfo = { ZERO };
+		allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocateInfo.descriptorPool = descriptorAllocator->currentPool;
+		allocateInfo.descriptorSetCount = 1;
+		allocateInfo.pSetLayouts = &layout;
+		result = initStruct->deviceTable.vkAllocateDescriptorSets(initStruct->device, &allocateInfo, descriptorSet);
+
+		//Empty pool failing means layout doesn't fit ratios at all, retiring it would only pile up pools
+		if ((result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) && descriptorAllocator->currentPoolSetCount)
+		{
+			result = vkCmdInitNextDescriptorPool(initStruct, descriptorAllocator);
+			if (result != VK_SUCCESS)
+				return result;
+
+			allocateInfo.descriptorPool = descriptorAllocator->currentPool;
+			result = initStruct->deviceTable.vkAllocateDescriptorSets(initStruct->device, &allocateInfo, descriptorSet);
+		}
+
+		if (result == VK_ERROR_FRAGMENTED_POOL)
+			return VK_ERROR_OUT_OF_POOL_MEMORY;
+		if (result == VK_SUCCESS)
+		{
+			descriptorAllocator->currentPoolSetCount += 1;
+			descriptorAllocator->allocatedSetCount += 1;
+		}
+		return result;
+	}
+
+	void resetDescriptorAllocator(InitializationStruct* initStruct, DescriptorAllocator* descriptorAllocator)
+	{
+		if (!vkCmdInitReserve(initStruct, (void**)&descriptorAllocator->freePools, &descriptorAllocator->freePoolCapacity, descriptorAllocator->poolCount, sizeof(VkDescriptorPool), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return;
+
+		for (uint32_t i = 0; i < descriptorAllocator->fullPoolCount; ++i)
+		{
+			initStruct->deviceTable.vkResetDescriptorPool(initStruct->device, descriptorAllocator->fullPools[i], 0);
+			descriptorAllocator->freePools[descriptorAllocator->freePoolCount++] = descriptorAllocator->fullPools[i];
+		}
+		descriptorAllocator->fullPoolCount = 0;
+
+		//Current pool stays current, it's the largest one
+		if (descriptorAllocator->currentPool)
+			initStruct->deviceTable.vkResetDescriptorPool(initStruct->device, descriptorAllocator->currentPool, 0);
+		descriptorAllocator->currentPoolSetCount = 0;
+	}
+
+	void destroyDescriptorAllocator(InitializationStruct* initStruct, DescriptorAllocator* descriptorAllocator)
+	{
+		for (uint32_t i = 0; i < descriptorAllocator->fullPoolCount; ++i)
+			initStruct->deviceTable.vkDestroyDescriptorPool(initStruct->device, descriptorAllocator->fullPools[i], initStruct->allocationCallbacks);
+		for (uint32_t i = 0; i < descriptorAllocator->freePoolCount; ++i)
+			initStruct->deviceTable.vkDestroyDescriptorPool(initStruct->device, descriptorAllocator->freePools[i], initStruct->allocationCallbacks);
+		if (descriptorAllocator->currentPool)
+			initStruct->deviceTable.vkDestroyDescriptorPool(initStruct->device, descriptorAllocator->currentPool, initStruct->allocationCallbacks);
+
+		vkCmdInitHostFree(initStruct, descriptorAllocator->fullPools);
+		vkCmdInitHostFree(initStruct, descriptorAllocator->freePools);
+		vkCmdInitHostFree(initStruct, descriptorAllocator->ratios);
+		vkCmdInitHostFree(initStruct, descriptorAllocator);
+	}
+
+	//Handles are pointers on 64 bit and uint64_t on 32 bit platforms
+	static uint64_t vkCmdInitHandleBits(const void* handle, size_t size)
+	{
+		uint64_t bits = 0;
+		memcpy(&bits, handle, size);
+		return bits;
+	}
+
+#define VKCMDINIT_HANDLE_BITS(handle) vkCmdInitHandleBits(&(handle), sizeof(handle))
+
+	enum
+	{
+		VKCMDINIT_DESCRIPTOR_KEY_LAYOUT = 1,
+		VKCMDINIT_DESCRIPTOR_KEY_SET = 2
+	};
+
+	DescriptorCache* createDescriptorCache(InitializationStruct* initStruct)
+	{
+		DescriptorCache* descriptorCache = (DescriptorCache*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(DescriptorCache), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!descriptorCache)
+			return NULL;
+
+		descriptorCache->entryCapacity = 64;
+		descriptorCache->entries = (DescriptorCacheEntry*)vkCmdInitHostAllocateZeroed(initStruct, descriptorCache->entryCapacity, sizeof(DescriptorCacheEntry), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		descriptorCache->setAllocator = createDescriptorAllocator(initStruct, NULL, 0, 16);
+		if (!descriptorCache->entries || !descriptorCache->setAllocator)
+		{
+			destroyDescriptorCache(initStruct, descriptorCache);
+			return NULL;
+		}
+		return descriptorCache;
+	}
+
+	//Returns entry holding key, or empty slot it would be inserted into
+	static DescriptorCacheEntry* vkCmdInitFindDescriptorEntry(DescriptorCache* descriptorCache, uint64_t hash, const uint64_t* key, uint32_t keyWordCount)
+	{
+		uint32_t mask = descriptorCache->entryCapacity - 1;
+		for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask)
+		{
+			DescriptorCacheEntry* entry = &descriptorCache->entries[i];
+			if (!entry->hash)
+				return entry;
+			if (entry->hash == hash && entry->keyWordCount == keyWordCount && memcmp(entry->key, key, keyWordCount * sizeof(uint64_t)) == 0)
+				return entry;
+		}
+	}
+
+	//Keeps load factor under 3/4 so probes stay short
+	static bool vkCmdInitGrowDescriptorCache(const InitializationStruct* initStruct, DescriptorCache* descriptorCache)
+	{
+		if ((descriptorCache->entryCount + 1) * 4 <= descriptorCache->entryCapacity * 3)
+			return true;
+
+		DescriptorCacheEntry* oldEntries = descriptorCache->entries;
+		uint32_t oldCapacity = descriptorCache->entryCapacity;
+		DescriptorCacheEntry* newEntries = (DescriptorCacheEntry*)vkCmdInitHostAllocateZeroed(initStruct, oldCapacity * 2, sizeof(DescriptorCacheEntry), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!newEntries)
+			return false;
+
+		descriptorCache->entries = newEntries;
+		descriptorCache->entryCapacity = oldCapacity * 2;
+		for (uint32_t i = 0; i < oldCapacity; ++i)
+		{
+			if (oldEntries[i].hash)
+				*vkCmdInitFindDescriptorEntry(descriptorCache, oldEntries[i].hash, oldEntries[i].key, oldEntries[i].keyWordCount) = oldEntries[i];
+		}
+		vkCmdInitHostFree(initStruct, oldEntries);
+		return true;
+	}
+
+	//Looks key up, on hit frees key and returns entry. On miss entry takes ownership of key, caller fills in handle.
+	//NULL if out of memory, key is freed then as well
+	static DescriptorCacheEntry* vkCmdInitLookupDescriptorKey(const InitializationStruct* initStruct, DescriptorCache* descriptorCache, uint64_t* key, uint32_t keyWordCount, bool* hit)
+	{
+		uint64_t hash = vkCmdInitHash(key, keyWordCount * sizeof(uint64_t), VKCMDINIT_HASH_SEED);
+		if (!hash)
+			hash = 1;
+
+		DescriptorCacheEntry* entry = vkCmdInitFindDescriptorEntry(descriptorCache, hash, key, keyWordCount);
+		if (entry->hash)
+		{
+			vkCmdInitHostFree(initStruct, key);
+			descriptorCache->hitCount += 1;
+			*hit = true;
+			return entry;
+		}
+
+		if (!vkCmdInitGrowDescriptorCache(initStruct, descriptorCache))
+		{
+			vkCmdInitHostFree(initStruct, key);
+			return NULL;
+		}
+		entry = vkCmdInitFindDescriptorEntry(descriptorCache, hash, key, keyWordCount);
+		entry->hash = hash;
+		entry->key = key;
+		entry->keyWordCount = keyWordCount;
+		entry->layout = VK_NULL_HANDLE;
+		entry->set = VK_NULL_HANDLE;
+		descriptorCache->entryCount += 1;
+		descriptorCache->missCount += 1;
+		*hit = false;
+		return entry;
+	}
+
+	//Failed creation leaves entry behind, remove it again. Rebuilds cluster following it so probing still finds moved entries
+	static void vkCmdInitRemoveDescriptorEntry(const InitializationStruct* initStruct, DescriptorCache* descriptorCache, DescriptorCacheEntry* entry)
+	{
+		uint32_t mask = descriptorCache->entryCapacity - 1;
+		uint32_t index = (uint32_t)(entry - descriptorCache->entries);
+		vkCmdInitHostFree(initStruct, entry->key);
+		entry->hash = 0;
+		descriptorCache->entryCount -= 1;
+
+		for (uint32_t i = (index + 1) & mask; descriptorCache->entries[i].hash; i = (i + 1) & mask)
+		{
+			DescriptorCacheEntry moved = descriptorCache->entries[i];
+			descriptorCache->entries[i].hash = 0;
+			*vkCmdInitFindDescriptorEntry(descriptorCache, moved.hash, moved.key, moved.keyWordCount) = moved;
+		}
+	}
+
+	VkDescriptorSetLayout getDescriptorSetLayout(InitializationStruct* initStruct, DescriptorCache* descriptorCache, const VkDescriptorSetLayoutBinding* bindings, uint32_t bindingCount, VkDescriptorSetLayoutCreateFlags flags)
+	{
+		uint32_t keyWordCount = 3;
+		for (uint32_t i = 0; i < bindingCount; ++i)
+			keyWordCount += 4 + (bindings[i].pImmutableSamplers ? bindings[i].descriptorCount : 0);
+
+		uint64_t* key = (uint64_t*)vkCmdInitHostAllocate(initStruct, keyWordCount * sizeof(uint64_t), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!key)
+			return VK_NULL_HANDLE;
+
+		uint32_t word = 0;
+		key[word++] = VKCMDINIT_DESCRIPTOR_KEY_LAYOUT;
+		key[word++] = flags;
+		key[word++] = bindingCount;
+		for (uint32_t i = 0; i < bindingCount; ++i)
+		{
+			key[word++] = bindings[i].binding;
+			key[word++] = (uint64_t)bindings[i].descriptorType;
+			key[word++] = ((uint64_t)bindings[i].descriptorCount << 32) | bindings[i].stageFlags;
+			key[word++] = bindings[i].pImmutableSamplers ? 1 : 0;
+			for (uint32_t j = 0; bindings[i].pImmutableSamplers && j < bindings[i].descriptorCount; ++j)
+				key[word++] = VKCMDINIT_HANDLE_BITS(bindings[i].pImmutableSamplers[j]);
+		}
+
+		bool hit;
+		DescriptorCacheEntry* entry = vkCmdInitLookupDescriptorKey(initStruct, descriptorCache, key, keyWordCount, &hit);
+		if (!entry)
+			return VK_NULL_HANDLE;
+		if (hit)
+			return entry->layout;
+
+		VkDescriptorSetLayoutCreateInfo layoutCreateInfo = { ZERO };
+		layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutCreateInfo.flags = flags;
+		layoutCreateInfo.bindingCount = bindingCount;
+		layoutCreateInfo.pBindings = bindings;
+
+		if (initStruct->deviceTable.vkCreateDescriptorSetLayout(initStruct->device, &layoutCreateInfo, initStruct->allocationCallbacks, &entry->layout) != VK_SUCCESS)
+		{
+			vkCmdInitRemoveDescriptorEntry(initStruct, descriptorCache, entry);
+			return VK_NULL_HANDLE;
+		}
+		return entry->layout;
+	}
+
+	static bool vkCmdInitIsBufferDescriptor(VkDescriptorType type)
+	{
+		return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+			type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	}
+
+	static bool vkCmdInitIsTexelBufferDescriptor(VkDescriptorType type)
+	{
+		return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+	}
+
+	VkDescriptorSet getImmutableDescriptorSet(InitializationStruct* initStruct, DescriptorCache* descriptorCache, VkDescriptorSetLayout layout, const DescriptorWrite* writes, uint32_t writeCount)
+	{
+		uint32_t keyWordCount = 3 + writeCount * 6;
+		uint64_t* key = (uint64_t*)vkCmdInitHostAllocate(initStruct, keyWordCount * sizeof(uint64_t), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!key)
+			return VK_NULL_HANDLE;
+
+		//Only hash fields the descriptor type actually reads, garbage in the others must not cause misses
+		uint32_t word = 0;
+		key[word++] = VKCMDINIT_DESCRIPTOR_KEY_SET;
+		key[word++] = VKCMDINIT_HANDLE_BITS(layout);
+		key[word++] = writeCount;
+		for (uint32_t i = 0; i < writeCount; ++i)
+		{
+			key[word++] = ((uint64_t)writes[i].binding << 32) | writes[i].arrayElement;
+			key[word++] = (uint64_t)writes[i].type;
+			if (vkCmdInitIsBufferDescriptor(writes[i].type))
+			{
+				key[word++] = VKCMDINIT_HANDLE_BITS(writes[i].bufferInfo.buffer);
+				key[word++] = writes[i].bufferInfo.offset;
+				key[word++] = writes[i].bufferInfo.range;
+				key[word++] = 0;
+			}
+			else if (vkCmdInitIsTexelBufferDescriptor(writes[i].type))
+			{
+				key[word++] = VKCMDINIT_HANDLE_BITS(writes[i].texelBufferView);
+				key[word++] = 0;
+				key[word++] = 0;
+				key[word++] = 0;
+			}
+			else
+			{
+				key[word++] = VKCMDINIT_HANDLE_BITS(writes[i].imageInfo.sampler);
+				key[word++] = VKCMDINIT_HANDLE_BITS(writes[i].imageInfo.imageView);
+				key[word++] = (uint64_t)writes[i].imageInfo.imageLayout;
+				key[word++] = 0;
+			}
+		}
+
+		bool hit;
+		DescriptorCacheEntry* entry = vkCmdInitLookupDescriptorKey(initStruct, descriptorCache, key, keyWordCount, &hit);
+		if (!entry)
+			return VK_NULL_HANDLE;
+		if (hit)
+			return entry->set;
+
+		VkWriteDescriptorSet* descriptorWrites = (VkWriteDescriptorSet*)vkCmdInitHostAllocateZeroed(initStruct, writeCount, sizeof(VkWriteDescriptorSet), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+		if (!descriptorWrites || allocateDescriptorSet(initStruct, descriptorCache->setAllocator, layout, &entry->set) != VK_SUCCESS)
+		{
+			vkCmdInitHostFree(initStruct, descriptorWrites);
+			vkCmdInitRemoveDescriptorEntry(initStruct, descriptorCache, entry);
+			return VK_NULL_HANDLE;
+		}
+
+		for (uint32_t i = 0; i < writeCount; ++i)
+		{
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = entry->set;
+			descriptorWrites[i].dstBinding = writes[i].binding;
+			descriptorWrites[i].dstArrayElement = writes[i].arrayElement;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].descriptorType = writes[i].type;
+			if (vkCmdInitIsBufferDescriptor(writes[i].type))
+				descriptorWrites[i].pBufferInfo = &writes[i].bufferInfo;
+			else if (vkCmdInitIsTexelBufferDescriptor(writes[i].type))
+				descriptorWrites[i].pTexelBufferView = &writes[i].texelBufferView;
+			else
+				descriptorWrites[i].pImageInfo = &writes[i].imageInfo;
+		}
+		initStruct->deviceTable.vkUpdateDescriptorSets(initStruct->device, writeCount, descriptorWrites, 0, NULL);
+		vkCmdInitHostFree(initStruct, descriptorWrites);
+		return entry->set;
+	}
+
+	void destroyDescriptorCache(InitializationStruct* initStruct, DescriptorCache* descriptorCache)
+	{
+		for (uint32_t i = 0; descriptorCache->entries && i < descriptorCache->entryCapacity; ++i)
+		{
+			//Removed and moved entries leave stale key pointers behind, only live ones own theirs
+			DescriptorCacheEntry* entry = &descriptorCache->entries[i];
+			if (!entry->hash)
+				continue;
+			if (entry->layout)
+				initStruct->deviceTable.vkDestroyDescriptorSetLayout(initStruct->device, entry->layout, initStruct->allocationCallbacks);
+			vkCmdInitHostFree(initStruct, entry->key);
+		}
+		if (descriptorCache->setAllocator)
+			destroyDescriptorAllocator(initStruct, descriptorCache->setAllocator);
+		vkCmdInitHostFree(initStruct, descriptorCache->entries);
+		vkCmdInitHostFree(initStruct, descriptorCache);
+	}
+
+	static const VkDescriptorType vkCmdInitBindlessDescriptorTypes[BINDLESS_RESOURCE_TYPE_COUNT] =
+	{
+		VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_SAMPLER
+	};
+
+	BindlessTable* createBindlessTable(InitializationStruct* initStruct, uint32_t maxSampledImages, uint32_t maxStorageBuffers, uint32_t maxSamplers)
+	{
+		BindlessTable* bindlessTable = (BindlessTable*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(BindlessTable), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!bindlessTable)
+			return NULL;
+		bindlessTable->capacities[BINDLESS_RESOURCE_TYPE_SAMPLED_IMAGE] = maxSampledImages;
+		bindlessTable->capacities[BINDLESS_RESOURCE_TYPE_STORAGE_BUFFER] = maxStorageBuffers;
+		bindlessTable->capacities[BINDLESS_RESOURCE_TYPE_SAMPLER] = maxSamplers;
+
+		VkDescriptorSetLayoutBinding bindings[BINDLESS_RESOURCE_TYPE_COUNT];
+		VkDescriptorBindingFlags bindingFlags[BINDLESS_RESOURCE_TYPE_COUNT];
+		VkDescriptorPoolSize poolSizes[BINDLESS_RESOURCE_TYPE_COUNT];
+		uint32_t poolSizeCount = 0;
+		bool allocated = true;
+		for (uint32_t i = 0; i < BINDLESS_RESOURCE_TYPE_COUNT; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = vkCmdInitBindlessDescriptorTypes[i];
+			bindings[i].descriptorCount = bindlessTable->capacities[i];
+			bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+			bindings[i].pImmutableSamplers = NULL;
+
+			//Unused indices are never written, update-after-bind lets new resources appear while frames using the set are in flight
+			bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+			if (bindlessTable->capacities[i])
+			{
+				poolSizes[poolSizeCount].type = vkCmdInitBindlessDescriptorTypes[i];
+				poolSizes[poolSizeCount].descriptorCount = bindlessTable->capacities[i];
+				poolSizeCount += 1;
+
+				bindlessTable->freeIndices[i] = (uint32_t*)vkCmdInitHostAllocate(initStruct, sizeof(uint32_t) * bindlessTable->capacities[i], VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+				bindlessTable->freeMasks[i] = (uint32_t*)vkCmdInitHostAllocateZeroed(initStruct, (bindlessTable->capacities[i] + 31) / 32, sizeof(uint32_t), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+				allocated = allocated && bindlessTable->freeIndices[i] && bindlessTable->freeMasks[i];
+			}
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = { ZERO };
+		bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsCreateInfo.bindingCount = BINDLESS_RESOURCE_TYPE_COUNT;
+		bindingFlagsCreateInfo.pBindingFlags = bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutCreateInfo = { ZERO };
+		layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+		layoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutCreateInfo.bindingCount = BINDLESS_RESOURCE_TYPE_COUNT;
+		layoutCreateInfo.pBindings = bindings;
+
+		VkDescriptorPoolCreateInfo poolCreateInfo = { ZERO };
+		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolCreateInfo.maxSets = 1;
+		poolCreateInfo.poolSizeCount = poolSizeCount;
+		poolCreateInfo.pPoolSizes = poolSizes;
+
+		VkResult result = allocated ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+		if (result == VK_SUCCESS)
+			result = initStruct->deviceTable.vkCreateDescriptorSetLayout(initStruct->device, &layoutCreateInfo, initStruct->allocationCallbacks, &bindlessTable->layout);
+		if (result == VK_SUCCESS)
+			result = initStruct->deviceTable.vkCreateDescriptorPool(initStruct->device, &poolCreateInfo, initStruct->allocationCallbacks, &bindlessTable->pool);
+		if (result == VK_SUCCESS)
+		{
+			VkDescriptorSetAllocateInfo allocateInfo = { ZERO };
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.descriptorPool = bindlessTable->pool;
+			allocateInfo.descriptorSetCount = 1;
+			allocateInfo.pSetLayouts = &bindlessTable->layout;
+			result = initStruct->deviceTable.vkAllocateDescriptorSets(initStruct->device, &allocateInfo, &bindlessTable->set);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			destroyBindlessTable(initStruct, bindlessTable);
+			return NULL;
+		}
+		return bindlessTable;
+	}
+
+	static uint32_t vkCmdInitBindlessIndex(BindlessTable* bindlessTable, BindlessResourceType type)
+	{
+		if (bindlessTable->freeIndexCounts[type])
+		{
+			uint32_t index = bindlessTable->freeIndices[type][--bindlessTable->freeIndexCounts[type]];
+			bindlessTable->freeMasks[type][index / 32] &= ~(1u << (index % 32));
+			return index;
+		}
+		if (bindlessTable->usedCounts[type] < bindlessTable->capacities[type])
+			return bindlessTable->usedCounts[type]++;
+		return UINT32_MAX;
+	}
+
+	static uint32_t vkCmdInitBindlessWrite(InitializationStruct* initStruct, BindlessTable* bindlessTable, BindlessResourceType type, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo)
+	{
+		uint32_t index = vkCmdInitBindlessIndex(bindlessTable, type);
+		if (index == UINT32_MAX)
+			return UINT32_MAX;
+
+		VkWriteDescriptorSet descriptorWrite = { ZERO };
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = bindlessTable->set;
+		descriptorWrite.dstBinding = (uint32_t)type;
+		descriptorWrite.dstArrayElement = index;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.descriptorType = vkCmdInitBindlessDescriptorTypes[type];
+		descriptorWrite.pImageInfo = imageInfo;
+		descriptorWrite.pBufferInfo = bufferInfo;
+		initStruct->deviceTable.vkUpdateDescriptorSets(initStruct->device, 1, &descriptorWrite, 0, NULL);
+		return index;
+	}
+
+	uint32_t bindlessAddImage(InitializationStruct* initStruct, BindlessTable* bindlessTable, VkImageView imageView, VkImageLayout imageLayout)
+	{
+		VkDescriptorImageInfo imageInfo = { ZERO };
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = imageLayout;
+		return vkCmdInitBindlessWrite(initStruct, bindlessTable, BINDLESS_RESOURCE_TYPE_SAMPLED_IMAGE, &imageInfo, NULL);
+	}
+
+	uint32_t bindlessAddBuffer(InitializationStruct* initStruct, BindlessTable* bindlessTable, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+	{
+		VkDescriptorBufferInfo bufferInfo = { ZERO };
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = range;
+		return vkCmdInitBindlessWrite(initStruct, bindlessTable, BINDLESS_RESOURCE_TYPE_STORAGE_BUFFER, NULL, &bufferInfo);
+	}
+
+	uint32_t bindlessAddSampler(InitializationStruct* initStruct, BindlessTable* bindlessTable, VkSampler sampler)
+	{
+		VkDescriptorImageInfo imageInfo = { ZERO };
+		imageInfo.sampler = sampler;
+		return vkCmdInitBindlessWrite(initStruct, bindlessTable, BINDLESS_RESOURCE_TYPE_SAMPLER, &imageInfo, NULL);
+	}
+
+	void bindlessRemove(BindlessTable* bindlessTable, BindlessResourceType type, uint32_t index)
+	{
+		if (type >= BINDLESS_RESOURCE_TYPE_COUNT || index >= bindlessTable->usedCounts[type])
+			return;
+
+		//Second remove would hand index out twice
+		uint32_t bit = 1u << (index % 32);
+		if (bindlessTable->freeMasks[type][index / 32] & bit)
+			return;
+
+		//Partially bound, stale descriptor stays in place until index is handed out again
+		bindlessTable->freeMasks[type][index / 32] |= bit;
+		bindlessTable->freeIndices[type][bindlessTable->freeIndexCounts[type]++] = index;
+	}
+
+	void destroyBindlessTable(InitializationStruct* initStruct, BindlessTable* bindlessTable)
+	{
+		if (bindlessTable->pool)
+			initStruct->deviceTable.vkDestroyDescriptorPool(initStruct->device, bindlessTable->pool, initStruct->allocationCallbacks);
+		if (bindlessTable->layout)
+			initStruct->deviceTable.vkDestroyDescriptorSetLayout(initStruct->device, bindlessTable->layout, initStruct->allocationCallbacks);
+		for (uint32_t i = 0; i < BINDLESS_RESOURCE_TYPE_COUNT; ++i)
+		{
+			vkCmdInitHostFree(initStruct, bindlessTable->freeIndices[i]);
+			vkCmdInitHostFree(initStruct, bindlessTable->freeMasks[i]);
+		}
+		vkCmdInitHostFree(initStruct, bindlessTable);
+	}
+
+	//Thread runs function(argument), entry has to stay alive until thread is joined
+	typedef struct VkCmdInitThreadEntry
+	{
+		void (*function)(void* argument);
+		void* argument;
+	} VkCmdInitThreadEntry;
+
+#ifdef _WIN32
+	typedef HANDLE VkCmdInitThread;
+	typedef SRWLOCK VkCmdInitMutex;
+	typedef CONDITION_VARIABLE VkCmdInitCondition;
+
+	static void vkCmdInitMutexInit(VkCmdInitMutex* mutex) { InitializeSRWLock(mutex); }
+	static void vkCmdInitMutexDestroy(VkCmdInitMutex* mutex) { (void)mutex; }
+	static void vkCmdInitMutexLock(VkCmdInitMutex* mutex) { AcquireSRWLockExclusive(mutex); }
+	static void vkCmdInitMutexUnlock(VkCmdInitMutex* mutex) { ReleaseSRWLockExclusive(mutex); }
+	static void vkCmdInitConditionInit(VkCmdInitCondition* condition) { InitializeConditionVariable(condition); }
+	static void vkCmdInitConditionDestroy(VkCmdInitCondition* condition) { (void)condition; }
+	static void vkCmdInitConditionWait(VkCmdInitCondition* condition, VkCmdInitMutex* mutex) { SleepConditionVariableSRW(condition, mutex, INFINITE, 0); }
+	static void vkCmdInitConditionWaitFor(VkCmdInitCondition* condition, VkCmdInitMutex* mutex, uint32_t milliseconds) { SleepConditionVariableSRW(condition, mutex, milliseconds, 0); }
+	static void vkCmdInitConditionSignal(VkCmdInitCondition* condition) { WakeConditionVariable(condition); }
+	static void vkCmdInitConditionBroadcast(VkCmdInitCondition* condition) { WakeAllConditionVariable(condition); }
+
+	static uint32_t vkCmdInitCoreCount(void)
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		return systemInfo.dwNumberOfProcessors ? (uint32_t)systemInfo.dwNumberOfProcessors : 1;
+	}
+
+	static DWORD WINAPI vkCmdInitThreadMain(LPVOID argument);
+
+	static bool vkCmdInitThreadStart(VkCmdInitThread* thread, VkCmdInitThreadEntry* entry)
+	{
+		*thread = CreateThread(NULL, 0, vkCmdInitThreadMain, entry, 0, NULL);
+		return *thread != NULL;
+	}
+
+	static void vkCmdInitThreadJoin(VkCmdInitThread thread)
+	{
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+	}
+#else
+	typedef pthread_t VkCmdInitThread;
+	typedef pthread_mutex_t VkCmdInitMutex;
+	typedef pthread_cond_t VkCmdInitCondition;
+
+	static void vkCmdInitMutexInit(VkCmdInitMutex* mutex) { pthread_mutex_init(mutex, NULL); }
+	static void vkCmdInitMutexDestroy(VkCmdInitMutex* mutex) { pthread_mutex_destroy(mutex); }
+	static void vkCmdInitMutexLock(VkCmdInitMutex* mutex) { pthread_mutex_lock(mutex); }
+	static void vkCmdInitMutexUnlock(VkCmdInitMutex* mutex) { pthread_mutex_unlock(mutex); }
+	static void vkCmdInitConditionInit(VkCmdInitCondition* condition) { pthread_cond_init(condition, NULL); }
+	static void vkCmdInitConditionDestroy(VkCmdInitCondition* condition) { pthread_cond_destroy(condition); }
+	static void vkCmdInitConditionWait(VkCmdInitCondition* condition, VkCmdInitMutex* mutex) { pthread_cond_wait(condition, mutex); }
+
+	static void vkCmdInitConditionWaitFor(VkCmdInitCondition* condition, VkCmdInitMutex* mutex, uint32_t milliseconds)
+	{
+		//Condition waits on CLOCK_REALTIME by default, which is what TIME_UTC reads
+		struct timespec deadline;
+		timespec_get(&deadline, TIME_UTC);
+		deadline.tv_sec += milliseconds / 1000;
+		deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+		if (deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+		pthread_cond_timedwait(condition, mutex, &deadline);
+	}
+	static void vkCmdInitConditionSignal(VkCmdInitCondition* condition) { pthread_cond_signal(condition); }
+	static void vkCmdInitConditionBroadcast(VkCmdInitCondition* condition) { pthread_cond_broadcast(condition); }
+
+	static uint32_t vkCmdInitCoreCount(void)
+	{
+		long coreCount = sysconf(_SC_NPROCESSORS_ONLN);
+		return coreCount > 0 ? (uint32_t)coreCount : 1;
+	}
+
+	static void* vkCmdInitThreadMain(void* argument);
+
+	static bool vkCmdInitThreadStart(VkCmdInitThread* thread, VkCmdInitThreadEntry* entry)
+	{
+		return pthread_create(thread, NULL, vkCmdInitThreadMain, entry) == 0;
+	}
+
+	static void vkCmdInitThreadJoin(VkCmdInitThread thread)
+	{
+		pthread_join(thread, NULL);
+	}
+#endif
+
+#if defined(__cplusplus)
+#define VKCMDINIT_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define VKCMDINIT_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define VKCMDINIT_THREAD_LOCAL __thread
+#else
+#define VKCMDINIT_THREAD_LOCAL _Thread_local
+#endif
+
+	typedef struct VkCmdInitJob
+	{
+		JobFunction function;
+		void* userData;
+		JobCounter* counter;
+	} VkCmdInitJob;
+
+	//Ring with monotonic top/bottom, owner pushes and pops at bottom, thieves take from top
+	typedef struct VkCmdInitJobDeque
+	{
+		VkCmdInitMutex mutex;
+		VkCmdInitJob* jobs;
+		uint32_t capacity; //power of 2
+		uint32_t top;
+		uint32_t bottom;
+	} VkCmdInitJobDeque;
+
+	typedef struct VkCmdInitWorker
+	{
+		JobSystem* jobSystem;
+		uint32_t index;
+		VkCmdInitThreadEntry entry;
+		VkCmdInitThread thread;
+		bool started;
+	} VkCmdInitWorker;
+
+	struct JobSystem
+	{
+		uint32_t workerCount;
+		VkCmdInitWorker* workers;
+		VkCmdInitJobDeque* deques;
+
+		//Every queued job is reserved by exactly one worker before it goes looking for it, so a worker that reserved one always
+		//finds a job in some deque. Mutex is taken only to sleep and wake, it guards stopping
+		volatile long queuedJobCount;
+		volatile long sleepingWorkerCount;
+		VkCmdInitMutex mutex;
+		VkCmdInitCondition workAvailable;
+		VkCmdInitCondition jobsFinished;
+		bool stopping;
+
+		volatile long nextDeque; //round robin target of submitJob outside of workers
+	};
+
+	//Worker running on this thread, lets submitJob push to its own deque
+	static VKCMDINIT_THREAD_LOCAL VkCmdInitWorker* vkCmdInitCurrentWorker;
+
+	static bool vkCmdInitReserveJob(JobSystem* jobSystem)
+	{
+		long queued = VKCMDINIT_ATOMIC_LOAD(&jobSystem->queuedJobCount);
+		while (queued > 0)
+		{
+			if (VKCMDINIT_ATOMIC_CAS(&jobSystem->queuedJobCount, queued, queued - 1))
+				return true;
+			queued = VKCMDINIT_ATOMIC_LOAD(&jobSystem->queuedJobCount);
+		}
+		return false;
+	}
+
+	static bool vkCmdInitPopJob(VkCmdInitJobDeque* deque, VkCmdInitJob* job, bool steal)
+	{
+		bool found = false;
+		vkCmdInitMutexLock(&deque->mutex);
+		if (deque->bottom != deque->top)
+		{
+			//Own jobs newest first while their data is still in cache, stolen ones oldest first
+			if (steal)
+				*job = deque->jobs[deque->top++ & (deque->capacity - 1)];
+			else
+				*job = deque->jobs[--deque->bottom & (deque->capacity - 1)];
+			found = true;
+		}
+		vkCmdInitMutexUnlock(&deque->mutex);
+		return found;
+	}
+
+	static void vkCmdInitWorkerLoop(void* argument)
+	{
+		VkCmdInitWorker* worker = (VkCmdInitWorker*)argument;
+		JobSystem* jobSystem = worker->jobSystem;
+		vkCmdInitCurrentWorker = worker;
+		for (;;)
+		{
+			if (!vkCmdInitReserveJob(jobSystem))
+			{
+				//Counts are read with read-modify-write like in submitJob, so either submitter sees this worker sleeping or
+				//this worker sees its job
+				vkCmdInitMutexLock(&jobSystem->mutex);
+				VKCMDINIT_ATOMIC_ADD(&jobSystem->sleepingWorkerCount, 1);
+				while (VKCMDINIT_ATOMIC_ADD(&jobSystem->queuedJobCount, 0) == 0 && !jobSystem->stopping)
+					vkCmdInitConditionWait(&jobSystem->workAvailable, &jobSystem->mutex);
+				VKCMDINIT_ATOMIC_ADD(&jobSystem->sleepingWorkerCount, -1);
+				bool stop = jobSystem->stopping && VKCMDINIT_ATOMIC_ADD(&jobSystem->queuedJobCount, 0) == 0;
+				vkCmdInitMutexUnlock(&jobSystem->mutex);
+				if (stop)
+					return;
+				continue;
+			}
+
+			VkCmdInitJob job;
+			bool found = vkCmdInitPopJob(&jobSystem->deques[worker->index], &job, false);
+			for (uint32_t i = 1; !found; ++i)
+				found = vkCmdInitPopJob(&jobSystem->deques[(worker->index + i) % jobSystem->workerCount], &job, true);
+
+			job.function(job.userData, worker->index);
+
+			if (job.counter && VKCMDINIT_ATOMIC_ADD(&job.counter->pendingJobCount, -1) == 0)
+			{
+				vkCmdInitMutexLock(&jobSystem->mutex);
+				vkCmdInitConditionBroadcast(&jobSystem->jobsFinished);
+				vkCmdInitMutexUnlock(&jobSystem->mutex);
+			}
+		}
+	}
+
+#ifdef _WIN32
+	static DWORD WINAPI vkCmdInitThreadMain(LPVOID argument)
+#else
+	static void* vkCmdInitThreadMain(void* argument)
+#endif
+	{
+		VkCmdInitThreadEntry* entry = (VkCmdInitThreadEntry*)argument;
+		entry->function(entry->argument);
+		return 0;
+	}
+
+	JobSystem* createJobSystem(uint32_t workerCount)
+	{
+		JobSystem* jobSystem = (JobSystem*)calloc(1, sizeof(JobSystem));
+		if (!jobSystem)
+			return NULL;
+
+		jobSystem->workerCount = workerCount ? workerCount : vkCmdInitCoreCount();
+		jobSystem->workers = (VkCmdInitWorker*)calloc(jobSystem->workerCount, sizeof(VkCmdInitWorker));
+		jobSystem->deques = (VkCmdInitJobDeque*)calloc(jobSystem->workerCount, sizeof(VkCmdInitJobDeque));
+		vkCmdInitMutexInit(&jobSystem->mutex);
+		vkCmdInitConditionInit(&jobSystem->workAvailable);
+		vkCmdInitConditionInit(&jobSystem->jobsFinished);
+		//destroyJobSystem tears down deque mutexes whenever deques exist, so they're initialized before anything can fail
+		for (uint32_t i = 0; jobSystem->deques && i < jobSystem->workerCount; ++i)
+			vkCmdInitMutexInit(&jobSystem->deques[i].mutex);
+		if (!jobSystem->workers || !jobSystem->deques)
+		{
+			destroyJobSystem(jobSystem);
+			return NULL;
+		}
+
+		for (uint32_t i = 0; i < jobSystem->workerCount; ++i)
+		{
+			jobSystem->workers[i].jobSystem = jobSystem;
+			jobSystem->workers[i].index = i;
+			jobSystem->workers[i].entry.function = vkCmdInitWorkerLoop;
+			jobSystem->workers[i].entry.argument = &jobSystem->workers[i];
+			jobSystem->workers[i].started = vkCmdInitThreadStart(&jobSystem->workers[i].thread, &jobSystem->workers[i].entry);
+			if (!jobSystem->workers[i].started)
+			{
+				destroyJobSystem(jobSystem);
+				return NULL;
+			}
+		}
+		return jobSystem;
+	}
+
+	uint32_t getJobWorkerCount(const JobSystem* jobSystem)
+	{
+		return jobSystem->workerCount;
+	}
+
+	bool submitJob(JobSystem* jobSystem, JobFunction function, void* userData, /*can be null*/ JobCounter* counter)
+	{
+		//Job submitted from a job likely works on same data, keep it on this worker unless others are idle and steal it
+		VkCmdInitWorker* worker = vkCmdInitCurrentWorker;
+		uint32_t dequeIndex = worker && worker->jobSystem == jobSystem ? worker->index : (uint32_t)VKCMDINIT_ATOMIC_ADD(&jobSystem->nextDeque, 1) % jobSystem->workerCount;
+		VkCmdInitJobDeque* deque = &jobSystem->deques[dequeIndex];
+
+		vkCmdInitMutexLock(&deque->mutex);
+		if (deque->bottom - deque->top == deque->capacity)
+		{
+			uint32_t newCapacity = deque->capacity ? deque->capacity * 2 : 64;
+			VkCmdInitJob* newJobs = (VkCmdInitJob*)malloc(sizeof(VkCmdInitJob) * newCapacity);
+			if (!newJobs)
+			{
+				vkCmdInitMutexUnlock(&deque->mutex);
+				return false;
+			}
+			uint32_t jobCount = deque->bottom - deque->top;
+			for (uint32_t i = 0; i < jobCount; ++i)
+				newJobs[i] = deque->jobs[(deque->top + i) & (deque->capacity - 1)];
+			free(deque->jobs);
+			deque->jobs = newJobs;
+			deque->capacity = newCapacity;
+			deque->top = 0;
+			deque->bottom = jobCount;
+		}
+
+		//Counted before job becomes visible, otherwise waitJobCounter could see 0 while it's still queued
+		if (counter)
+			VKCMDINIT_ATOMIC_ADD(&counter->pendingJobCount, 1);
+
+		VkCmdInitJob* job = &deque->jobs[deque->bottom++ & (deque->capacity - 1)];
+		job->function = function;
+		job->userData = userData;
+		job->counter = counter;
+		vkCmdInitMutexUnlock(&deque->mutex);
+
+		//Mutex only if someone sleeps, busy workers pick the job up on their own
+		VKCMDINIT_ATOMIC_ADD(&jobSystem->queuedJobCount, 1);
+		if (VKCMDINIT_ATOMIC_ADD(&jobSystem->sleepingWorkerCount, 0) != 0)
+		{
+			vkCmdInitMutexLock(&jobSystem->mutex);
+			vkCmdInitConditionSignal(&jobSystem->workAvailable);
+			vkCmdInitMutexUnlock(&jobSystem->mutex);
+		}
+		return true;
+	}
+
+	void waitJobCounter(JobSystem* jobSystem, JobCounter* counter)
+	{
+		vkCmdInitMutexLock(&jobSystem->mutex);
+		while (VKCMDINIT_ATOMIC_LOAD(&counter->pendingJobCount) != 0)
+			vkCmdInitConditionWait(&jobSystem->jobsFinished, &jobSystem->mutex);
+		vkCmdInitMutexUnlock(&jobSystem->mutex);
+	}
+
+	void destroyJobSystem(JobSystem* jobSystem)
+	{
+		vkCmdInitMutexLock(&jobSystem->mutex);
+		jobSystem->stopping = true;
+		vkCmdInitConditionBroadcast(&jobSystem->workAvailable);
+		vkCmdInitMutexUnlock(&jobSystem->mutex);
+
+		for (uint32_t i = 0; jobSystem->workers && i < jobSystem->workerCount; ++i)
+		{
+			if (jobSystem->workers[i].started)
+				vkCmdInitThreadJoin(jobSystem->workers[i].thread);
+		}
+
+		for (uint32_t i = 0; jobSystem->deques && i < jobSystem->workerCount; ++i)
+		{
+			vkCmdInitMutexDestroy(&jobSystem->deques[i].mutex);
+			free(jobSystem->deques[i].jobs);
+		}
+		vkCmdInitConditionDestroy(&jobSystem->jobsFinished);
+		vkCmdInitConditionDestroy(&jobSystem->workAvailable);
+		vkCmdInitMutexDestroy(&jobSystem->mutex);
+		free(jobSystem->deques);
+		free(jobSystem->workers);
+		free(jobSystem);
+	}
+
+	bool pollJobCounter(const JobCounter* counter)
+	{
+		return VKCMDINIT_ATOMIC_LOAD(&counter->pendingJobCount) == 0;
+	}
+
+	typedef struct VkCmdInitAsyncShader
+	{
+		AsyncInit* asyncInit;
+		AsyncShaderRequest* request;
+		VkCmdInitMappedFile mappedFile;
+	} VkCmdInitAsyncShader;
+
+	struct AsyncInit
+	{
+		InitializationStruct* initStruct;
+		JobSystem* jobSystem;
+		JobCounter fileCounter; //disk reads, overlap vkCreateDevice
+		JobCounter createCounter; //pipeline cache and shader modules, overlap app's swapchain and first frames
+
+		VkPhysicalDeviceProperties properties;
+		VkCmdInitMappedFile pipelineCacheFile;
+		PipelineCacheLoadResult pipelineCacheLoadResult;
+
+		VkCmdInitAsyncShader* shaders; //right after AsyncInit in the same allocation
+		uint32_t shaderCount;
+	};
+
+	//Init can't be left half done, so job runs on calling thread if it can't be queued
+	static void vkCmdInitRunJob(JobSystem* jobSystem, JobFunction function, void* userData, JobCounter* counter)
+	{
+		if (!submitJob(jobSystem, function, userData, counter))
+			function(userData, 0);
+	}
+
+	static void vkCmdInitAsyncMapPipelineCache(void* userData, uint32_t workerIndex)
+	{
+		AsyncInit* asyncInit = (AsyncInit*)userData;
+		asyncInit->pipelineCacheLoadResult = vkCmdInitMapPipelineCache(asyncInit->initStruct->pipelineCachePath, &asyncInit->properties, &asyncInit->pipelineCacheFile);
+	}
+
+	static void vkCmdInitAsyncCreatePipelineCache(void* userData, uint32_t workerIndex)
+	{
+		AsyncInit* asyncInit = (AsyncInit*)userData;
+		vkCmdInitCreatePipelineCacheFrom(asyncInit->initStruct, &asyncInit->pipelineCacheFile, asyncInit->pipelineCacheLoadResult);
+		vkCmdInitUnmapFile(&asyncInit->pipelineCacheFile);
+	}
+
+	static void vkCmdInitAsyncMapShader(void* userData, uint32_t workerIndex)
+	{
+		VkCmdInitAsyncShader* shader = (VkCmdInitAsyncShader*)userData;
+		vkCmdInitMapFile(shader->request->path, &shader->mappedFile);
+	}
+
+	static void vkCmdInitAsyncCreateShader(void* userData, uint32_t workerIndex)
+	{
+		VkCmdInitAsyncShader* shader = (VkCmdInitAsyncShader*)userData;
+		InitializationStruct* initStruct = shader->asyncInit->initStruct;
+
+		uint32_t magic = 0;
+		if (shader->mappedFile.size >= sizeof(magic))
+			memcpy(&magic, shader->mappedFile.data, sizeof(magic));
+
+		if (magic != 0x07230203u /*SPIR-V*/ || shader->mappedFile.size % sizeof(uint32_t) != 0)
+		{
+			shader->request->result = VK_ERROR_INITIALIZATION_FAILED;
+		}
+		else
+		{
+			//Mapping is page aligned, driver copies the code so it's unmapped right after
+			VkShaderModuleCreateInfo shaderModuleCreateInfo = { ZERO };
+			shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			shaderModuleCreateInfo.codeSize = shader->mappedFile.size;
+			shaderModuleCreateInfo.pCode = (const uint32_t*)shader->mappedFile.data;
+			shader->request->result = initStruct->deviceTable.vkCreateShaderModule(initStruct->device, &shaderModuleCreateInfo, initStruct->allocationCallbacks, &shader->request->shaderModule);
+		}
+		vkCmdInitUnmapFile(&shader->mappedFile);
+	}
+
+	AsyncInit* beginAsyncInit(InitializationStruct* initStruct, JobSystem* jobSystem, /*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount), const char* const* deviceExtensions, uint32_t deviceExtensionCount, /*can be null*/ AsyncShaderRequest* shaders, uint32_t shaderCount)
+	{
+		size_t size = sizeof(AsyncInit) + sizeof(VkCmdInitAsyncShader) * shaderCount;
+		AsyncInit* asyncInit = (AsyncInit*)vkCmdInitHostAllocate(initStruct, size, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!asyncInit)
+			return NULL;
+		memset(asyncInit, 0, size);
+		asyncInit->initStruct = initStruct;
+		asyncInit->jobSystem = jobSystem;
+		asyncInit->shaders = (VkCmdInitAsyncShader*)(asyncInit + 1);
+		asyncInit->shaderCount = shaderCount;
+
+		uint32_t stepTrace = vkCmdInitTraceBegin(initStruct, "beginAsyncInit");
+
+		//Disk only needs physical device, so reads overlap vkCreateDevice
+		if (initStruct->pipelineCachePath)
+		{
+			initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &asyncInit->properties);
+			vkCmdInitRunJob(jobSystem, vkCmdInitAsyncMapPipelineCache, asyncInit, &asyncInit->fileCounter);
+		}
+		for (uint32_t i = 0; i < shaderCount; ++i)
+		{
+			shaders[i].shaderModule = VK_NULL_HANDLE;
+			shaders[i].result = VK_NOT_READY;
+			asyncInit->shaders[i].asyncInit = asyncInit;
+			asyncInit->shaders[i].request = &shaders[i];
+			vkCmdInitRunJob(jobSystem, vkCmdInitAsyncMapShader, &asyncInit->shaders[i], &asyncInit->fileCounter);
+		}
+
+		vkCmdInitCreateDevice(initStruct, deviceDesigner, deviceExtensions, deviceExtensionCount, false);
+
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "waitAsyncFiles");
+		waitJobCounter(jobSystem, &asyncInit->fileCounter);
+		vkCmdInitTraceEnd(initStruct, trace);
+
+		//Device functions are loaded by now, rest goes on workers while app creates swapchain
+		if (initStruct->device)
+		{
+			if (initStruct->pipelineCachePath)
+				vkCmdInitRunJob(jobSystem, vkCmdInitAsyncCreatePipelineCache, asyncInit, &asyncInit->createCounter);
+			for (uint32_t i = 0; i < shaderCount; ++i)
+				vkCmdInitRunJob(jobSystem, vkCmdInitAsyncCreateShader, &asyncInit->shaders[i], &asyncInit->createCounter);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < shaderCount; ++i)
+				shaders[i].result = VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		vkCmdInitTraceEnd(initStruct, stepTrace);
+		return asyncInit;
+	}
+
+	bool pollAsyncInit(const AsyncInit* asyncInit)
+	{
+		return pollJobCounter(&asyncInit->createCounter);
+	}
+
+	VkResult finishAsyncInit(AsyncInit* asyncInit)
+	{
+		InitializationStruct* initStruct = asyncInit->initStruct;
+		waitJobCounter(asyncInit->jobSystem, &asyncInit->createCounter);
+
+		VkResult result = initStruct->device ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED;
+		if (result == VK_SUCCESS && initStruct->pipelineCachePath && !initStruct->pipelineCache)
+			result = VK_ERROR_INITIALIZATION_FAILED;
+
+		//Still mapped if device creation failed
+		vkCmdInitUnmapFile(&asyncInit->pipelineCacheFile);
+		for (uint32_t i = 0; i < asyncInit->shaderCount; ++i)
+		{
+			vkCmdInitUnmapFile(&asyncInit->shaders[i].mappedFile);
+			if (result == VK_SUCCESS)
+				result = asyncInit->shaders[i].request->result;
+		}
+
+		vkCmdInitHostFree(initStruct, asyncInit);
+		return result;
+	}
+
+	ParallelRecorder* createParallelRecorder(InitializationStruct* initStruct, JobSystem* jobSystem, const FrameContext* frameContext)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return NULL;
+
+		ParallelRecorder* recorder = (ParallelRecorder*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(ParallelRecorder), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!recorder)
+			return NULL;
+		recorder->jobSystem = jobSystem;
+		recorder->workerCount = getJobWorkerCount(jobSystem);
+		recorder->framesInFlight = frameContext->framesInFlight;
+		recorder->pools = (ParallelRecorderPool*)vkCmdInitHostAllocateZeroed(initStruct, recorder->workerCount * recorder->framesInFlight, sizeof(ParallelRecorderPool), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		VkCommandPoolCreateInfo commandPoolCreateInfo = { ZERO };
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = initStruct->defaultQueueIndices->graphicQueueIndex;
+
+		VkResult result = recorder->pools ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+		for (uint32_t i = 0; i < recorder->workerCount * recorder->framesInFlight && result == VK_SUCCESS; ++i)
+			result = initStruct->deviceTable.vkCreateCommandPool(initStruct->device, &commandPoolCreateInfo, initStruct->allocationCallbacks, &recorder->pools[i].commandPool);
+
+		if (result != VK_SUCCESS)
+		{
+			destroyParallelRecorder(initStruct, recorder);
+			return NULL;
+		}
+		return recorder;
+	}
+
+	static void vkCmdInitRecordChunk(void* userData, uint32_t workerIndex)
+	{
+		ParallelRecordTask* task = (ParallelRecordTask*)userData;
+		ParallelRecorder* recorder = task->recorder;
+		InitializationStruct* initStruct = task->initStruct;
+		ParallelRecorderPool* pool = &recorder->pools[recorder->frameIndex * recorder->workerCount + workerIndex];
+
+		//Buffers are kept across frames, pool reset only rewinds them
+		if (pool->usedCount == pool->commandBufferCount)
+		{
+			const uint32_t batchSize = 8;
+			if (!vkCmdInitReserve(initStruct, (void**)&pool->commandBuffers, &pool->commandBufferCapacity, pool->commandBufferCount + batchSize, sizeof(VkCommandBuffer), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			{
+				task->result = VK_ERROR_OUT_OF_HOST_MEMORY;
+				return;
+			}
+
+			VkCommandBufferAllocateInfo allocateInfo = { ZERO };
+			allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocateInfo.commandPool = pool->commandPool;
+			allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocateInfo.commandBufferCount = batchSize;
+			task->result = initStruct->deviceTable.vkAllocateCommandBuffers(initStruct->device, &allocateInfo, pool->commandBuffers + pool->commandBufferCount);
+			if (task->result != VK_SUCCESS)
+				return;
+			pool->commandBufferCount += batchSize;
+		}
+		VkCommandBuffer commandBuffer = pool->commandBuffers[pool->usedCount++];
+
+		VkCommandBufferBeginInfo beginInfo = { ZERO };
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if (task->inheritanceInfo->renderPass)
+			beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		beginInfo.pInheritanceInfo = task->inheritanceInfo;
+
+		task->result = initStruct->deviceTable.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		if (task->result != VK_SUCCESS)
+			return;
+		task->function(commandBuffer, task->chunkIndex, task->userData);
+		task->result = initStruct->deviceTable.vkEndCommandBuffer(commandBuffer);
+		recorder->secondaries[task->chunkIndex] = commandBuffer;
+	}
+
+	VkResult recordParallel(InitializationStruct* initStruct, ParallelRecorder* recorder, const FrameContext* frameContext, VkCommandBuffer primaryCommandBuffer, /*can be null*/ const VkCommandBufferInheritanceInfo* inheritanceInfo, uint32_t chunkCount, RecordFunction function, void* userData)
+	{
+		//beginFrame waited for the slot's fence, so buffers recorded framesInFlight frames ago are done
+		if (recorder->resetFrameNumber != frameContext->frameNumber + 1)
+		{
+			recorder->frameIndex = frameContext->frameIndex;
+			recorder->resetFrameNumber = frameContext->frameNumber + 1;
+			for (uint32_t i = 0; i < recorder->workerCount; ++i)
+			{
+				ParallelRecorderPool* pool = &recorder->pools[recorder->frameIndex * recorder->workerCount + i];
+				initStruct->deviceTable.vkResetCommandPool(initStruct->device, pool->commandPool, 0);
+				pool->usedCount = 0;
+			}
+		}
+
+		if (!chunkCount)
+			return VK_SUCCESS;
+
+		if (!vkCmdInitReserve(initStruct, (void**)&recorder->secondaries, &recorder->secondaryCapacity, chunkCount, sizeof(VkCommandBuffer), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) ||
+			!vkCmdInitReserve(initStruct, (void**)&recorder->tasks, &recorder->taskCapacity, chunkCount, sizeof(ParallelRecordTask), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		VkCommandBufferInheritanceInfo defaultInheritanceInfo = { ZERO };
+		defaultInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+		JobCounter counter = { 0 };
+		for (uint32_t i = 0; i < chunkCount; ++i)
+		{
+			ParallelRecordTask* task = &recorder->tasks[i];
+			task->recorder = recorder;
+			task->initStruct = initStruct;
+			task->function = function;
+			task->userData = userData;
+			task->inheritanceInfo = inheritanceInfo ? inheritanceInfo : &defaultInheritanceInfo;
+			task->chunkIndex = i;
+			task->result = VK_SUCCESS;
+			if (!submitJob(recorder->jobSystem, vkCmdInitRecordChunk, task, &counter))
+				task->result = VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
+		waitJobCounter(recorder->jobSystem, &counter);
+
+		for (uint32_t i = 0; i < chunkCount; ++i)
+		{
+			if (recorder->tasks[i].result != VK_SUCCESS)
+				return recorder->tasks[i].result;
+		}
+
+		initStruct->deviceTable.vkCmdExecuteCommands(primaryCommandBuffer, chunkCount, recorder->secondaries);
+		return VK_SUCCESS;
+	}
+
+	void destroyParallelRecorder(InitializationStruct* initStruct, ParallelRecorder* recorder)
+	{
+		for (uint32_t i = 0; recorder->pools && i < recorder->workerCount * recorder->framesInFlight; ++i)
+		{
+			if (recorder->pools[i].commandPool)
+				initStruct->deviceTable.vkDestroyCommandPool(initStruct->device, recorder->pools[i].commandPool, initStruct->allocationCallbacks);
+			vkCmdInitHostFree(initStruct, recorder->pools[i].commandBuffers);
+		}
+		vkCmdInitHostFree(initStruct, recorder->pools);
+		vkCmdInitHostFree(initStruct, recorder->secondaries);
+		vkCmdInitHostFree(initStruct, recorder->tasks);
+		vkCmdInitHostFree(initStruct, recorder);
+	}
+
+	//Content key of pipeline description. unique marks descriptions that can't be compared, they get an entry of their own
+	typedef struct VkCmdInitPipelineKey
+	{
+		const InitializationStruct* initStruct; //words grow through its allocation callbacks
+		uint64_t* words;
+		uint32_t wordCount;
+		uint32_t wordCapacity;
+		bool failed; //out of memory
+		bool unique;
+	} VkCmdInitPipelineKey;
+
+	static void vkCmdInitKeyWord(VkCmdInitPipelineKey* key, uint64_t word)
+	{
+		if (!vkCmdInitReserve(key->initStruct, (void**)&key->words, &key->wordCapacity, key->wordCount + 1, sizeof(uint64_t), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+		{
+			key->failed = true;
+			return;
+		}
+		key->words[key->wordCount++] = word;
+	}
+
+	//Size goes first, so neighbouring arrays can't shift into each other
+	static void vkCmdInitKeyBytes(VkCmdInitPipelineKey* key, const void* data, size_t size)
+	{
+		if (!data)
+			size = 0;
+		vkCmdInitKeyWord(key, (uint64_t)size);
+		for (size_t offset = 0; offset < size; offset += sizeof(uint64_t))
+		{
+			uint64_t word = 0;
+			memcpy(&word, (const uint8_t*)data + offset, size - offset < sizeof(word) ? size - offset : sizeof(word));
+			vkCmdInitKeyWord(key, word);
+		}
+	}
+
+	//Only for runs of 32 bit members, those have no padding between them
+#define VKCMDINIT_KEY_MEMBERS(key, state, first, last) vkCmdInitKeyBytes((key), &(state)->first, (size_t)((const uint8_t*)(&(state)->last + 1) - (const uint8_t*)&(state)->first))
+
+	static void vkCmdInitKeyNext(VkCmdInitPipelineKey* key, const void* next)
+	{
+		for (const VkBaseInStructure* structure = (const VkBaseInStructure*)next; structure; structure = structure->pNext)
+		{
+			if (structure->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO)
+			{
+				const VkPipelineRenderingCreateInfo* rendering = (const VkPipelineRenderingCreateInfo*)structure;
+				vkCmdInitKeyWord(key, ((uint64_t)structure->sType << 32) | rendering->viewMask);
+				vkCmdInitKeyBytes(key, rendering->pColorAttachmentFormats, sizeof(VkFormat) * rendering->colorAttachmentCount);
+				vkCmdInitKeyWord(key, ((uint64_t)rendering->depthAttachmentFormat << 32) | (uint64_t)rendering->stencilAttachmentFormat);
+			}
+			else
+			{
+				//Pointers can't be compared (app may reuse memory with other contents), so unknown structs disable sharing
+				key->unique = true;
+			}
+		}
+	}
+
+	//Presence word, then state's extension structs. true if state is there
+	static bool vkCmdInitKeyState(VkCmdInitPipelineKey* key, const void* state)
+	{
+		vkCmdInitKeyWord(key, state != NULL);
+		if (state)
+			vkCmdInitKeyNext(key, ((const VkBaseInStructure*)state)->pNext);
+		return state != NULL;
+	}
+
+	static void vkCmdInitKeyStage(VkCmdInitPipelineKey* key, const VkPipelineShaderStageCreateInfo* stage)
+	{
+		vkCmdInitKeyNext(key, stage->pNext);
+		vkCmdInitKeyWord(key, ((uint64_t)stage->flags << 32) | (uint64_t)stage->stage);
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(stage->module));
+		vkCmdInitKeyBytes(key, stage->pName, strlen(stage->pName));
+
+		const VkSpecializationInfo* specialization = stage->pSpecializationInfo;
+		vkCmdInitKeyWord(key, specialization != NULL);
+		if (specialization)
+		{
+			vkCmdInitKeyBytes(key, specialization->pMapEntries, sizeof(VkSpecializationMapEntry) * specialization->mapEntryCount);
+			vkCmdInitKeyBytes(key, specialization->pData, specialization->dataSize);
+		}
+	}
+
+	static bool vkCmdInitHasDynamicState(const VkPipelineDynamicStateCreateInfo* dynamic, VkDynamicState state)
+	{
+		for (uint32_t i = 0; dynamic && i < dynamic->dynamicStateCount; ++i)
+		{
+			if (dynamic->pDynamicStates[i] == state)
+				return true;
+		}
+		return false;
+	}
+
+	//Members Vulkan ignores may be left pointing at garbage by valid apps, so they're keyed as absent and never read
+	static void vkCmdInitGraphicsPipelineKey(VkCmdInitPipelineKey* key, const VkGraphicsPipelineCreateInfo* createInfo)
+	{
+		vkCmdInitKeyWord(key, VK_PIPELINE_BIND_POINT_GRAPHICS);
+		vkCmdInitKeyNext(key, createInfo->pNext);
+		vkCmdInitKeyWord(key, ((uint64_t)createInfo->flags << 32) | createInfo->stageCount);
+		bool hasTessellation = false;
+		for (uint32_t i = 0; i < createInfo->stageCount; ++i)
+		{
+			vkCmdInitKeyStage(key, &createInfo->pStages[i]);
+			hasTessellation |= (createInfo->pStages[i].stage & (VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT)) != 0;
+		}
+
+		const VkPipelineDynamicStateCreateInfo* dynamic = createInfo->pDynamicState;
+		if (vkCmdInitKeyState(key, dynamic))
+		{
+			vkCmdInitKeyWord(key, dynamic->flags);
+			vkCmdInitKeyBytes(key, dynamic->pDynamicStates, sizeof(VkDynamicState) * dynamic->dynamicStateCount);
+		}
+
+		const VkPipelineRasterizationStateCreateInfo* rasterization = createInfo->pRasterizationState;
+		if (vkCmdInitKeyState(key, rasterization))
+			VKCMDINIT_KEY_MEMBERS(key, rasterization, flags, lineWidth);
+		bool rasterizerDiscard = rasterization && rasterization->rasterizerDiscardEnable && !vkCmdInitHasDynamicState(dynamic, VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE);
+
+		//Render pass subpasses aren't visible here, with dynamic rendering missing attachments make their states ignored too
+		bool hasColor = true;
+		bool hasDepthStencil = true;
+		if (!createInfo->renderPass)
+		{
+			const VkPipelineRenderingCreateInfo* rendering = NULL;
+			for (const VkBaseInStructure* structure = (const VkBaseInStructure*)createInfo->pNext; structure && !rendering; structure = structure->pNext)
+				rendering = structure->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO ? (const VkPipelineRenderingCreateInfo*)structure : NULL;
+			hasColor = rendering && rendering->colorAttachmentCount;
+			hasDepthStencil = rendering && (rendering->depthAttachmentFormat != VK_FORMAT_UNDEFINED || rendering->stencilAttachmentFormat != VK_FORMAT_UNDEFINED);
+		}
+
+		const VkPipelineVertexInputStateCreateInfo* vertexInput = createInfo->pVertexInputState;
+		if (vkCmdInitKeyState(key, vertexInput))
+		{
+			vkCmdInitKeyWord(key, vertexInput->flags);
+			vkCmdInitKeyBytes(key, vertexInput->pVertexBindingDescriptions, sizeof(VkVertexInputBindingDescription) * vertexInput->vertexBindingDescriptionCount);
+			vkCmdInitKeyBytes(key, vertexInput->pVertexAttributeDescriptions, sizeof(VkVertexInputAttributeDescription) * vertexInput->vertexAttributeDescriptionCount);
+		}
+
+		const VkPipelineInputAssemblyStateCreateInfo* inputAssembly = createInfo->pInputAssemblyState;
+		if (vkCmdInitKeyState(key, inputAssembly))
+			VKCMDINIT_KEY_MEMBERS(key, inputAssembly, flags, primitiveRestartEnable);
+
+		const VkPipelineTessellationStateCreateInfo* tessellation = hasTessellation ? createInfo->pTessellationState : NULL;
+		if (vkCmdInitKeyState(key, tessellation))
+			VKCMDINIT_KEY_MEMBERS(key, tessellation, flags, patchControlPoints);
+
+		const VkPipelineViewportStateCreateInfo* viewport = rasterizerDiscard ? NULL : createInfo->pViewportState;
+		if (vkCmdInitKeyState(key, viewport))
+		{
+			bool viewportCountDynamic = vkCmdInitHasDynamicState(dynamic, VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT);
+			bool scissorCountDynamic = vkCmdInitHasDynamicState(dynamic, VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT);
+			uint32_t viewportCount = viewportCountDynamic ? 0 : viewport->viewportCount;
+			uint32_t scissorCount = scissorCountDynamic ? 0 : viewport->scissorCount;
+			vkCmdInitKeyWord(key, ((uint64_t)viewportCount << 32) | scissorCount);
+			vkCmdInitKeyWord(key, viewport->flags);
+			if (!viewportCountDynamic && !vkCmdInitHasDynamicState(dynamic, VK_DYNAMIC_STATE_VIEWPORT))
+				vkCmdInitKeyBytes(key, viewport->pViewports, sizeof(VkViewport) * viewportCount);
+			if (!scissorCountDynamic && !vkCmdInitHasDynamicState(dynamic, VK_DYNAMIC_STATE_SCISSOR))
+				vkCmdInitKeyBytes(key, viewport->pScissors, sizeof(VkRect2D) * scissorCount);
+		}
+
+		const VkPipelineMultisampleStateCreateInfo* multisample = rasterizerDiscard ? NULL : createInfo->pMultisampleState;
+		if (vkCmdInitKeyState(key, multisample))
+		{
+			VKCMDINIT_KEY_MEMBERS(key, multisample, flags, minSampleShading);
+			vkCmdInitKeyBytes(key, multisample->pSampleMask, sizeof(VkSampleMask) * (((uint32_t)multisample->rasterizationSamples + 31) / 32));
+			VKCMDINIT_KEY_MEMBERS(key, multisample, alphaToCoverageEnable, alphaToOneEnable);
+		}
+
+		const VkPipelineDepthStencilStateCreateInfo* depthStencil = rasterizerDiscard || !hasDepthStencil ? NULL : createInfo->pDepthStencilState;
+		if (vkCmdInitKeyState(key, depthStencil))
+			VKCMDINIT_KEY_MEMBERS(key, depthStencil, flags, maxDepthBounds);
+
+		const VkPipelineColorBlendStateCreateInfo* colorBlend = rasterizerDiscard || !hasColor ? NULL : createInfo->pColorBlendState;
+		if (vkCmdInitKeyState(key, colorBlend))
+		{
+			VKCMDINIT_KEY_MEMBERS(key, colorBlend, flags, logicOp);
+			vkCmdInitKeyBytes(key, colorBlend->pAttachments, sizeof(VkPipelineColorBlendAttachmentState) * colorBlend->attachmentCount);
+			vkCmdInitKeyBytes(key, colorBlend->blendConstants, sizeof(colorBlend->blendConstants));
+		}
+
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(createInfo->layout));
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(createInfo->renderPass));
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(createInfo->basePipelineHandle));
+		vkCmdInitKeyWord(key, ((uint64_t)createInfo->subpass << 32) | (uint32_t)createInfo->basePipelineIndex);
+	}
+
+	static void vkCmdInitComputePipelineKey(VkCmdInitPipelineKey* key, const VkComputePipelineCreateInfo* createInfo)
+	{
+		vkCmdInitKeyWord(key, VK_PIPELINE_BIND_POINT_COMPUTE);
+		vkCmdInitKeyNext(key, createInfo->pNext);
+		vkCmdInitKeyWord(key, createInfo->flags);
+		vkCmdInitKeyStage(key, &createInfo->stage);
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(createInfo->layout));
+		vkCmdInitKeyWord(key, VKCMDINIT_HANDLE_BITS(createInfo->basePipelineHandle));
+		vkCmdInitKeyWord(key, (uint32_t)createInfo->basePipelineIndex);
+	}
+
+	enum
+	{
+		VKCMDINIT_PIPELINE_QUEUED = 0,
+		VKCMDINIT_PIPELINE_COMPILING = 1,
+		VKCMDINIT_PIPELINE_DONE = 2
+	};
+
+	typedef struct VkCmdInitPipelineEntry
+	{
+		uint64_t hash; //0 for unique entries, they aren't in the table
+		uint64_t* key;
+		uint32_t keyWordCount;
+		uint32_t state;
+		PipelinePriority priority; //highest it was queued with
+		VkPipelineBindPoint bindPoint;
+		const void* createInfo; //app's, read when compilation starts
+		VkPipeline pipeline;
+		VkResult result;
+	} VkCmdInitPipelineEntry;
+
+	//Entries leave at head. Ones compiled meanwhile (raised priority, waitPipeline) are skipped then
+	typedef struct VkCmdInitPipelineQueue
+	{
+		uint32_t* entries;
+		uint32_t capacity;
+		uint32_t head;
+		uint32_t tail;
+	} VkCmdInitPipelineQueue;
+
+	struct PipelineCompiler
+	{
+		InitializationStruct* initStruct;
+		JobSystem* jobSystem;
+		JobCounter jobCounter; //one job per queued entry, each compiles whatever has highest priority when it runs
+
+		VkCmdInitMutex mutex; //guards everything below
+		VkCmdInitCondition compiled;
+		VkCmdInitPipelineEntry* entries; //by handle
+		uint32_t entryCount;
+		uint32_t entryCapacity;
+		uint32_t* table; //open addressing over shared entries, UINT32_MAX marks empty slot
+		uint32_t tableCapacity; //power of 2
+		uint32_t tableCount;
+		VkCmdInitPipelineQueue queues[PIPELINE_PRIORITY_COUNT];
+		PipelineCompilerStats stats;
+	};
+
+	PipelineCompiler* createPipelineCompiler(InitializationStruct* initStruct, JobSystem* jobSystem)
+	{
+		PipelineCompiler* compiler = (PipelineCompiler*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(PipelineCompiler), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!compiler)
+			return NULL;
+
+		compiler->initStruct = initStruct;
+		compiler->jobSystem = jobSystem;
+		vkCmdInitMutexInit(&compiler->mutex);
+		vkCmdInitConditionInit(&compiler->compiled);
+		compiler->tableCapacity = 64;
+		compiler->table = (uint32_t*)vkCmdInitHostAllocate(initStruct, sizeof(uint32_t) * compiler->tableCapacity, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!compiler->table)
+		{
+			destroyPipelineCompiler(initStruct, compiler);
+			return NULL;
+		}
+		memset(compiler->table, 0xFF, sizeof(uint32_t) * compiler->tableCapacity);
+		return compiler;
+	}
+
+	//Returns slot holding entry with key, or empty slot it would go into
+	static uint32_t* vkCmdInitFindPipelineSlot(PipelineCompiler* compiler, uint64_t hash, const uint64_t* key, uint32_t keyWordCount)
+	{
+		uint32_t mask = compiler->tableCapacity - 1;
+		for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask)
+		{
+			uint32_t* slot = &compiler->table[i];
+			if (*slot == UINT32_MAX)
+				return slot;
+			const VkCmdInitPipelineEntry* entry = &compiler->entries[*slot];
+			if (entry->hash == hash && entry->keyWordCount == keyWordCount && memcmp(entry->key, key, keyWordCount * sizeof(uint64_t)) == 0)
+				return slot;
+		}
+	}
+
+	//Keeps load factor under 3/4 so probes stay short
+	static bool vkCmdInitGrowPipelineTable(PipelineCompiler* compiler)
+	{
+		if ((compiler->tableCount + 1) * 4 <= compiler->tableCapacity * 3)
+			return true;
+
+		uint32_t* oldTable = compiler->table;
+		uint32_t oldCapacity = compiler->tableCapacity;
+		uint32_t* newTable = (uint32_t*)vkCmdInitHostAllocate(compiler->initStruct, sizeof(uint32_t) * oldCapacity * 2, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!newTable)
+			return false;
+		memset(newTable, 0xFF, sizeof(uint32_t) * oldCapacity * 2);
+
+		compiler->table = newTable;
+		compiler->tableCapacity = oldCapacity * 2;
+		for (uint32_t i = 0; i < oldCapacity; ++i)
+		{
+			if (oldTable[i] != UINT32_MAX)
+			{
+				const VkCmdInitPipelineEntry* entry = &compiler->entries[oldTable[i]];
+				*vkCmdInitFindPipelineSlot(compiler, entry->hash, entry->key, entry->keyWordCount) = oldTable[i];
+			}
+		}
+		vkCmdInitHostFree(compiler->initStruct, oldTable);
+		return true;
+	}
+
+	static bool vkCmdInitQueuePipeline(PipelineCompiler* compiler, PipelineHandle handle, PipelinePriority priority)
+	{
+		VkCmdInitPipelineQueue* queue = &compiler->queues[priority];
+		//Skipped entries pile up at the front until queue runs empty
+		if (queue->head == queue->tail)
+			queue->head = queue->tail = 0;
+		if (!vkCmdInitReserve(compiler->initStruct, (void**)&queue->entries, &queue->capacity, queue->tail + 1, sizeof(uint32_t), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return false;
+		queue->entries[queue->tail++] = handle;
+		compiler->entries[handle].priority = priority;
+		return true;
+	}
+
+	//Highest priority entry still queued, marked compiling. UINT32_MAX if there's none
+	static PipelineHandle vkCmdInitClaimPipeline(PipelineCompiler* compiler)
+	{
+		for (uint32_t priority = PIPELINE_PRIORITY_COUNT; priority-- > 0;)
+		{
+			VkCmdInitPipelineQueue* queue = &compiler->queues[priority];
+			while (queue->head != queue->tail)
+			{
+				PipelineHandle handle = queue->entries[queue->head++];
+				if (compiler->entries[handle].state == VKCMDINIT_PIPELINE_QUEUED)
+				{
+					compiler->entries[handle].state = VKCMDINIT_PIPELINE_COMPILING;
+					return handle;
+				}
+			}
+		}
+		return UINT32_MAX;
+	}
+
+	//Entry has to be claimed already. Driver call runs unlocked, entries may move meanwhile so only handle is kept
+	static void vkCmdInitBuildPipeline(PipelineCompiler* compiler, PipelineHandle handle)
+	{
+		InitializationStruct* initStruct = compiler->initStruct;
+		vkCmdInitMutexLock(&compiler->mutex);
+		VkPipelineBindPoint bindPoint = compiler->entries[handle].bindPoint;
+		const void* createInfo = compiler->entries[handle].createInfo;
+		vkCmdInitMutexUnlock(&compiler->mutex);
+
+		//Pipeline cache is internally synchronized, every thread compiles into the same one
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result;
+		uint64_t start = vkCmdInitNanoseconds();
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+			result = initStruct->deviceTable.vkCreateComputePipelines(initStruct->device, initStruct->pipelineCache, 1, (const VkComputePipelineCreateInfo*)createInfo, initStruct->allocationCallbacks, &pipeline);
+		else
+			result = initStruct->deviceTable.vkCreateGraphicsPipelines(initStruct->device, initStruct->pipelineCache, 1, (const VkGraphicsPipelineCreateInfo*)createInfo, initStruct->allocationCallbacks, &pipeline);
+		uint64_t duration = vkCmdInitNanoseconds() - start;
+
+		vkCmdInitMutexLock(&compiler->mutex);
+		VkCmdInitPipelineEntry* entry = &compiler->entries[handle];
+		entry->pipeline = result == VK_SUCCESS ? pipeline : VK_NULL_HANDLE;
+		entry->result = result;
+		entry->createInfo = NULL;
+		entry->state = VKCMDINIT_PIPELINE_DONE;
+		if (result == VK_SUCCESS)
+			compiler->stats.compiledCount += 1;
+		else
+			compiler->stats.failedCount += 1;
+		compiler->stats.pendingCount -= 1;
+		compiler->stats.compileNanoseconds += duration;
+		vkCmdInitConditionBroadcast(&compiler->compiled);
+		vkCmdInitMutexUnlock(&compiler->mutex);
+	}
+
+	static void vkCmdInitCompileNextPipeline(void* userData, uint32_t workerIndex)
+	{
+		PipelineCompiler* compiler = (PipelineCompiler*)userData;
+		vkCmdInitMutexLock(&compiler->mutex);
+		PipelineHandle handle = vkCmdInitClaimPipeline(compiler);
+		vkCmdInitMutexUnlock(&compiler->mutex);
+		if (handle != UINT32_MAX)
+			vkCmdInitBuildPipeline(compiler, handle);
+	}
+
+	//Takes over key words
+	static PipelineHandle vkCmdInitRequestPipeline(PipelineCompiler* compiler, VkPipelineBindPoint bindPoint, const void* createInfo, VkCmdInitPipelineKey* key, PipelinePriority priority)
+	{
+		if (key->failed)
+		{
+			vkCmdInitHostFree(compiler->initStruct, key->words);
+			return UINT32_MAX;
+		}
+		uint64_t hash = vkCmdInitHash(key->words, key->wordCount * sizeof(uint64_t), VKCMDINIT_HASH_SEED);
+		if (!hash)
+			hash = 1;
+
+		vkCmdInitMutexLock(&compiler->mutex);
+		compiler->stats.requestCount += 1;
+
+		uint32_t* slot = key->unique ? NULL : vkCmdInitFindPipelineSlot(compiler, hash, key->words, key->wordCount);
+		if (slot && *slot != UINT32_MAX)
+		{
+			PipelineHandle handle = *slot;
+			compiler->stats.deduplicatedCount += 1;
+			//Listed again in higher queue, the old listing is skipped once it comes up
+			bool raised = compiler->entries[handle].state == VKCMDINIT_PIPELINE_QUEUED && priority > compiler->entries[handle].priority &&
+				vkCmdInitQueuePipeline(compiler, handle, priority);
+			vkCmdInitMutexUnlock(&compiler->mutex);
+
+			vkCmdInitHostFree(compiler->initStruct, key->words);
+			if (raised)
+				vkCmdInitRunJob(compiler->jobSystem, vkCmdInitCompileNextPipeline, compiler, &compiler->jobCounter);
+			return handle;
+		}
+
+		if (!vkCmdInitReserve(compiler->initStruct, (void**)&compiler->entries, &compiler->entryCapacity, compiler->entryCount + 1, sizeof(VkCmdInitPipelineEntry), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) ||
+			(!key->unique && !vkCmdInitGrowPipelineTable(compiler)))
+		{
+			vkCmdInitMutexUnlock(&compiler->mutex);
+			vkCmdInitHostFree(compiler->initStruct, key->words);
+			return UINT32_MAX;
+		}
+
+		PipelineHandle handle = compiler->entryCount++;
+		VkCmdInitPipelineEntry* entry = &compiler->entries[handle];
+		memset(entry, 0, sizeof(*entry));
+		entry->state = VKCMDINIT_PIPELINE_QUEUED;
+		entry->bindPoint = bindPoint;
+		entry->createInfo = createInfo;
+		entry->result = VK_NOT_READY;
+		if (key->unique)
+		{
+			vkCmdInitHostFree(compiler->initStruct, key->words);
+		}
+		else
+		{
+			entry->hash = hash;
+			entry->key = key->words;
+			entry->keyWordCount = key->wordCount;
+			*vkCmdInitFindPipelineSlot(compiler, hash, key->words, key->wordCount) = handle;
+			compiler->tableCount += 1;
+		}
+		compiler->stats.pendingCount += 1;
+
+		//Without room in queue it's compiled right here instead
+		bool queued = vkCmdInitQueuePipeline(compiler, handle, priority);
+		if (!queued)
+			entry->state = VKCMDINIT_PIPELINE_COMPILING;
+		vkCmdInitMutexUnlock(&compiler->mutex);
+
+		if (queued)
+			vkCmdInitRunJob(compiler->jobSystem, vkCmdInitCompileNextPipeline, compiler, &compiler->jobCounter);
+		else
+			vkCmdInitBuildPipeline(compiler, handle);
+		return handle;
+	}
+
+	PipelineHandle compileGraphicsPipeline(PipelineCompiler* compiler, const VkGraphicsPipelineCreateInfo* createInfo, PipelinePriority priority)
+	{
+		VkCmdInitPipelineKey key = { ZERO };
+		key.initStruct = compiler->initStruct;
+		vkCmdInitGraphicsPipelineKey(&key, createInfo);
+		return vkCmdInitRequestPipeline(compiler, VK_PIPELINE_BIND_POINT_GRAPHICS, createInfo, &key, priority);
+	}
+
+	PipelineHandle compileComputePipeline(PipelineCompiler* compiler, const VkComputePipelineCreateInfo* createInfo, PipelinePriority priority)
+	{
+		VkCmdInitPipelineKey key = { ZERO };
+		key.initStruct = compiler->initStruct;
+		vkCmdInitComputePipelineKey(&key, createInfo);
+		return vkCmdInitRequestPipeline(compiler, VK_PIPELINE_BIND_POINT_COMPUTE, createInfo, &key, priority);
+	}
+
+	VkResult pollPipeline(PipelineCompiler* compiler, PipelineHandle handle, VkPipeline* pipeline)
+	{
+		VkResult result = VK_ERROR_OUT_OF_HOST_MEMORY;
+		vkCmdInitMutexLock(&compiler->mutex);
+		if (handle < compiler->entryCount)
+		{
+			const VkCmdInitPipelineEntry* entry = &compiler->entries[handle];
+			result = entry->state == VKCMDINIT_PIPELINE_DONE ? entry->result : VK_NOT_READY;
+			if (entry->state == VKCMDINIT_PIPELINE_DONE)
+				*pipeline = entry->pipeline;
+		}
+		vkCmdInitMutexUnlock(&compiler->mutex);
+		return result;
+	}
+
+	VkResult waitPipeline(PipelineCompiler* compiler, PipelineHandle handle, VkPipeline* pipeline)
+	{
+		vkCmdInitMutexLock(&compiler->mutex);
+		if (handle >= compiler->entryCount)
+		{
+			vkCmdInitMutexUnlock(&compiler->mutex);
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
+
+		//Needed right now, so it doesn't wait for workers to get through what's queued before it
+		if (compiler->entries[handle].state == VKCMDINIT_PIPELINE_QUEUED)
+		{
+			compiler->entries[handle].state = VKCMDINIT_PIPELINE_COMPILING;
+			vkCmdInitMutexUnlock(&compiler->mutex);
+			vkCmdInitBuildPipeline(compiler, handle);
+			vkCmdInitMutexLock(&compiler->mutex);
+		}
+		while (compiler->entries[handle].state != VKCMDINIT_PIPELINE_DONE)
+			vkCmdInitConditionWait(&compiler->compiled, &compiler->mutex);
+
+		*pipeline = compiler->entries[handle].pipeline;
+		VkResult result = compiler->entries[handle].result;
+		vkCmdInitMutexUnlock(&compiler->mutex);
+		return result;
+	}
+
+	void waitPipelineCompiler(PipelineCompiler* compiler)
+	{
+		vkCmdInitMutexLock(&compiler->mutex);
+		while (compiler->stats.pendingCount)
+			vkCmdInitConditionWait(&compiler->compiled, &compiler->mutex);
+		vkCmdInitMutexUnlock(&compiler->mutex);
+	}
+
+	void getPipelineCompilerStats(PipelineCompiler* compiler, PipelineCompilerStats* stats)
+	{
+		vkCmdInitMutexLock(&compiler->mutex);
+		*stats = compiler->stats;
+		vkCmdInitMutexUnlock(&compiler->mutex);
+	}
+
+	void destroyPipelineCompiler(InitializationStruct* initStruct, PipelineCompiler* compiler)
+	{
+		//Jobs still hold compiler, so every one of them has to finish, not just the pipelines
+		waitJobCounter(compiler->jobSystem, &compiler->jobCounter);
+
+		for (uint32_t i = 0; i < compiler->entryCount; ++i)
+		{
+			if (compiler->entries[i].pipeline)
+				initStruct->deviceTable.vkDestroyPipeline(initStruct->device, compiler->entries[i].pipeline, initStruct->allocationCallbacks);
+			vkCmdInitHostFree(initStruct, compiler->entries[i].key);
+		}
+		for (uint32_t i = 0; i < PIPELINE_PRIORITY_COUNT; ++i)
+			vkCmdInitHostFree(initStruct, compiler->queues[i].entries);
+		vkCmdInitHostFree(initStruct, compiler->entries);
+		vkCmdInitHostFree(initStruct, compiler->table);
+		vkCmdInitConditionDestroy(&compiler->compiled);
+		vkCmdInitMutexDestroy(&compiler->mutex);
+		vkCmdInitHostFree(initStruct, compiler);
+	}
+
+#define VKCMDINIT_SHADER_ARCHIVE_MAGIC 0x41534B56u /*'VKSA'*/
+#define VKCMDINIT_SHADER_ARCHIVE_VERSION 1u
+#define VKCMDINIT_SPIRV_MAGIC 0x07230203u
+
+	//File is header, entries, names, then blobs at 8 byte aligned offsets. Mapping is page aligned, so blobs can be
+	//handed to the driver in place
+	typedef struct VkCmdInitShaderArchiveHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t headerSize;
+		uint32_t entryCount;
+		uint64_t fileSize;
+	} VkCmdInitShaderArchiveHeader;
+
+	//Sorted by nameHash. Entries with identical code point at the same blob
+	typedef struct VkCmdInitShaderArchiveEntry
+	{
+		uint64_t nameHash;
+		uint64_t codeHash;
+		uint64_t nameOffset; //not null terminated
+		uint64_t codeOffset;
+		uint32_t nameSize;
+		uint32_t codeSize;
+	} VkCmdInitShaderArchiveEntry;
+
+	struct ShaderArchive
+	{
+		VkCmdInitMappedFile mappedFile;
+		const VkCmdInitShaderArchiveEntry* entries; //in the mapping
+		uint32_t entryCount;
+		uint32_t* codeIndices; //by entry, entries with identical code share index
+		VkShaderModule* modules; //by code index
+		VkResult* moduleResults; //by code index, VK_NOT_READY until first request
+		uint32_t codeCount;
+		uint32_t moduleCount;
+	};
+
+	static bool vkCmdInitIsSpirv(const void* code, size_t codeSize)
+	{
+		uint32_t magic = 0;
+		if (codeSize >= sizeof(magic))
+			memcpy(&magic, code, sizeof(magic));
+		//Five word header at least
+		return magic == VKCMDINIT_SPIRV_MAGIC && codeSize % sizeof(uint32_t) == 0 && codeSize >= 5 * sizeof(uint32_t);
+	}
+
+	static int vkCmdInitCompareShaderEntries(const void* left, const void* right)
+	{
+		const VkCmdInitShaderArchiveEntry* a = (const VkCmdInitShaderArchiveEntry*)left;
+		const VkCmdInitShaderArchiveEntry* b = (const VkCmdInitShaderArchiveEntry*)right;
+		return a->nameHash < b->nameHash ? -1 : (a->nameHash > b->nameHash ? 1 : 0);
+	}
+
+	VkResult writeShaderArchive(const char* path, const ShaderArchiveSource* sources, uint32_t sourceCount)
+	{
+		VkCmdInitShaderArchiveEntry* entries = (VkCmdInitShaderArchiveEntry*)calloc(sourceCount ? sourceCount : 1, sizeof(VkCmdInitShaderArchiveEntry));
+		uint32_t* blobSources = (uint32_t*)malloc(sizeof(uint32_t) * (sourceCount ? sourceCount : 1)); //source whose blob each source uses
+		if (!entries || !blobSources)
+		{
+			free(entries);
+			free(blobSources);
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
+
+		VkResult result = VK_SUCCESS;
+		uint64_t namesSize = 0;
+		for (uint32_t i = 0; i < sourceCount && result == VK_SUCCESS; ++i)
+		{
+			if (!vkCmdInitIsSpirv(sources[i].code, sources[i].codeSize) || sources[i].codeSize > UINT32_MAX)
+				result = VK_ERROR_INITIALIZATION_FAILED;
+
+			size_t nameSize = strlen(sources[i].name);
+			entries[i].nameHash = vkCmdInitHash(sources[i].name, nameSize, VKCMDINIT_HASH_SEED);
+			entries[i].codeHash = vkCmdInitHash(sources[i].code, sources[i].codeSize, VKCMDINIT_HASH_SEED);
+			entries[i].nameSize = (uint32_t)nameSize;
+			entries[i].codeSize = (uint32_t)sources[i].codeSize;
+			namesSize += nameSize;
+
+			blobSources[i] = i;
+			for (uint32_t j = 0; j < i; ++j)
+			{
+				if (entries[j].nameSize == nameSize && memcmp(sources[j].name, sources[i].name, nameSize) == 0)
+					result = VK_ERROR_INITIALIZATION_FAILED;
+				if (blobSources[i] == i && blobSources[j] == j && entries[j].codeHash == entries[i].codeHash &&
+					entries[j].codeSize == entries[i].codeSize && memcmp(sources[j].code, sources[i].code, sources[i].codeSize) == 0)
+					blobSources[i] = j;
+			}
+		}
+
+		uint64_t namesOffset = sizeof(VkCmdInitShaderArchiveHeader) + sizeof(VkCmdInitShaderArchiveEntry) * (uint64_t)sourceCount;
+		uint64_t fileSize = (namesOffset + namesSize + 7) & ~7ull;
+		for (uint32_t i = 0; i < sourceCount && result == VK_SUCCESS; ++i)
+		{
+			entries[i].nameOffset = i ? entries[i - 1].nameOffset + entries[i - 1].nameSize : namesOffset;
+			if (blobSources[i] == i)
+			{
+				entries[i].codeOffset = fileSize;
+				fileSize += (entries[i].codeSize + 7) & ~7u;
+			}
+			else
+			{
+				entries[i].codeOffset = entries[blobSources[i]].codeOffset;
+			}
+		}
+
+		uint8_t* file = result == VK_SUCCESS && fileSize <= SIZE_MAX ? (uint8_t*)calloc(1, (size_t)fileSize) : NULL;
+		if (result == VK_SUCCESS && !file)
+			result = VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		if (result == VK_SUCCESS)
+		{
+			VkCmdInitShaderArchiveHeader header = { ZERO };
+			header.magic = VKCMDINIT_SHADER_ARCHIVE_MAGIC;
+			header.version = VKCMDINIT_SHADER_ARCHIVE_VERSION;
+			header.headerSize = sizeof(header);
+			header.entryCount = sourceCount;
+			header.fileSize = fileSize;
+			memcpy(file, &header, sizeof(header));
+
+			for (uint32_t i = 0; i < sourceCount; ++i)
+			{
+				memcpy(file + entries[i].nameOffset, sources[i].name, entries[i].nameSize);
+				if (blobSources[i] == i)
+					memcpy(file + entries[i].codeOffset, sources[i].code, entries[i].codeSize);
+			}
+
+			//Offsets are final, so entries can be sorted for binary search now
+			qsort(entries, sourceCount, sizeof(VkCmdInitShaderArchiveEntry), vkCmdInitCompareShaderEntries);
+			memcpy(file + sizeof(header), entries, sizeof(VkCmdInitShaderArchiveEntry) * sourceCount);
+
+			if (!vkCmdInitWriteFileAtomic(NULL, path, file, (size_t)fileSize))
+				result = VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		free(file);
+		free(blobSources);
+		free(entries);
+		return result;
+	}
+
+	static bool vkCmdInitValidateShaderArchive(const VkCmdInitMappedFile* mappedFile)
+	{
+		VkCmdInitShaderArchiveHeader header;
+		if (mappedFile->size < sizeof(header))
+			return false;
+		memcpy(&header, mappedFile->data, sizeof(header));
+		if (header.magic != VKCMDINIT_SHADER_ARCHIVE_MAGIC || header.version != VKCMDINIT_SHADER_ARCHIVE_VERSION ||
+			header.headerSize != sizeof(header) || header.fileSize != mappedFile->size)
+			return false;
+		if ((mappedFile->size - sizeof(header)) / sizeof(VkCmdInitShaderArchiveEntry) < header.entryCount)
+			return false;
+
+		const VkCmdInitShaderArchiveEntry* entries = (const VkCmdInitShaderArchiveEntry*)((const uint8_t*)mappedFile->data + sizeof(header));
+		for (uint32_t i = 0; i < header.entryCount; ++i)
+		{
+			const VkCmdInitShaderArchiveEntry* entry = &entries[i];
+			if (entry->nameOffset > mappedFile->size || entry->nameSize > mappedFile->size - entry->nameOffset)
+				return false;
+			if (entry->codeOffset > mappedFile->size || entry->codeSize > mappedFile->size - entry->codeOffset)
+				return false;
+			//Driver reads code as words
+			if (entry->codeOffset % sizeof(uint32_t) != 0 || entry->codeSize % sizeof(uint32_t) != 0)
+				return false;
+			if (i && entries[i - 1].nameHash > entry->nameHash)
+				return false;
+		}
+		return true;
+	}
+
+	ShaderArchive* openShaderArchive(InitializationStruct* initStruct, const char* path)
+	{
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "openShaderArchive");
+		ShaderArchive* shaderArchive = (ShaderArchive*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(ShaderArchive), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!shaderArchive || !vkCmdInitMapFile(path, &shaderArchive->mappedFile) || !vkCmdInitValidateShaderArchive(&shaderArchive->mappedFile))
+		{
+			if (shaderArchive)
+				closeShaderArchive(initStruct, shaderArchive);
+			vkCmdInitTraceEnd(initStruct, trace);
+			return NULL;
+		}
+
+		VkCmdInitShaderArchiveHeader header;
+		memcpy(&header, shaderArchive->mappedFile.data, sizeof(header));
+		shaderArchive->entries = (const VkCmdInitShaderArchiveEntry*)((const uint8_t*)shaderArchive->mappedFile.data + sizeof(header));
+		shaderArchive->entryCount = header.entryCount;
+
+		uint32_t tableCapacity = 16;
+		while (tableCapacity < header.entryCount * 2)
+			tableCapacity *= 2;
+		uint32_t* table = (uint32_t*)vkCmdInitHostAllocate(initStruct, sizeof(uint32_t) * tableCapacity, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND); //entry holding first copy of code
+		uint32_t count = header.entryCount ? header.entryCount : 1;
+		shaderArchive->codeIndices = (uint32_t*)vkCmdInitHostAllocate(initStruct, sizeof(uint32_t) * count, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		shaderArchive->modules = (VkShaderModule*)vkCmdInitHostAllocateZeroed(initStruct, count, sizeof(VkShaderModule), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		shaderArchive->moduleResults = (VkResult*)vkCmdInitHostAllocate(initStruct, sizeof(VkResult) * count, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!table || !shaderArchive->codeIndices || !shaderArchive->modules || !shaderArchive->moduleResults)
+		{
+			vkCmdInitHostFree(initStruct, table);
+			closeShaderArchive(initStruct, shaderArchive);
+			vkCmdInitTraceEnd(initStruct, trace);
+			return NULL;
+		}
+		memset(table, 0xFF, sizeof(uint32_t) * tableCapacity);
+
+		//Archives of writeShaderArchive share blobs already, other writers may have stored copies at different offsets
+		const uint8_t* data = (const uint8_t*)shaderArchive->mappedFile.data;
+		for (uint32_t i = 0; i < header.entryCount; ++i)
+		{
+			const VkCmdInitShaderArchiveEntry* entry = &shaderArchive->entries[i];
+			uint32_t mask = tableCapacity - 1;
+			for (uint32_t slot = (uint32_t)entry->codeHash & mask;; slot = (slot + 1) & mask)
+			{
+				if (table[slot] == UINT32_MAX)
+				{
+					table[slot] = i;
+					shaderArchive->codeIndices[i] = shaderArchive->codeCount;
+					shaderArchive->moduleResults[shaderArchive->codeCount++] = VK_NOT_READY;
+					break;
+				}
+				const VkCmdInitShaderArchiveEntry* first = &shaderArchive->entries[table[slot]];
+				if (first->codeHash == entry->codeHash && first->codeSize == entry->codeSize &&
+					(first->codeOffset == entry->codeOffset || memcmp(data + first->codeOffset, data + entry->codeOffset, entry->codeSize) == 0))
+				{
+					shaderArchive->codeIndices[i] = shaderArchive->codeIndices[table[slot]];
+					break;
+				}
+			}
+		}
+		vkCmdInitHostFree(initStruct, table);
+
+		vkCmdInitTraceEnd(initStruct, trace);
+		return shaderArchive;
+	}
+
+	//Entry of name, NULL if it isn't in archive
+	static const VkCmdInitShaderArchiveEntry* vkCmdInitFindShaderEntry(const ShaderArchive* shaderArchive, const char* name)
+	{
+		size_t nameSize = strlen(name);
+		uint64_t nameHash = vkCmdInitHash(name, nameSize, VKCMDINIT_HASH_SEED);
+
+		uint32_t low = 0;
+		uint32_t high = shaderArchive->entryCount;
+		while (low < high)
+		{
+			uint32_t middle = low + (high - low) / 2;
+			if (shaderArchive->entries[middle].nameHash < nameHash)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		const uint8_t* data = (const uint8_t*)shaderArchive->mappedFile.data;
+		for (uint32_t i = low; i < shaderArchive->entryCount && shaderArchive->entries[i].nameHash == nameHash; ++i)
+		{
+			const VkCmdInitShaderArchiveEntry* entry = &shaderArchive->entries[i];
+			if (entry->nameSize == nameSize && memcmp(data + entry->nameOffset, name, nameSize) == 0)
+				return entry;
+		}
+		return NULL;
+	}
+
+	VkShaderModule getShaderModule(InitializationStruct* initStruct, ShaderArchive* shaderArchive, const char* name)
+	{
+		const VkCmdInitShaderArchiveEntry* entry = vkCmdInitFindShaderEntry(shaderArchive, name);
+		if (!entry)
+			return VK_NULL_HANDLE;
+
+		uint32_t codeIndex = shaderArchive->codeIndices[entry - shaderArchive->entries];
+		if (shaderArchive->moduleResults[codeIndex] != VK_NOT_READY)
+			return shaderArchive->modules[codeIndex];
+
+		//First use, so this is where pages of the blob are read. Failures are kept, they'd fail again
+		uint32_t trace = vkCmdInitTraceBegin(initStruct, "createShaderModule");
+		const uint8_t* code = (const uint8_t*)shaderArchive->mappedFile.data + entry->codeOffset;
+		VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+		if (vkCmdInitIsSpirv(code, entry->codeSize) && vkCmdInitHash(code, entry->codeSize, VKCMDINIT_HASH_SEED) == entry->codeHash)
+		{
+			VkShaderModuleCreateInfo shaderModuleCreateInfo = { ZERO };
+			shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			shaderModuleCreateInfo.codeSize = entry->codeSize;
+			shaderModuleCreateInfo.pCode = (const uint32_t*)code;
+			result = initStruct->deviceTable.vkCreateShaderModule(initStruct->device, &shaderModuleCreateInfo, initStruct->allocationCallbacks, &shaderArchive->modules[codeIndex]);
+		}
+		if (result != VK_SUCCESS)
+			shaderArchive->modules[codeIndex] = VK_NULL_HANDLE;
+		else
+			shaderArchive->moduleCount += 1;
+		shaderArchive->moduleResults[codeIndex] = result;
+		vkCmdInitTraceEnd(initStruct, trace);
+		return shaderArchive->modules[codeIndex];
+	}
+
+	const uint32_t* getShaderCode(const ShaderArchive* shaderArchive, const char* name, /*can be null*/ size_t* codeSize)
+	{
+		const VkCmdInitShaderArchiveEntry* entry = vkCmdInitFindShaderEntry(shaderArchive, name);
+		if (codeSize)
+			*codeSize = entry ? entry->codeSize : 0;
+		return entry ? (const uint32_t*)((const uint8_t*)shaderArchive->mappedFile.data + entry->codeOffset) : NULL;
+	}
+
+	void getShaderArchiveStats(const ShaderArchive* shaderArchive, ShaderArchiveStats* stats)
+	{
+		stats->entryCount = shaderArchive->entryCount;
+		stats->codeCount = shaderArchive->codeCount;
+		stats->moduleCount = shaderArchive->moduleCount;
+		stats->mappedBytes = shaderArchive->mappedFile.size;
+	}
+
+	void closeShaderArchive(InitializationStruct* initStruct, ShaderArchive* shaderArchive)
+	{
+		for (uint32_t i = 0; shaderArchive->modules && i < shaderArchive->codeCount; ++i)
+		{
+			if (shaderArchive->modules[i])
+				initStruct->deviceTable.vkDestroyShaderModule(initStruct->device, shaderArchive->modules[i], initStruct->allocationCallbacks);
+		}
+		vkCmdInitUnmapFile(&shaderArchive->mappedFile);
+		vkCmdInitHostFree(initStruct, shaderArchive->codeIndices);
+		vkCmdInitHostFree(initStruct, shaderArchive->modules);
+		vkCmdInitHostFree(initStruct, shaderArchive->moduleResults);
+		vkCmdInitHostFree(initStruct, shaderArchive);
+	}
+
+	GpuProfiler* createGpuProfiler(InitializationStruct* initStruct, /*same as FrameContext*/ uint32_t framesInFlight, uint32_t maxScopesPerFrame, uint32_t traceCapacity)
+	{
+		if (!initStruct->defaultQueueIndices)
+			return NULL;
+
+		uint32_t queueFamilyCount = 0;
+		initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, NULL);
+		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)vkCmdInitHostAllocate(initStruct, sizeof(VkQueueFamilyProperties) * queueFamilyCount, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+		if (!queueFamilies)
+			return NULL;
+		initStruct->instanceTable.vkGetPhysicalDeviceQueueFamilyProperties(initStruct->physicalDevice, &queueFamilyCount, queueFamilies);
+		uint32_t timestampValidBits = queueFamilies[initStruct->defaultQueueIndices->graphicQueueIndex].timestampValidBits;
+		vkCmdInitHostFree(initStruct, queueFamilies);
+		if (!timestampValidBits)
+			return NULL;
+
+		VkPhysicalDeviceProperties properties;
+		initStruct->instanceTable.vkGetPhysicalDeviceProperties(initStruct->physicalDevice, &properties);
+
+		GpuProfiler* profiler = (GpuProfiler*)vkCmdInitHostAllocateZeroed(initStruct, 1, sizeof(GpuProfiler), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		if (!profiler)
+			return NULL;
+		profiler->frameCount = framesInFlight ? framesInFlight : 1;
+		profiler->maxScopesPerFrame = maxScopesPerFrame;
+		profiler->timestampPeriod = (double)properties.limits.timestampPeriod;
+		profiler->timestampMask = timestampValidBits >= 64 ? UINT64_MAX : ((1ull << timestampValidBits) - 1);
+		profiler->traceCapacity = traceCapacity;
+
+		profiler->frames = (GpuProfilerFrame*)vkCmdInitHostAllocateZeroed(initStruct, profiler->frameCount, sizeof(GpuProfilerFrame), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		profiler->queryResults = (uint64_t*)vkCmdInitHostAllocate(initStruct, sizeof(uint64_t) * maxScopesPerFrame * 2, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+		profiler->traceEvents = traceCapacity ? (GpuTraceEvent*)vkCmdInitHostAllocate(initStruct, sizeof(GpuTraceEvent) * traceCapacity, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) : NULL;
+
+		VkQueryPoolCreateInfo queryPoolCreateInfo = { ZERO };
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolCreateInfo.queryCount = maxScopesPerFrame * 2;
+
+		VkResult result = (profiler->frames && profiler->queryResults && (profiler->traceEvents || !traceCapacity)) ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+		for (uint32_t i = 0; i < profiler->frameCount && result == VK_SUCCESS; ++i)
+		{
+			profiler->frames[i].records = (GpuScopeRecord*)vkCmdInitHostAllocate(initStruct, sizeof(GpuScopeRecord) * maxScopesPerFrame, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+			result = profiler->frames[i].records ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+			if (result == VK_SUCCESS)
+				result = initStruct->deviceTable.vkCreateQueryPool(initStruct->device, &queryPoolCreateInfo, initStruct->allocationCallbacks, &profiler->frames[i].queryPool);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			destroyGpuProfiler(initStruct, profiler);
+			return NULL;
+		}
+		return profiler;
+	}
+
+	void beginGpuProfilerFrame(InitializationStruct* initStruct, GpuProfiler* profiler, VkCommandBuffer commandBuffer, uint64_t frameNumber)
+	{
+		GpuProfilerFrame* frame = &profiler->frames[frameNumber % profiler->frameCount];
+		if (frame->pending)
+			profiler->droppedFrameCount += 1;
+
+		frame->recordCount = 0;
+		frame->queryCount = 0;
+		frame->frameNumber = frameNumber;
+		frame->pending = false;
+		profiler->currentFrame = frame;
+		profiler->openRecordCount = 0;
+
+		initStruct->deviceTable.vkCmdResetQueryPool(commandBuffer, frame->queryPool, 0, profiler->maxScopesPerFrame * 2);
+	}
+
+	static uint32_t vkCmdInitFindGpuScope(const InitializationStruct* initStruct, GpuProfiler* profiler, const char* name, uint32_t parentScope)
+	{
+		for (uint32_t i = 0; i < profiler->scopeCount; ++i)
+		{
+			const GpuScopeStats* scope = &profiler->scopes[i];
+			if (scope->parentScope == parentScope && (scope->name == name || strcmp(scope->name, name) == 0))
+				return i;
+		}
+
+		if (!vkCmdInitReserve(initStruct, (void**)&profiler->scopes, &profiler->scopeCapacity, profiler->scopeCount + 1, sizeof(GpuScopeStats), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT))
+			return UINT32_MAX;
+
+		GpuScopeStats* scope = &profiler->scopes[profiler->scopeCount];
+		memset(scope, 0, sizeof(*scope));
+		scope->name = name;
+		scope->parentScope = parentScope;
+		scope->depth = parentScope == UINT32_MAX ? 0 : profiler->scopes[parentScope].depth + 1;
+		return profiler->scopeCount++;
+	}
+
+	void beginGpuScope(InitializationStruct* initStruct, GpuProfiler* profiler, VkCommandBuffer commandBuffer, /*has to outlive the profiler*/ const char* name)
+	{
+		GpuProfilerFrame* frame = profiler->currentFrame;
+		if (!frame)
+			return;
+
+		//Overflowing scopes still push UINT32_MAX so endGpuScope stays paired
+		uint32_t recordIndex = UINT32_MAX;
+		uint32_t parentRecord = profiler->openRecordCount ? profiler->openRecords[profiler->openRecordCount - 1] : UINT32_MAX;
+		bool parentDropped = profiler->openRecordCount && parentRecord == UINT32_MAX;
+		if (frame->recordCount < profiler->maxScopesPerFrame && profiler->openRecordCount < VKCMDINIT_GPU_PROFILER_MAX_DEPTH && !parentDropped)
+		{
+			uint32_t scope = vkCmdInitFindGpuScope(initStruct, profiler, name, parentRecord == UINT32_MAX ? UINT32_MAX : frame->records[parentRecord].scope);
+			if (scope != UINT32_MAX)
+			{
+				recordIndex = frame->recordCount++;
+				frame->records[recordIndex].scope = scope;
+				frame->records[recordIndex].beginQuery = frame->queryCount++;
+				frame->records[recordIndex].endQuery = UINT32_MAX;
+				initStruct->deviceTable.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame->queryPool, frame->records[recordIndex].beginQuery);
+			}
+		}
+		if (recordIndex == UINT32_MAX)
+			profiler->overflowCount += 1;
+
+		if (profiler->openRecordCount < VKCMDINIT_GPU_PROFILER_MAX_DEPTH)
+			profiler->openRecords[profiler->openRecordCount] = recordIndex;
+		profiler->openRecordCount += 1;
+	}
+
+	void endGpuScope(InitializationStruct* initStruct, GpuProfiler* profiler, VkCommandBuffer commandBuffer)
+	{
+		GpuProfilerFrame* frame = profiler->currentFrame;
+		if (!frame || !profiler->openRecordCount)
+			return;
+
+		profiler->openRecordCount -= 1;
+		if (profiler->openRecordCount >= VKCMDINIT_GPU_PROFILER_MAX_DEPTH)
+			return;
+
+		uint32_t recordIndex = profiler->openRecords[profiler->openRecordCount];
+		if (recordIndex == UINT32_MAX)
+			return;
+
+		//Every begin reserved its end query, recordCount * 2 never exceeds pool size
+		frame->records[recordIndex].endQuery = frame->queryCount++;
+		initStruct->deviceTable.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame->queryPool, frame->records[recordIndex].endQuery);
+	}
+
+	void endGpuProfilerFrame(GpuProfiler* profiler)
+	{
+		if (!profiler->currentFrame)
+			return;
+		profiler->currentFrame->pending = true;
+		profiler->currentFrame = NULL;
+		profiler->openRecordCount = 0;
+	}
+
+	static void vkCmdInitAddGpuScopeSample(GpuScopeStats* scope, uint64_t frameNumber, double milliseconds)
+	{
+		if (scope->sampleFrameNumber == frameNumber + 1)
+		{
+			uint32_t newest = (scope->nextSample + VKCMDINIT_GPU_PROFILER_WINDOW - 1) % VKCMDINIT_GPU_PROFILER_WINDOW;
+			scope->samples[newest] += milliseconds;
+		}
+		else
+		{
+			scope->samples[scope->nextSample] = milliseconds;
+			scope->nextSample = (scope->nextSample + 1) % VKCMDINIT_GPU_PROFILER_WINDOW;
+			if (scope->sampleCount < VKCMDINIT_GPU_PROFILER_WINDOW)
+				scope->sampleCount += 1;
+			scope->sampleFrameNumber = frameNumber + 1;
+		}
+
+		double sum = 0.0;
+		scope->minMilliseconds = scope->samples[0];
+		scope->maxMilliseconds = scope->samples[0];
+		for (uint32_t i = 0; i < scope->sampleCount; ++i)
+		{
+			sum += scope->samples[i];
+			if (scope->samples[i] < scope->minMilliseconds)
+				scope->minMilliseconds = scope->samples[i];
+			if (scope->samples[i] > scope->maxMilliseconds)
+				scope->maxMilliseconds = scope->samples[i];
+		}
+		scope->averageMilliseconds = sum / (double)scope->sampleCount;
+		scope->lastMilliseconds = scope->samples[(scope->nextSample + VKCMDINIT_GPU_PROFILER_WINDOW - 1) % VKCMDINIT_GPU_PROFILER_WINDOW];
+	}
+
+	uint32_t resolveGpuProfiler(InitializationStruct* initStruct, GpuProfiler* profiler, uint64_t completedFrameNumber)
+	{
+		uint32_t resolvedCount = 0;
+		for (uint32_t i = 0; i < profiler->frameCount; ++i)
+		{
+			GpuProfilerFrame* frame = &profiler->frames[i];
+			if (!frame->pending || frame->frameNumber > completedFrameNumber)
+				continue;
+
+			if (frame->queryCount)
+			{
+				//No wait bit, VK_NOT_READY leaves frame pending for the next call
+				VkResult result = initStruct->deviceTable.vkGetQueryPoolResults(initStruct->device, frame->queryPool, 0, frame->queryCount,
+					sizeof(uint64_t) * frame->queryCount, profiler->queryResults, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+				if (result == VK_NOT_READY)
+					continue;
+				if (result != VK_SUCCESS)
+				{
+					frame->pending = false;
+					profiler->droppedFrameCount += 1;
+					continue;
+				}
+			}
+
+			for (uint32_t r = 0; r < frame->recordCount; ++r)
+			{
+				const GpuScopeRecord* record = &frame->records[r];
+				if (record->endQuery == UINT32_MAX)
+					continue;
+
+				uint64_t begin = profiler->queryResults[record->beginQuery] & profiler->timestampMask;
+				uint64_t end = profiler->queryResults[record->endQuery] & profiler->timestampMask;
+				uint64_t ticks = (end - begin) & profiler->timestampMask;
+				double nanoseconds = (double)ticks * profiler->timestampPeriod;
+				vkCmdInitAddGpuScopeSample(&profiler->scopes[record->scope], frame->frameNumber, nanoseconds / 1000000.0);
+
+				if (profiler->traceCapacity)
+				{
+					GpuTraceEvent* event = &profiler->traceEvents[profiler->traceEventCount % profiler->traceCapacity];
+					event->scope = record->scope;
+					event->frameNumber = frame->frameNumber;
+					event->startNanoseconds = (uint64_t)((double)begin * profiler->timestampPeriod);
+					event->durationNanoseconds = (uint64_t)nanoseconds;
+					profiler->traceEventCount += 1;
+				}
+			}
+
+			frame->pending = false;
+			profiler->resolvedFrameCount += 1;
+			resolvedCount += 1;
+		}
+		return resolvedCount;
+	}
+
+	VkResult exportGpuProfilerTrace(const GpuProfiler* profiler, const char* path)
+	{
+		if (!profiler->traceCapacity)
+			return VK_ERROR_INITIALIZATION_FAILED;
+
+		FILE* file = fopen(path, "wb");
+		if (!file)
+			return VK_ERROR_INITIALIZATION_FAILED;
+
+		uint64_t eventCount = profiler->traceEventCount < profiler->traceCapacity ? profiler->traceEventCount : profiler->traceCapacity;
+		uint64_t firstEvent = profiler->traceEventCount - eventCount;
+
+		//GPU clock has arbitrary origin, start trace at earliest event
+		uint64_t origin = UINT64_MAX;
+		for (uint64_t i = firstEvent; i < profiler->traceEventCount; ++i)
+		{
+			const GpuTraceEvent* event = &profiler->traceEvents[i % profiler->traceCapacity];
+			if (event->startNanoseconds < origin)
+				origin = event->startNanoseconds;
+		}
+
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		for (uint64_t i = firstEvent; i < profiler->traceEventCount; ++i)
+		{
+			const GpuTraceEvent* event = &profiler->traceEvents[i % profiler->traceCapacity];
+			vkCmdInitWriteTraceEvent(file, profiler->scopes[event->scope].name, "gpu", 2, event->startNanoseconds - origin, event->durationNanoseconds, i + 1 == profiler->traceEventCount);
+		}
+		fprintf(file, "]}\n");
+
+		bool written = !ferror(file);
+		return (fclose(file) == 0 && written) ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED;
+	}
+
+	void destroyGpuProfiler(InitializationStruct* initStruct, GpuProfiler* profiler)
+	{
+		for (uint32_t i = 0; profiler->frames && i < profiler->frameCount; ++i)
+		{
+			if (profiler->frames[i].queryPool)
+				initStruct->deviceTable.vkDestroyQueryPool(initStruct->device, profiler->frames[i].queryPool, initStruct->allocationCallbacks);
+			vkCmdInitHostFree(initStruct, profiler->frames[i].records);
+		}
+		vkCmdInitHostFree(initStruct, profiler->frames);
+		vkCmdInitHostFree(initStruct, profiler->queryResults);
+		vkCmdInitHostFree(initStruct, profiler->scopes);
+		vkCmdInitHostFree(initStruct, profiler->traceEvents);
+		vkCmdInitHostFree(initStruct, profiler);
+	}
+
+#ifndef VKCMDINIT_DEBUG_MESSAGE_SIZE
+#define VKCMDINIT_DEBUG_MESSAGE_SIZE 2048
+#endif
+
+#define VKCMDINIT_DEBUG_SINK_ID_CAPACITY 1024 //power of 2
+#define VKCMDINIT_DEBUG_SINK_IDLE_MILLISECONDS 100
+
+	//Slot of bounded MPSC ring (Vyukov). sequence == position means free for producer of that position,
+	//position + 1 means filled for consumer
+	typedef struct VkCmdInitDebugMessage
+	{
+		volatile long sequence;
+		VkDebugUtilsMessageSeverityFlagBitsEXT severity;
+		VkDebugUtilsMessageTypeFlagsEXT types;
+		int32_t messageIdNumber;
+		char messageIdName[64];
+		char message[VKCMDINIT_DEBUG_MESSAGE_SIZE];
+	} VkCmdInitDebugMessage;
+
+	typedef struct VkCmdInitDebugIdCounter
+	{
+		volatile long long key; //messageIdNumber | 1 << 32, 0 means empty
+		volatile long windowStart; //milliseconds
+		volatile long windowCount;
+		volatile long long receivedCount;
+		volatile long long deliveredCount;
+		volatile long long suppressedCount;
+		volatile long long droppedCount;
+	} VkCmdInitDebugIdCounter;
+
+	struct DebugSink
+	{
+		PFN_vkDebugUtilsMessengerCallbackEXT callback;
+		void* userData;
+		uint32_t repeatLimitPerSecond;
+
+		VkCmdInitDebugMessage* messages;
+		uint32_t capacity; //power of 2
+		volatile long enqueuePosition;
+		volatile long dequeuePosition; //written only by sink thread
+
+		VkCmdInitDebugIdCounter ids[VKCMDINIT_DEBUG_SINK_ID_CAPACITY];
+		volatile long untrackedIdCount;
+
+		volatile long long receivedCount;
+		volatile long long deliveredCount;
+		volatile long long suppressedCount;
+		volatile long long droppedCount;
+		volatile long long truncatedCount;
+
+		//Producers never take the mutex unless sink thread announced it's going to sleep
+		VkCmdInitMutex mutex;
+		VkCmdInitCondition messagesAvailable;
+		VkCmdInitCondition messagesDelivered;
+		volatile long sleeping;
+		bool stopping;
+
+		VkCmdInitThreadEntry entry;
+		VkCmdInitThread thread;
+		bool started;
+	};
+
+	//Wraparound-safe position difference
+	static long vkCmdInitPositionDelta(long a, long b)
+	{
+		return (long)((unsigned long)a - (unsigned long)b);
+	}
+
+	//NULL if table is full, such ids aren't rate limited
+	static VkCmdInitDebugIdCounter* vkCmdInitFindDebugId(DebugSink* sink, int32_t messageIdNumber)
+	{
+		long long key = (long long)(uint32_t)messageIdNumber | (1ll << 32);
+		uint32_t index = ((uint32_t)messageIdNumber * 2654435761u) & (VKCMDINIT_DEBUG_SINK_ID_CAPACITY - 1);
+		for (uint32_t probe = 0; probe < VKCMDINIT_DEBUG_SINK_ID_CAPACITY; ++probe)
+		{
+			VkCmdInitDebugIdCounter* counter = &sink->ids[(index + probe) & (VKCMDINIT_DEBUG_SINK_ID_CAPACITY - 1)];
+			long long existing = VKCMDINIT_ATOMIC_LOAD64(&counter->key);
+			if (!existing && VKCMDINIT_ATOMIC_CAS64(&counter->key, 0, key))
+				return counter;
+			if (!existing)
+				existing = VKCMDINIT_ATOMIC_LOAD64(&counter->key);
+			if (existing == key)
+				return counter;
+		}
+		return NULL;
+	}
+
+	static bool vkCmdInitDebugIdOverLimit(DebugSink* sink, VkCmdInitDebugIdCounter* counter)
+	{
+		long now = (long)(vkCmdInitNanoseconds() / 1000000);
+		long windowStart = VKCMDINIT_ATOMIC_LOAD(&counter->windowStart);
+		//Racing producers may both see an old window, only one restarts it
+		if (vkCmdInitPositionDelta(now, windowStart) >= 1000 && VKCMDINIT_ATOMIC_CAS(&counter->windowStart, windowStart, now))
+			VKCMDINIT_ATOMIC_STORE(&counter->windowCount, 0);
+		return (uint32_t)VKCMDINIT_ATOMIC_ADD(&counter->windowCount, 1) > sink->repeatLimitPerSecond;
+	}
+
+	static size_t vkCmdInitCopyTruncated(char* destination, size_t capacity, const char* source)
+	{
+		size_t length = source ? strlen(source) : 0;
+		size_t copied = length < capacity ? length : capacity - 1;
+		memcpy(destination, source ? source : "", copied);
+		destination[copied] = '\0';
+		return length - copied;
+	}
+
+	//Runs on whatever thread triggered the message, never blocks on the sink thread
+	static VkBool32 VKAPI_CALL vkCmdInitDebugSinkCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageTypes, const VkDebugUtilsMessengerCallbackDataEXT* callbackData, void* userData)
+	{
+		DebugSink* sink = (DebugSink*)userData;
+		VKCMDINIT_ATOMIC_ADD64(&sink->receivedCount, 1);
+
+		VkCmdInitDebugIdCounter* counter = vkCmdInitFindDebugId(sink, callbackData->messageIdNumber);
+		if (counter)
+			VKCMDINIT_ATOMIC_ADD64(&counter->receivedCount, 1);
+		else
+			VKCMDINIT_ATOMIC_ADD(&sink->untrackedIdCount, 1);
+
+		if (counter && sink->repeatLimitPerSecond && vkCmdInitDebugIdOverLimit(sink, counter))
+		{
+			VKCMDINIT_ATOMIC_ADD64(&sink->suppressedCount, 1);
+			VKCMDINIT_ATOMIC_ADD64(&counter->suppressedCount, 1);
+			return VK_FALSE;
+		}
+
+		VkCmdInitDebugMessage* message = NULL;
+		long position = VKCMDINIT_ATOMIC_LOAD(&sink->enqueuePosition);
+		for (;;)
+		{
+			VkCmdInitDebugMessage* slot = &sink->messages[(unsigned long)position & (sink->capacity - 1)];
+			long delta = vkCmdInitPositionDelta(VKCMDINIT_ATOMIC_LOAD(&slot->sequence), position);
+			if (delta == 0 && VKCMDINIT_ATOMIC_CAS(&sink->enqueuePosition, position, position + 1))
+			{
+				message = slot;
+				break;
+			}
+			if (delta < 0)
+				break; //full, consumer hasn't released slot from previous lap
+			position = VKCMDINIT_ATOMIC_LOAD(&sink->enqueuePosition);
+		}
+
+		if (!message)
+		{
+			VKCMDINIT_ATOMIC_ADD64(&sink->droppedCount, 1);
+			if (counter)
+				VKCMDINIT_ATOMIC_ADD64(&counter->droppedCount, 1);
+			return VK_FALSE;
+		}
+
+		message->severity = messageSeverity;
+		message->types = messageTypes;
+		message->messageIdNumber = callbackData->messageIdNumber;
+		vkCmdInitCopyTruncated(message->messageIdName, sizeof(message->messageIdName), callbackData->pMessageIdName);
+		if (vkCmdInitCopyTruncated(message->message, sizeof(message->message), callbackData->pMessage))
+			VKCMDINIT_ATOMIC_ADD64(&sink->truncatedCount, 1);
+		VKCMDINIT_ATOMIC_STORE(&message->sequence, position + 1);
+
+		if (VKCMDINIT_ATOMIC_LOAD(&sink->sleeping) && VKCMDINIT_ATOMIC_EXCHANGE(&sink->sleeping, 0))
+		{
+			vkCmdInitMutexLock(&sink->mutex);
+			vkCmdInitConditionSignal(&sink->messagesAvailable);
+			vkCmdInitMutexUnlock(&sink->mutex);
+		}
+		return VK_FALSE;
+	}
+
+	static bool vkCmdInitDeliverDebugMessage(DebugSink* sink)
+	{
+		long position = sink->dequeuePosition;
+		VkCmdInitDebugMessage* message = &sink->messages[(unsigned long)position & (sink->capacity - 1)];
+		if (vkCmdInitPositionDelta(VKCMDINIT_ATOMIC_LOAD(&message->sequence), position + 1) != 0)
+			return false;
+
+		VkDebugUtilsMessengerCallbackDataEXT callbackData = { ZERO };
+		callbackData.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT;
+		callbackData.pMessageIdName = message->messageIdName[0] ? message->messageIdName : NULL;
+		callbackData.messageIdNumber = message->messageIdNumber;
+		callbackData.pMessage = message->message;
+		sink->callback(message->severity, message->types, &callbackData, sink->userData);
+
+		VkCmdInitDebugIdCounter* counter = vkCmdInitFindDebugId(sink, message->messageIdNumber);
+		if (counter)
+			VKCMDINIT_ATOMIC_ADD64(&counter->deliveredCount, 1);
+		VKCMDINIT_ATOMIC_ADD64(&sink->deliveredCount, 1);
+
+		//Slot is free for producer one lap later
+		VKCMDINIT_ATOMIC_STORE(&message->sequence, position + (long)sink->capacity);
+		VKCMDINIT_ATOMIC_STORE(&sink->dequeuePosition, position + 1);
+		return true;
+	}
+
+	static void vkCmdInitDebugSinkLoop(void* argument)
+	{
+		DebugSink* sink = (DebugSink*)argument;
+		for (;;)
+		{
+			if (vkCmdInitDeliverDebugMessage(sink))
+				continue;
+
+			vkCmdInitMutexLock(&sink->mutex);
+			vkCmdInitConditionBroadcast(&sink->messagesDelivered);
+			if (sink->stopping)
+			{
+				vkCmdInitMutexUnlock(&sink->mutex);
+				return;
+			}
+			//Producer that published after the check above may have missed the flag, timeout picks its message up
+			VKCMDINIT_ATOMIC_STORE(&sink->sleeping, 1);
+			vkCmdInitConditionWaitFor(&sink->messagesAvailable, &sink->mutex, VKCMDINIT_DEBUG_SINK_IDLE_MILLISECONDS);
+			VKCMDINIT_ATOMIC_STORE(&sink->sleeping, 0);
+			vkCmdInitMutexUnlock(&sink->mutex);
+		}
+	}
+
+	InitializationStruct* withDebugOutputSink(InitializationStruct* initStruct, PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc, void* userData, VkDebugUtilsMessageSeverityFlagsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, uint32_t ringCapacity, uint32_t repeatLimitPerSecond)
+	{
+		//NULL if VK_EXT_debug_utils wasn't added with addExtension
+		if (!initStruct->instanceTable.vkCreateDebugUtilsMessengerEXT || initStruct->debugSink)
+			return initStruct;
+
+		uint32_t capacity = 1;
+		while (capacity < (ringCapacity ? ringCapacity : 256))
+			capacity <<= 1;
+
+		DebugSink* sink = (DebugSink*)vkCmdInitHostAllocate(initStruct, sizeof(DebugSink), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+		if (!sink)
+			return initStruct;
+		memset(sink, 0, sizeof(DebugSink));
+		sink->messages = (VkCmdInitDebugMessage*)vkCmdInitHostAllocate(initStruct, sizeof(VkCmdInitDebugMessage) * capacity, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+		if (!sink->messages)
+		{
+			vkCmdInitHostFree(initStruct, sink);
+			return initStruct;
+		}
+		for (uint32_t i = 0; i < capacity; ++i)
+			sink->messages[i].sequence = (long)i;
+
+		sink->callback = debugOutputProc;
+		sink->userData = userData;
+		sink->repeatLimitPerSecond = repeatLimitPerSecond;
+		sink->capacity = capacity;
+		vkCmdInitMutexInit(&sink->mutex);
+		vkCmdInitConditionInit(&sink->messagesAvailable);
+		vkCmdInitConditionInit(&sink->messagesDelivered);
+		sink->entry.function = vkCmdInitDebugSinkLoop;
+		sink->entry.argument = sink;
+		sink->started = vkCmdInitThreadStart(&sink->thread, &sink->entry);
+		initStruct->debugSink = sink;
+		if (!sink->started)
+		{
+			vkCmdInitDestroyDebugSink(initStruct);
+			return initStruct;
+		}
+
+		return withDebugOutput(initStruct, vkCmdInitDebugSinkCallback, sink, messageSeverity, messageType);
+	}
+
+	void flushDebugOutputSink(InitializationStruct* initStruct)
+	{
+		DebugSink* sink = initStruct->debugSink;
+		if (!sink)
+			return;
+
+		//Claimed but not yet published slots are waited for too, producer finishes them without blocking
+		long target = VKCMDINIT_ATOMIC_LOAD(&sink->enqueuePosition);
+		vkCmdInitMutexLock(&sink->mutex);
+		while (vkCmdInitPositionDelta(VKCMDINIT_ATOMIC_LOAD(&sink->dequeuePosition), target) < 0)
+		{
+			vkCmdInitConditionSignal(&sink->messagesAvailable);
+			vkCmdInitConditionWaitFor(&sink->messagesDelivered, &sink->mutex, VKCMDINIT_DEBUG_SINK_IDLE_MILLISECONDS);
+		}
+		vkCmdInitMutexUnlock(&sink->mutex);
+	}
+
+	bool getDebugOutputSinkStats(const InitializationStruct* initStruct, DebugSinkStats* stats, /*can be null*/ uint32_t* idStatCount, /*can be null*/ DebugMessageIdStats* idStats)
+	{
+		memset(stats, 0, sizeof(*stats));
+		DebugSink* sink = initStruct->debugSink;
+		if (!sink)
+		{
+			if (idStatCount)
+				*idStatCount = 0;
+			return false;
+		}
+
+		stats->receivedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&sink->receivedCount);
+		stats->deliveredCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&sink->deliveredCount);
+		stats->suppressedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&sink->suppressedCount);
+		stats->droppedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&sink->droppedCount);
+		stats->truncatedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&sink->truncatedCount);
+		stats->untrackedIdCount = (uint32_t)VKCMDINIT_ATOMIC_LOAD(&sink->untrackedIdCount);
+
+		if (!idStatCount)
+			return true;
+		uint32_t written = 0;
+		for (uint32_t i = 0; i < VKCMDINIT_DEBUG_SINK_ID_CAPACITY; ++i)
+		{
+			VkCmdInitDebugIdCounter* counter = &sink->ids[i];
+			long long key = VKCMDINIT_ATOMIC_LOAD64(&counter->key);
+			if (!key)
+				continue;
+			if (idStats && written < *idStatCount)
+			{
+				DebugMessageIdStats* idStat = &idStats[written];
+				idStat->messageIdNumber = (int32_t)(uint32_t)key;
+				idStat->receivedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&counter->receivedCount);
+				idStat->deliveredCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&counter->deliveredCount);
+				idStat->suppressedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&counter->suppressedCount);
+				idStat->droppedCount = (uint64_t)VKCMDINIT_ATOMIC_LOAD64(&counter->droppedCount);
+			}
+			else if (idStats)
+				break;
+			written += 1;
+		}
+		*idStatCount = written;
+		return true;
+	}
+
+	static void vkCmdInitDestroyDebugSink(InitializationStruct* initStruct)
+	{
+		DebugSink* sink = initStruct->debugSink;
+		if (!sink)
+			return;
+
+		if (sink->started)
+		{
+			vkCmdInitMutexLock(&sink->mutex);
+			sink->stopping = true;
+			vkCmdInitConditionSignal(&sink->messagesAvailable);
+			vkCmdInitMutexUnlock(&sink->mutex);
+			//Loop only stops once ring is empty, so nothing queued is lost
+			vkCmdInitThreadJoin(sink->thread);
+		}
+		vkCmdInitConditionDestroy(&sink->messagesDelivered);
+		vkCmdInitConditionDestroy(&sink->messagesAvailable);
+		vkCmdInitMutexDestroy(&sink->mutex);
+		vkCmdInitHostFree(initStruct, sink->messages);
+		vkCmdInitHostFree(initStruct, sink);
+		initStruct->debugSink = NULL;
+	}
+
+#ifdef VKCMDINIT_CPP
+}
+#endif
+
+#endif
+
+#if defined(VKCMDINIT_CPP)
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#define VKCMDINIT_CPP20
+#include <span>
+#include <utility>
+#endif
+
+namespace vki
+{
+	//Creates instance of InitialziationStruct with basic application information
+	inline InitializationStruct createApplication(
 		const char* engineName,
 		const char* applicationName,
 		uint32_t applicationVersion,
@@ -668,141 +9084,2017 @@ namespace vki
 		uint32_t apiVersion
 	) CPPONLY(noexcept)
 	{
-		return ::createApplication(engineName, applicationName, applicationVersion, engineVersion, apiVersion);
+		return ::createApplication(engineName, applicationName, applicationVersion, engineVersion, apiVersion);
+	}
+
+	//Adds instance extension, for device extensions see createDevice
+	inline InitializationStruct& addExtension(
+		InitializationStruct& initStruct,
+		const char* extensionName
+	) CPPONLY(noexcept)
+	{
+		return *(addExtension(&initStruct, extensionName));
+	}
+
+	//Selects validation startInstance enables. Layers are checked with vkEnumerateInstanceLayerProperties first, what isn't
+	//installed is skipped, see validationEnabled and validationFeaturesEnabled. Call before startInstance
+	inline InitializationStruct& withValidation(
+		InitializationStruct& initStruct,
+		ValidationProfile profile,
+		/*ValidationFeatureBits, only used by VALIDATION_PROFILE_EXTENDED*/ uint32_t validationFeatures = 0
+	) CPPONLY(noexcept)
+	{
+		return *withValidation(&initStruct, profile, validationFeatures);
+	}
+
+	//Starts a vulkan instance with extensions provided using addExtension
+	inline InitializationStruct& startInstance(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *startInstance(&initStruct);
+	}
+
+	//Destroys device with what library created on it (retired swapchains, memory allocator, pipeline cache after saving it),
+	//so device can go before instance. App's objects on device have to be destroyed first. terminateInstance calls it
+	inline void destroyDevice(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		destroyDevice(&initStruct);
+	}
+
+	//Destroys surface of withSurface* call, swapchains on it have to be destroyed first. terminateInstance calls it
+	inline void destroySurface(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		destroySurface(&initStruct);
+	}
+
+	//Terminates vulkan instance, aswell as cleans up instance extension objects created using vkCmdInit
+	inline void terminateInstance(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return terminateInstance(&initStruct);
+	}
+
+	//Enumerates and selects a suitable physical device, provide deviceEnumerator for custom selection rules
+	inline InitializationStruct& selectPhysicalDevices(
+		InitializationStruct& initStruct,
+		/*can be NULL. If so, selects first device available*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices,
+			size_t deviceCount, /*ex. required device extensions*/ void* additionalData) = nullptr,
+		/*if device enumerator is null, can be null, because default implementation ignores it*/ void* additionalData = nullptr
+	) CPPONLY(noexcept)
+	{
+		return *selectPhysicalDevices(&initStruct, deviceEnumerator, additionalData);
+	}
+
+	//Selects highest scored physical device according to policy
+	inline InitializationStruct& selectPhysicalDevices(
+		InitializationStruct& initStruct,
+		const DeviceSelectionPolicy& policy
+	) CPPONLY(noexcept)
+	{
+		return *selectPhysicalDevices(&initStruct, nullptr, (void*)&policy);
+	}
+
+	//Default weights: discrete > integrated > virtual > CPU, then device local memory and dedicated queues. Graphics queue
+	//and (with surface) presentation support are required
+	inline DeviceSelectionPolicy defaultDeviceSelectionPolicy(
+	) CPPONLY(noexcept)
+	{
+		return ::defaultDeviceSelectionPolicy();
+	}
+
+	//Scores every physical device, works like vkEnumerate* (scores NULL -> count only). Call after surface is created so presentation support is counted
+	inline void scorePhysicalDevices(
+		InitializationStruct& initStruct,
+		/*can be null, if so, uses default policy*/ const DeviceSelectionPolicy* policy,
+		uint32_t& scoreCount,
+		/*can be null*/ PhysicalDeviceScore* scores
+	) CPPONLY(noexcept)
+	{
+		scorePhysicalDevices(&initStruct, policy, &scoreCount, scores);
+	}
+
+	//Creates logical device with extensions provided
+	inline InitializationStruct& createDevice(
+		InitializationStruct& initStruct,
+		/*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount),
+		const char* const* deviceExtensions,
+		uint32_t deviceExtensionCount
+	) CPPONLY(noexcept)
+	{
+		return *createDevice(&initStruct, deviceDesigner, deviceExtensions, deviceExtensionCount);
+	}
+
+	//retrieves queues from physical device object, if deviceDesigner in createDevice call wasn't NULL, provide custom queueRetriever function
+	inline void retrieveQueues(
+		InitializationStruct& initStruct,
+		/*if queueRetriever isn't custom, should be array of a graphics queue and a presentation queue (non-initialized if VkSurfaceKHR isn't present)*/ VkQueue* queues,
+		uint32_t** familyIndices,
+		/*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices) = nullptr
+	) CPPONLY(noexcept)
+	{
+		::retrieveQueues(&initStruct,queues,familyIndices, queueRetriever);
+	}
+
+
+	//retrieves queues from physical device object, if deviceDesigner in createDevice call wasn't NULL, provide custom queueRetriever function
+	inline void retrieveQueues(
+		InitializationStruct& initStruct,
+		/*all four queues if queueRetriever is null (see retrieveDefaultQueues), otherwise what custom retriever fills*/ DefaultQueueRetrieveStruct& queues,
+		uint32_t** familyIndices,
+		/*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices) = nullptr
+	) CPPONLY(noexcept)
+	{
+		if (queueRetriever)
+			::retrieveQueues(&initStruct,(VkQueue*)&queues, familyIndices, queueRetriever);
+		else
+			::retrieveDefaultQueues(&initStruct, &queues, familyIndices);
+	}
+
+	//retrieveQueues of default createDevice path with compute and transfer queues as well, familyIndices gets DefaultQueueIndices.
+	//Does nothing if createDevice was called with custom deviceDesigner
+	inline void retrieveDefaultQueues(
+		InitializationStruct& initStruct,
+		DefaultQueueRetrieveStruct& queues,
+		uint32_t** familyIndices
+	) CPPONLY(noexcept)
+	{
+		::retrieveDefaultQueues(&initStruct, &queues, familyIndices);
+	}
+
+	//Requests up to queueCount queues from family of role in default createDevice path (call before createDevice). Clamped to what
+	//the family offers. If roles share a family, larger count wins and priorities are maxed per queue
+	inline InitializationStruct& withQueueCount(
+		InitializationStruct& initStruct,
+		QueueRole role,
+		uint32_t queueCount,
+		/*can be null (all 1.0f), otherwise queueCount priorities in [0, 1], has to stay alive until createDevice*/ const float* priorities = nullptr
+	) CPPONLY(noexcept)
+	{
+		return *withQueueCount(&initStruct, role, queueCount, priorities);
+	}
+
+	//Returns queue queueIndex of family of role, VK_NULL_HANDLE if family has less queues. Default createDevice path only
+	inline VkQueue retrieveQueue(
+		InitializationStruct& initStruct,
+		QueueRole role,
+		uint32_t queueIndex
+	) CPPONLY(noexcept)
+	{
+		return retrieveQueue(&initStruct, role, queueIndex);
+	}
+
+	//Hands out one queue per worker thread, worker i gets queue i % returned count, so as long as workerCount <= returned count
+	//every worker submits to its own queue without locking. Queue 0 of graphics and presentation family is left out, frame loop
+	//submits to it. Returns count of queues handed out (workerQueues can be null), 0 if family has no other queue (see withQueueCount)
+	inline uint32_t retrieveWorkerQueues(
+		InitializationStruct& initStruct,
+		QueueRole role,
+		uint32_t workerCount,
+		/*can be null*/ VkQueue* workerQueues
+	) CPPONLY(noexcept)
+	{
+		return retrieveWorkerQueues(&initStruct, role, workerCount, workerQueues);
+	}
+
+	//Sets size of device memory blocks the sub-allocator carves allocations from (default 64 MiB, capped at 1/8 of the heap).
+	//Call before first allocation
+	inline InitializationStruct& withMemoryAllocator(
+		InitializationStruct& initStruct,
+		VkDeviceSize blockSize
+	) CPPONLY(noexcept)
+	{
+		return *withMemoryAllocator(&initStruct, blockSize);
+	}
+
+	//Creates swapchain images with VK_IMAGE_USAGE_TRANSFER_SRC_BIT so they can be copied by recordImageReadback.
+	//Call before createSwapchainKHR
+	inline InitializationStruct& withSwapchainReadback(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *withSwapchainReadback(&initStruct);
+	}
+
+	//Enables timelineSemaphore feature in default createDevice path (call before createDevice), required by TimelineQueue.
+	//Core in 1.2, for 1.1 devices pass VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME in deviceExtensions
+	inline InitializationStruct& withTimelineSemaphores(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *withTimelineSemaphores(&initStruct);
+	}
+
+	//Enables descriptor indexing features BindlessTable needs in default createDevice path (call before createDevice).
+	//Core in 1.2, for 1.1 devices pass VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME in deviceExtensions
+	inline InitializationStruct& withBindlessDescriptors(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *withBindlessDescriptors(&initStruct);
+	}
+
+	//Nothing required. Optional: anisotropy, multi draw indirect, timeline semaphores, buffer device address, descriptor indexing,
+	//synchronization2, dynamic rendering and maintenance4, so fast paths are on wherever device has them
+	inline FeatureRequest defaultFeatureRequest(
+	) CPPONLY(noexcept)
+	{
+		return ::defaultFeatureRequest();
+	}
+
+	//Negotiates request against one enumeration of layers/extensions/features in startInstance and default createDevice path,
+	//result is in initStruct.featureGrant. Call before startInstance, request has to stay alive until createDevice
+	inline InitializationStruct& withFeatureRequest(
+		InitializationStruct& initStruct,
+		const FeatureRequest& request
+	) CPPONLY(noexcept)
+	{
+		return *withFeatureRequest(&initStruct, &request);
+	}
+
+	//Starts recording how long every init step takes (startInstance, selectPhysicalDevices, createDevice, createSwapchainKHR...)
+	//and the Vulkan calls they make. Call right after createApplication (and withAllocationCallbacks), trace is freed by terminateInstance
+	inline InitializationStruct& withInitTracing(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *withInitTracing(&initStruct);
+	}
+
+	//Opens scope of app's own init work (ex. shader loading), so it shows up next to library steps. UINT32_MAX if tracing is off
+	inline uint32_t beginTraceScope(
+		InitializationStruct& initStruct,
+		/*has to outlive the trace*/ const char* name
+	) CPPONLY(noexcept)
+	{
+		return beginTraceScope(&initStruct, name);
+	}
+
+	inline void endTraceScope(
+		InitializationStruct& initStruct,
+		uint32_t traceScope
+	) CPPONLY(noexcept)
+	{
+		endTraceScope(&initStruct, traceScope);
+	}
+
+	//Writes trace as Chrome trace event JSON, open it in chrome://tracing or ui.perfetto.dev. Call before terminateInstance
+	inline VkResult exportInitTrace(
+		const InitializationStruct& initStruct,
+		const char* path
+	) CPPONLY(noexcept)
+	{
+		return exportInitTrace(&initStruct, path);
+	}
+
+	//Routes every create/destroy call and library's host memory through allocationCallbacks (except JobSystem, writeShaderArchive
+	//and swapchain image arrays handed to app, those stay on CRT). Call right after createApplication,
+	//callbacks have to outlive terminateInstance. With trackStatistics, allocations are counted per scope, see getAllocationStats.
+	//Extensions added before are moved to new callbacks, does nothing once instance, scratch memory, init trace or statistics exist
+	inline InitializationStruct& withAllocationCallbacks(
+		InitializationStruct& initStruct,
+		/*can be null (CRT)*/ const VkAllocationCallbacks* allocationCallbacks,
+		bool trackStatistics = false
+	) CPPONLY(noexcept)
+	{
+		return *withAllocationCallbacks(&initStruct, allocationCallbacks, trackStatistics);
+	}
+
+	//Thread safe, drivers allocate from any thread. False (and zeroed stats) if statistics aren't tracked
+	inline bool getAllocationStats(
+		const InitializationStruct& initStruct,
+		AllocationStats& stats
+	) CPPONLY(noexcept)
+	{
+		return getAllocationStats(&initStruct, &stats);
+	}
+
+	//Sets size of scratch arena blocks (default 64 KiB). Call before startInstance
+	inline InitializationStruct& withScratchArena(
+		InitializationStruct& initStruct,
+		size_t blockSize
+	) CPPONLY(noexcept)
+	{
+		return *withScratchArena(&initStruct, blockSize);
+	}
+
+	inline ScratchMark scratchMark(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return scratchMark(&initStruct);
+	}
+
+	//Memory stays valid until scratchRewind to a mark taken before it. NULL on failure
+	inline void* scratchAllocate(
+		InitializationStruct& initStruct,
+		size_t size
+	) CPPONLY(noexcept)
+	{
+		return scratchAllocate(&initStruct, size);
+	}
+
+	//Frees everything allocated after mark at once
+	inline void scratchRewind(
+		InitializationStruct& initStruct,
+		ScratchMark mark
+	) CPPONLY(noexcept)
+	{
+		scratchRewind(&initStruct, mark);
+	}
+
+	//Sets file the pipeline cache is seeded from and saved to. If called before createDevice, cache is created right after device,
+	//otherwise immediately. Files written by a different device or driver are discarded
+	inline InitializationStruct& withPipelineCache(
+		InitializationStruct& initStruct,
+		const char* cachePath
+	) CPPONLY(noexcept)
+	{
+		return *withPipelineCache(&initStruct, cachePath);
+	}
+
+	//Writes pipeline cache back to disk (write to temporary file + rename), terminateInstance calls it for you
+	inline VkResult savePipelineCache(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return savePipelineCache(&initStruct);
+	}
+
+	//Counts cache hit/miss from VK_EXT_pipeline_creation_feedback output chained into pipeline creation
+	inline void recordPipelineCacheFeedback(
+		InitializationStruct& initStruct,
+		const VkPipelineCreationFeedbackEXT& pipelineFeedback
+	) CPPONLY(noexcept)
+	{
+		recordPipelineCacheFeedback(&initStruct, &pipelineFeedback);
+	}
+
+	//Creates debug messenger, for simpler calls see withDebugOutput1 and withDebugOutput2
+	inline InitializationStruct& withDebugOutput(
+		InitializationStruct& initStruct,
+		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
+		void* userData,
+		VkDebugUtilsMessageSeverityFlagsEXT messageSeverity,
+		VkDebugUtilsMessageTypeFlagsEXT messageType
+	) CPPONLY(noexcept)
+	{
+		return *withDebugOutput(&initStruct, debugOutputProc, userData, messageSeverity, messageType);
+	}
+
+	//Creates debug messenger with default settings and pointer to user data, for call without userData see withDebugOutput2
+	inline InitializationStruct& withDebugOutput(
+		InitializationStruct& initStruct,
+		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
+		void* userData = nullptr
+	) CPPONLY(noexcept)
+	{
+		return *withDebugOutput1(&initStruct, debugOutputProc, userData);
+	}
+
+	//Creates debug messenger whose callback only copies message into a lock-free ring, debugOutputProc is called on a background
+	//thread, so thread that triggered the message never waits for it. Objects and labels aren't copied, callback data has only ids
+	//and text. Each messageIdNumber is delivered at most repeatLimitPerSecond times a second (0 means no limit), the rest is counted.
+	//Thread is stopped by terminateInstance after last message was delivered
+	inline InitializationStruct& withDebugOutputSink(
+		InitializationStruct& initStruct,
+		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
+		void* userData = nullptr,
+		uint32_t repeatLimitPerSecond = 5,
+		VkDebugUtilsMessageSeverityFlagsEXT messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+		VkDebugUtilsMessageTypeFlagsEXT messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+		uint32_t ringCapacity = 0 //rounded up to power of 2, 0 means 256
+	) CPPONLY(noexcept)
+	{
+		return *withDebugOutputSink(&initStruct, debugOutputProc, userData, messageSeverity, messageType, ringCapacity, repeatLimitPerSecond);
+	}
+
+	//Blocks until every message queued before the call was delivered (ex. before aborting on error)
+	inline void flushDebugOutputSink(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		flushDebugOutputSink(&initStruct);
+	}
+
+	//Thread safe. idStatCount is capacity of idStats on input and ids written on output, idStats can be null.
+	//False (and zeroed stats) if withDebugOutputSink wasn't used
+	inline bool getDebugOutputSinkStats(
+		const InitializationStruct& initStruct,
+		DebugSinkStats& stats,
+		/*can be null*/ uint32_t* idStatCount = nullptr,
+		/*can be null*/ DebugMessageIdStats* idStats = nullptr
+	) CPPONLY(noexcept)
+	{
+		return getDebugOutputSinkStats(&initStruct, &stats, idStatCount, idStats);
+	}
+
+
+
+#ifdef VKCMDINIT_GLFW
+	//Creates window surface using GLFWwindow (platform-independent)
+	inline InitializationStruct& withSurfaceGLFW(
+		InitializationStruct& initStruct,
+		GLFWwindow* window
+	) CPPONLY(noexcept)
+	{
+		return *(withSurfaceGLFW(&initStruct, window));
+	}
+#endif
+
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+	//Creates window surface for Win32 platform-dependent window
+	inline InitializationStruct& withSurfaceWin32(
+		InitializationStruct& initStruct,
+		HINSTANCE processHandle,
+		HWND windowHandle
+	) CPPONLY(noexcept)
+	{
+		return *(withSurfaceWin32(&initStruct, processHandle, windowHandle));
+
+	}
+#endif
+	//Creates generic swapchain and retrieves images and image views from it, caller frees both arrays with free()
+	inline VkSwapchainKHR createSwapchainKHR(
+		InitializationStruct& initStruct,
+		/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount),
+		/*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount),
+		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+		uint32_t& swapchainImageCount,
+		VkImage*& swapchainImages,
+		/*can be null*/ VkImageView*& swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return createSwapchainKHR(&initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+	}
+
+	//createSwapchainKHR with surface format and present mode already chosen from ones surface supports (ex. by vki::createSwapchainKHR<Config>)
+	inline VkSwapchainKHR createSwapchainKHRWithFormat(
+		InitializationStruct& initStruct,
+		VkSurfaceFormatKHR surfaceFormat,
+		VkPresentModeKHR presentMode,
+		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+		uint32_t& swapchainImageCount,
+		VkImage*& swapchainImages,
+		/*can be null*/ VkImageView*& swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return createSwapchainKHRWithFormat(&initStruct, surfaceFormat, presentMode, surfaceDesigner, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+	}
+
+	//Default surface format selector: B8G8R8A8 in sRGB nonlinear color space, first format if there is none
+	inline VkSurfaceFormatKHR selectDefaultSurfaceFormat(
+		VkSurfaceFormatKHR* surfaceFormats,
+		size_t surfaceFormatCount
+	) CPPONLY(noexcept)
+	{
+		return ::selectDefaultSurfaceFormat(surfaceFormats, surfaceFormatCount);
+	}
+
+	//Default present mode selector: first MAILBOX or FIFO mode, FIFO if there is none
+	inline VkPresentModeKHR selectDefaultPresentMode(
+		VkPresentModeKHR* presentModes,
+		size_t presentModeCount
+	) CPPONLY(noexcept)
+	{
+		return ::selectDefaultPresentMode(presentModes, presentModeCount);
+	}
+
+	//Recreates swapchain created by createSwapchainKHR (i.e. after resize) without waiting for the device.
+	//Format, present mode and surfaceDesigner from createSwapchainKHR are reused and oldSwapchain is handed to the driver.
+	//Image arrays are reused (in: old arrays and count, out: new ones). Old swapchain and image views are destroyed by
+	//collectRetiredSwapchains once frame retireAfterFrame completed. Returns VK_NULL_HANDLE and keeps old swapchain if window is minimized
+	//or out of host memory
+	inline VkSwapchainKHR recreateSwapchainKHR(
+		InitializationStruct& initStruct,
+		VkSwapchainKHR oldSwapchain,
+		/*i.e. current frame number, resources are kept until this frame is done*/ uint64_t retireAfterFrame,
+		uint32_t& swapchainImageCount,
+		VkImage*& swapchainImages,
+		VkImageView*& swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return recreateSwapchainKHR(&initStruct, oldSwapchain, retireAfterFrame, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+	}
+
+	//createSwapchainKHR writing to app's arrays of imageCapacity elements (ex. VKCMDINIT_MAX_SWAPCHAIN_IMAGES) instead of
+	//allocating them. Returns VK_NULL_HANDLE and zero count if swapchain has more images
+	inline VkSwapchainKHR createSwapchainKHRInPlace(
+		InitializationStruct& initStruct,
+		/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount),
+		/*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount),
+		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+		uint32_t imageCapacity,
+		uint32_t& swapchainImageCount,
+		VkImage* swapchainImages,
+		/*can be null*/ VkImageView* swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return createSwapchainKHRInPlace(&initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, imageCapacity, &swapchainImageCount, swapchainImages, swapchainImageViews);
+	}
+
+	//recreateSwapchainKHR for swapchains of createSwapchainKHRInPlace, arrays are overwritten in place
+	inline VkSwapchainKHR recreateSwapchainKHRInPlace(
+		InitializationStruct& initStruct,
+		VkSwapchainKHR oldSwapchain,
+		/*i.e. current frame number, resources are kept until this frame is done*/ uint64_t retireAfterFrame,
+		uint32_t imageCapacity,
+		uint32_t& swapchainImageCount,
+		VkImage* swapchainImages,
+		/*can be null*/ VkImageView* swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return recreateSwapchainKHRInPlace(&initStruct, oldSwapchain, retireAfterFrame, imageCapacity, &swapchainImageCount, swapchainImages, swapchainImageViews);
+	}
+
+	//Destroys swapchains retired by recreateSwapchainKHR whose frames are done, never waits. Call once per frame
+	inline void collectRetiredSwapchains(
+		InitializationStruct& initStruct,
+		/*frames up to and including this one have finished on GPU*/ uint64_t completedFrame
+	) CPPONLY(noexcept)
+	{
+		collectRetiredSwapchains(&initStruct, completedFrame);
+	}
+
+	//Creates windowless surface using VK_EXT_headless_surface (add it with addExtension), createSwapchainKHR works with it as with a window
+	inline InitializationStruct& withSurfaceHeadless(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return *withSurfaceHeadless(&initStruct);
+	}
+
+	//Creates offscreen swapchain with same output contract as createSwapchainKHR: caller destroys image views and frees both arrays (free()),
+	//images themselves belong to the offscreen swapchain. Works without surface and without swapchain extension.
+	//NULL if imageCount is 0 or on failure
+	inline OffscreenSwapchain* createOffscreenSwapchain(
+		InitializationStruct& initStruct,
+		VkFormat format,
+		VkExtent2D extent,
+		uint32_t imageCount,
+		uint32_t& swapchainImageCount,
+		VkImage*& swapchainImages,
+		VkImageView*& swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return createOffscreenSwapchain(&initStruct, format, extent, imageCount, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+	}
+
+	//Counterpart of vkAcquireNextImageKHR, never blocks. Images are handed out round-robin.
+	//Semaphore and fence can be VK_NULL_HANDLE, if not, they are signaled by an empty submit on queue
+	inline VkResult acquireOffscreenImage(
+		InitializationStruct& initStruct,
+		OffscreenSwapchain& offscreenSwapchain,
+		VkQueue queue,
+		VkSemaphore semaphore,
+		VkFence fence,
+		uint32_t& imageIndex
+	) CPPONLY(noexcept)
+	{
+		return acquireOffscreenImage(&initStruct, &offscreenSwapchain, queue, semaphore, fence, &imageIndex);
+	}
+
+	//Counterpart of vkQueuePresentKHR. Nothing is displayed, wait semaphores are consumed by an empty submit so binary semaphores can be reused
+	inline VkResult presentOffscreenImage(
+		InitializationStruct& initStruct,
+		OffscreenSwapchain& offscreenSwapchain,
+		VkQueue queue,
+		uint32_t waitSemaphoreCount,
+		const VkSemaphore* waitSemaphores,
+		uint32_t imageIndex
+	) CPPONLY(noexcept)
+	{
+		return presentOffscreenImage(&initStruct, &offscreenSwapchain, queue, waitSemaphoreCount, waitSemaphores, imageIndex);
+	}
+
+	//Destroys images and their memory, image views returned by createOffscreenSwapchain have to be destroyed before
+	inline void destroyOffscreenSwapchain(
+		InitializationStruct& initStruct,
+		OffscreenSwapchain* offscreenSwapchain
+	) CPPONLY(noexcept)
+	{
+		destroyOffscreenSwapchain(&initStruct, offscreenSwapchain);
+	}
+
+	//Creates frame context. Uses queues and graphics family from default createDevice path, offscreenSwapchain is used if swapchain is VK_NULL_HANDLE.
+	//NULL on failure or if device wasn't created by default path
+	inline FrameContext* createFrameContext(
+		InitializationStruct& initStruct,
+		const DefaultQueueRetrieveStruct& queues,
+		/*2 lets CPU record next frame while GPU renders current one*/ uint32_t framesInFlight,
+		VkSwapchainKHR swapchain,
+		/*can be null*/ OffscreenSwapchain* offscreenSwapchain,
+		uint32_t swapchainImageCount
+	) CPPONLY(noexcept)
+	{
+		return createFrameContext(&initStruct, &queues, framesInFlight, swapchain, offscreenSwapchain, swapchainImageCount);
+	}
+
+	//Waits until frame slot is free, collects retired swapchains, resets the slot's command pool, acquires image and begins commandBuffer.
+	//VK_ERROR_OUT_OF_DATE_KHR means swapchain has to be recreated (see recreateFrameSwapchain), frame wasn't begun then
+	inline VkResult beginFrame(
+		InitializationStruct& initStruct,
+		FrameContext& frameContext,
+		VkCommandBuffer& commandBuffer,
+		uint32_t& imageIndex
+	) CPPONLY(noexcept)
+	{
+		return beginFrame(&initStruct, &frameContext, &commandBuffer, &imageIndex);
+	}
+
+	//Ends command buffer, submits it (waiting for acquired image at color attachment output) and presents.
+	//VK_SUBOPTIMAL_KHR/VK_ERROR_OUT_OF_DATE_KHR mean swapchain should be recreated. If submit fails, frame isn't counted nor presented
+	inline VkResult endFrame(
+		InitializationStruct& initStruct,
+		FrameContext& frameContext
+	) CPPONLY(noexcept)
+	{
+		return endFrame(&initStruct, &frameContext);
+	}
+
+	//Calls recreateSwapchainKHR and points frame context at the new swapchain, old one is retired after frames in flight are done
+	inline VkResult recreateFrameSwapchain(
+		InitializationStruct& initStruct,
+		FrameContext& frameContext,
+		uint32_t& swapchainImageCount,
+		VkImage*& swapchainImages,
+		VkImageView*& swapchainImageViews
+	) CPPONLY(noexcept)
+	{
+		return recreateFrameSwapchain(&initStruct, &frameContext, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+	}
+
+	//Waits for all frames in flight and destroys frame context, swapchain stays alive
+	inline void destroyFrameContext(
+		InitializationStruct& initStruct,
+		FrameContext* frameContext
+	) CPPONLY(noexcept)
+	{
+		destroyFrameContext(&initStruct, frameContext);
+	}
+
+	//Creates timeline queue on top of queue, device has to be created with withTimelineSemaphores. NULL on failure
+	inline TimelineQueue* createTimelineQueue(
+		InitializationStruct& initStruct,
+		VkQueue queue
+	) CPPONLY(noexcept)
+	{
+		return createTimelineQueue(&initStruct, queue);
+	}
+
+	//Wait on point of a timeline queue, use it to express cross-queue dependencies (ex. transfer -> compute -> graphics).
+	//Waiting on point not yet flushed on other queue is valid (wait-before-signal), it just has to be flushed eventually
+	inline TimelineWait timelinePoint(
+		const TimelineQueue& timelineQueue,
+		uint64_t value,
+		VkPipelineStageFlags stageMask
+	) CPPONLY(noexcept)
+	{
+		return timelinePoint(&timelineQueue, value, stageMask);
+	}
+
+	//Records submission without calling vkQueueSubmit, returns timeline point it signals on completion (0 on allocation failure)
+	inline uint64_t enqueueSubmit(
+		TimelineQueue& timelineQueue,
+		const VkCommandBuffer* commandBuffers,
+		uint32_t commandBufferCount,
+		/*can be null*/ const TimelineWait* waits = nullptr,
+		uint32_t waitCount = 0,
+		/*can be VK_NULL_HANDLE, ex. semaphore presentation waits on*/ VkSemaphore binarySignalSemaphore = VK_NULL_HANDLE
+	) CPPONLY(noexcept)
+	{
+		return enqueueSubmit(&timelineQueue, commandBuffers, commandBufferCount, waits, waitCount, binarySignalSemaphore);
+	}
+
+	//Submits every pending submission with one vkQueueSubmit
+	inline VkResult flushTimelineQueue(
+		InitializationStruct& initStruct,
+		TimelineQueue& timelineQueue,
+		/*can be VK_NULL_HANDLE*/ VkFence fence = VK_NULL_HANDLE
+	) CPPONLY(noexcept)
+	{
+		return flushTimelineQueue(&initStruct, &timelineQueue, fence);
+	}
+
+	//Non-blocking check if GPU reached value
+	inline bool isTimelinePointReached(
+		InitializationStruct& initStruct,
+		TimelineQueue& timelineQueue,
+		uint64_t value
+	) CPPONLY(noexcept)
+	{
+		return isTimelinePointReached(&initStruct, &timelineQueue, value);
+	}
+
+	//Flushes if value is still pending and waits until GPU reaches it. VK_NOT_READY if value was never enqueued
+	inline VkResult waitTimelinePoint(
+		InitializationStruct& initStruct,
+		TimelineQueue& timelineQueue,
+		uint64_t value,
+		uint64_t timeout = UINT64_MAX
+	) CPPONLY(noexcept)
+	{
+		return waitTimelinePoint(&initStruct, &timelineQueue, value, timeout);
+	}
+
+	//Flushes, waits for everything submitted and destroys timeline queue
+	inline void destroyTimelineQueue(
+		InitializationStruct& initStruct,
+		TimelineQueue* timelineQueue
+	) CPPONLY(noexcept)
+	{
+		destroyTimelineQueue(&initStruct, timelineQueue);
+	}
+
+	//Allocates memory for buffer and binds it. Dedicated allocation is used if driver prefers it (VK_KHR_dedicated_allocation, core 1.1)
+	//or buffer is larger than half a block
+	inline VkResult allocateBufferMemory(
+		InitializationStruct& initStruct,
+		VkBuffer buffer,
+		GpuMemoryUsage usage,
+		GpuAllocation& allocation
+	) CPPONLY(noexcept)
+	{
+		return allocateBufferMemory(&initStruct, buffer, usage, &allocation);
+	}
+
+	//Allocates memory for image and binds it, see allocateBufferMemory. Image is assumed to have optimal tiling
+	inline VkResult allocateImageMemory(
+		InitializationStruct& initStruct,
+		VkImage image,
+		GpuMemoryUsage usage,
+		GpuAllocation& allocation
+	) CPPONLY(noexcept)
+	{
+		return allocateImageMemory(&initStruct, image, usage, &allocation);
+	}
+
+	//Returns allocation to its block (or frees dedicated memory), resource bound to it has to be destroyed already
+	inline void freeAllocation(
+		InitializationStruct& initStruct,
+		GpuAllocation& allocation
+	) CPPONLY(noexcept)
+	{
+		freeAllocation(&initStruct, &allocation);
+	}
+
+	//Creates linear arena of capacity bytes. With bufferUsage, a buffer covering whole arena is created and offsets are relative to it,
+	//otherwise offsets are relative to allocation.offset (add it when binding). NULL on failure
+	inline GpuLinearArena* createLinearArena(
+		InitializationStruct& initStruct,
+		VkDeviceSize capacity,
+		GpuMemoryUsage usage,
+		/*0 = raw memory*/ VkBufferUsageFlags bufferUsage = 0
+	) CPPONLY(noexcept)
+	{
+		return createLinearArena(&initStruct, capacity, usage, bufferUsage);
+	}
+
+	//O(1) bump allocation, VK_ERROR_OUT_OF_DEVICE_MEMORY if arena is full
+	inline VkResult allocateFromArena(
+		GpuLinearArena& arena,
+		VkDeviceSize size,
+		/*power of two*/ VkDeviceSize alignment,
+		VkDeviceSize& offset,
+		/*can be null*/ void** mappedData = nullptr
+	) CPPONLY(noexcept)
+	{
+		return allocateFromArena(&arena, size, alignment, &offset, mappedData);
+	}
+
+	//Releases everything allocated from arena in O(1)
+	inline void resetLinearArena(
+		GpuLinearArena& arena
+	) CPPONLY(noexcept)
+	{
+		resetLinearArena(&arena);
+	}
+
+	inline void destroyLinearArena(
+		InitializationStruct& initStruct,
+		GpuLinearArena* arena
+	) CPPONLY(noexcept)
+	{
+		destroyLinearArena(&initStruct, arena);
+	}
+
+	//Walks all blocks, so don't call it every frame
+	inline GpuMemoryStats getMemoryStats(
+		InitializationStruct& initStruct,
+		/*can be null, otherwise VK_MAX_MEMORY_TYPES entries*/ GpuMemoryStats* memoryTypeStats = nullptr
+	) CPPONLY(noexcept)
+	{
+		GpuMemoryStats totalStats;
+		getMemoryStats(&initStruct, memoryTypeStats, &totalStats);
+		return totalStats;
+	}
+
+	//Creates upload ring of capacity bytes. Device has to be created with withTimelineSemaphores.
+	//Submits to transfer queue of default createDevice path, unless queue is given. NULL on failure
+	inline UploadRing* createUploadRing(
+		InitializationStruct& initStruct,
+		VkDeviceSize capacity,
+		/*can be VK_NULL_HANDLE*/ VkQueue queue = VK_NULL_HANDLE,
+		/*ignored if queue is VK_NULL_HANDLE*/ uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED
+	) CPPONLY(noexcept)
+	{
+		return createUploadRing(&initStruct, queue, queueFamilyIndex, capacity);
+	}
+
+	//Copies data into ring and records copy to dstBuffer, data can be freed right after. Uploads larger than half of the ring are split.
+	//If dstQueueFamilyIndex differs from ring's family, ownership is released to it, consumer has to record matching acquire barrier
+	inline VkResult uploadToBuffer(
+		InitializationStruct& initStruct,
+		UploadRing& uploadRing,
+		VkBuffer dstBuffer,
+		VkDeviceSize dstOffset,
+		const void* data,
+		VkDeviceSize size,
+		/*VK_QUEUE_FAMILY_IGNORED if buffer is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED
+	) CPPONLY(noexcept)
+	{
+		return uploadToBuffer(&initStruct, &uploadRing, dstBuffer, dstOffset, data, size, dstQueueFamilyIndex);
+	}
+
+	//Copies tightly packed texels into ring and records copy to one subresource region of image (region.bufferOffset is ignored).
+	//Image goes from oldLayout to finalLayout, ownership is released like in uploadToBuffer. Uploads larger than half of the ring are
+	//split at array layers or depth slices, VK_ERROR_OUT_OF_DEVICE_MEMORY if a single one doesn't fit in the ring
+	inline VkResult uploadToImage(
+		InitializationStruct& initStruct,
+		UploadRing& uploadRing,
+		VkImage dstImage,
+		const VkBufferImageCopy& region,
+		const void* data,
+		VkDeviceSize size,
+		/*VK_IMAGE_LAYOUT_UNDEFINED discards previous contents*/ VkImageLayout oldLayout,
+		VkImageLayout finalLayout,
+		/*VK_QUEUE_FAMILY_IGNORED if image is concurrent or used on ring's family*/ uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED
+	) CPPONLY(noexcept)
+	{
+		return uploadToImage(&initStruct, &uploadRing, dstImage, &region, data, size, oldLayout, finalLayout, dstQueueFamilyIndex);
+	}
+
+	//Submits recorded copies, timelineValue gets point on uploadRing.timelineQueue they complete at (0 if nothing was pending).
+	//Wait for it with timelinePoint on other queues or waitTimelinePoint on CPU. If vkQueueSubmit fails, copies stay enqueued on
+	//timeline queue and are submitted by its next flush. VK_ERROR_OUT_OF_HOST_MEMORY means they were dropped and have to be uploaded again
+	inline VkResult flushUploads(
+		InitializationStruct& initStruct,
+		UploadRing& uploadRing,
+		/*can be null*/ uint64_t* timelineValue = nullptr
+	) CPPONLY(noexcept)
+	{
+		return flushUploads(&initStruct, &uploadRing, timelineValue);
+	}
+
+	//Flushes, waits for all uploads and destroys ring
+	inline void destroyUploadRing(
+		InitializationStruct& initStruct,
+		UploadRing* uploadRing
+	) CPPONLY(noexcept)
+	{
+		destroyUploadRing(&initStruct, uploadRing);
+	}
+
+	//Creates slotCount buffers of slotSize bytes (width * height * texel size of largest capture). Use framesInFlight + 1 slots or more.
+	//Without callback, results are polled with acquireReadback. NULL on failure
+	inline ReadbackRing* createReadbackRing(
+		InitializationStruct& initStruct,
+		uint32_t slotCount,
+		VkDeviceSize slotSize,
+		/*can be null*/ ReadbackCallback callback = nullptr,
+		void* userData = nullptr
+	) CPPONLY(noexcept)
+	{
+		return createReadbackRing(&initStruct, slotCount, slotSize, callback, userData);
+	}
+
+	//Records copy of image's first mip/layer into next free slot, image is left in imageLayout. Record it after rendering, into the
+	//command buffer of frame frameNumber (FrameContext::frameNumber between beginFrame and endFrame).
+	//VK_NOT_READY if every slot is busy, capture is dropped then instead of waiting. Image in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR is taken
+	//as swapchain image, VK_ERROR_FEATURE_NOT_PRESENT if swapchain wasn't created with transfer source (see withSwapchainReadback)
+	inline VkResult recordImageReadback(
+		InitializationStruct& initStruct,
+		ReadbackRing& readbackRing,
+		VkCommandBuffer commandBuffer,
+		VkImage image,
+		/*ex. VK_IMAGE_LAYOUT_PRESENT_SRC_KHR after render pass*/ VkImageLayout imageLayout,
+		VkFormat format,
+		VkExtent2D extent,
+		uint64_t frameNumber
+	) CPPONLY(noexcept)
+	{
+		return recordImageReadback(&initStruct, &readbackRing, commandBuffer, image, imageLayout, format, extent, frameNumber);
+	}
+
+	//Marks captures of frames up to completedFrameNumber ready and hands them to callback. Never blocks, nor checks any fence, so
+	//completedFrameNumber must really be done. Values with top bit set (ex. frameNumber - framesInFlight wrapped during first frames)
+	//mean no frame is done. Returns number of captures that became ready
+	inline uint32_t pollReadbacks(
+		InitializationStruct& initStruct,
+		ReadbackRing& readbackRing,
+		uint64_t completedFrameNumber
+	) CPPONLY(noexcept)
+	{
+		return pollReadbacks(&initStruct, &readbackRing, completedFrameNumber);
+	}
+
+	//pollReadbacks with frames FrameContext knows are done. Call after beginFrame, which waited for the slot's fence
+	inline uint32_t pollFrameReadbacks(
+		InitializationStruct& initStruct,
+		ReadbackRing& readbackRing,
+		const FrameContext& frameContext
+	) CPPONLY(noexcept)
+	{
+		return pollFrameReadbacks(&initStruct, &readbackRing, &frameContext);
+	}
+
+	//Polling mode, returns oldest ready capture. Slot is reused only after releaseReadback
+	inline bool acquireReadback(
+		ReadbackRing& readbackRing,
+		ReadbackResult& result
+	) CPPONLY(noexcept)
+	{
+		return acquireReadback(&readbackRing, &result);
+	}
+
+	inline void releaseReadback(
+		ReadbackRing& readbackRing,
+		const ReadbackResult& result
+	) CPPONLY(noexcept)
+	{
+		releaseReadback(&readbackRing, &result);
+	}
+
+	//Buffers may still be written by GPU, wait for frames that recorded readbacks first (ex. destroyFrameContext)
+	inline void destroyReadbackRing(
+		InitializationStruct& initStruct,
+		ReadbackRing* readbackRing
+	) CPPONLY(noexcept)
+	{
+		destroyReadbackRing(&initStruct, readbackRing);
+	}
+
+	//ratios can be null, defaults cover common descriptor types. initialSetsPerPool 0 means 64. NULL on failure
+	inline DescriptorAllocator* createDescriptorAllocator(
+		InitializationStruct& initStruct,
+		/*can be null*/ const DescriptorPoolRatio* ratios = nullptr,
+		uint32_t ratioCount = 0,
+		uint32_t initialSetsPerPool = 0
+	) CPPONLY(noexcept)
+	{
+		return createDescriptorAllocator(&initStruct, ratios, ratioCount, initialSetsPerPool);
+	}
+
+	//Allocates from current pool, moves on to a fresh one if it's out of memory or fragmented. Layout that doesn't fit into an empty pool
+	//returns VK_ERROR_OUT_OF_POOL_MEMORY without creating more pools, give it larger ratios or its own allocator
+	inline VkResult allocateDescriptorSet(
+		InitializationStruct& initStruct,
+		DescriptorAllocator& descriptorAllocator,
+		VkDescriptorSetLayout layout,
+		VkDescriptorSet& descriptorSet
+	) CPPONLY(noexcept)
+	{
+		return allocateDescriptorSet(&initStruct, &descriptorAllocator, layout, &descriptorSet);
+	}
+
+	//Frees every set allocated so far, GPU must be done with them (ex. after beginFrame waited for the frame's fence)
+	inline void resetDescriptorAllocator(
+		InitializationStruct& initStruct,
+		DescriptorAllocator& descriptorAllocator
+	) CPPONLY(noexcept)
+	{
+		resetDescriptorAllocator(&initStruct, &descriptorAllocator);
+	}
+
+	inline void destroyDescriptorAllocator(
+		InitializationStruct& initStruct,
+		DescriptorAllocator* descriptorAllocator
+	) CPPONLY(noexcept)
+	{
+		destroyDescriptorAllocator(&initStruct, descriptorAllocator);
+	}
+
+	//NULL on failure
+	inline DescriptorCache* createDescriptorCache(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		return createDescriptorCache(&initStruct);
+	}
+
+	//Returns cached layout for bindings, creates it on first request. Bindings are hashed in given order, including immutable samplers.
+	//Layout is owned by cache, do not destroy it. VK_NULL_HANDLE on failure
+	inline VkDescriptorSetLayout getDescriptorSetLayout(
+		InitializationStruct& initStruct,
+		DescriptorCache& descriptorCache,
+		const VkDescriptorSetLayoutBinding* bindings,
+		uint32_t bindingCount,
+		VkDescriptorSetLayoutCreateFlags flags = 0
+	) CPPONLY(noexcept)
+	{
+		return getDescriptorSetLayout(&initStruct, &descriptorCache, bindings, bindingCount, flags);
+	}
+
+	//Returns set of layout with writes applied, allocated and written only on first request. Sets are keyed by handle values,
+	//so resources (and layout) must outlive the cache, a destroyed handle the driver hands out again would return the stale set.
+	//VK_NULL_HANDLE on failure
+	inline VkDescriptorSet getImmutableDescriptorSet(
+		InitializationStruct& initStruct,
+		DescriptorCache& descriptorCache,
+		VkDescriptorSetLayout layout,
+		const DescriptorWrite* writes,
+		uint32_t writeCount
+	) CPPONLY(noexcept)
+	{
+		return getImmutableDescriptorSet(&initStruct, &descriptorCache, layout, writes, writeCount);
+	}
+
+	//Destroys cached layouts and frees cached sets
+	inline void destroyDescriptorCache(
+		InitializationStruct& initStruct,
+		DescriptorCache* descriptorCache
+	) CPPONLY(noexcept)
+	{
+		destroyDescriptorCache(&initStruct, descriptorCache);
+	}
+
+	//Capacities must not exceed maxDescriptorSetUpdateAfterBind* limits. NULL on failure
+	inline BindlessTable* createBindlessTable(
+		InitializationStruct& initStruct,
+		uint32_t maxSampledImages,
+		uint32_t maxStorageBuffers,
+		uint32_t maxSamplers
+	) CPPONLY(noexcept)
+	{
+		return createBindlessTable(&initStruct, maxSampledImages, maxStorageBuffers, maxSamplers);
+	}
+
+	//Writes image view into table, returns index shaders use or UINT32_MAX if table is full
+	inline uint32_t bindlessAddImage(
+		InitializationStruct& initStruct,
+		BindlessTable& bindlessTable,
+		VkImageView imageView,
+		VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+	) CPPONLY(noexcept)
+	{
+		return bindlessAddImage(&initStruct, &bindlessTable, imageView, imageLayout);
+	}
+
+	//Writes buffer range into table, returns index shaders use or UINT32_MAX if table is full
+	inline uint32_t bindlessAddBuffer(
+		InitializationStruct& initStruct,
+		BindlessTable& bindlessTable,
+		VkBuffer buffer,
+		VkDeviceSize offset = 0,
+		VkDeviceSize range = VK_WHOLE_SIZE
+	) CPPONLY(noexcept)
+	{
+		return bindlessAddBuffer(&initStruct, &bindlessTable, buffer, offset, range);
+	}
+
+	//Writes sampler into table, returns index shaders use or UINT32_MAX if table is full
+	inline uint32_t bindlessAddSampler(
+		InitializationStruct& initStruct,
+		BindlessTable& bindlessTable,
+		VkSampler sampler
+	) CPPONLY(noexcept)
+	{
+		return bindlessAddSampler(&initStruct, &bindlessTable, sampler);
+	}
+
+	//Makes index available again, removing index that is already free is ignored. Submitted work may still read it,
+	//so only remove resources once frames using them finished
+	inline void bindlessRemove(
+		BindlessTable& bindlessTable,
+		BindlessResourceType type,
+		uint32_t index
+	) CPPONLY(noexcept)
+	{
+		bindlessRemove(&bindlessTable, type, index);
+	}
+
+	inline void destroyBindlessTable(
+		InitializationStruct& initStruct,
+		BindlessTable* bindlessTable
+	) CPPONLY(noexcept)
+	{
+		destroyBindlessTable(&initStruct, bindlessTable);
+	}
+
+	//workerCount 0 means one worker per core. NULL on failure
+	inline JobSystem* createJobSystem(
+		uint32_t workerCount = 0
+	) CPPONLY(noexcept)
+	{
+		return ::createJobSystem(workerCount);
+	}
+
+	inline uint32_t getJobWorkerCount(
+		const JobSystem& jobSystem
+	) CPPONLY(noexcept)
+	{
+		return getJobWorkerCount(&jobSystem);
+	}
+
+	//Thread safe, jobs may submit jobs too. false if out of memory, job won't run then
+	inline bool submitJob(
+		JobSystem& jobSystem,
+		JobFunction function,
+		void* userData,
+		/*can be null*/ JobCounter* counter = nullptr
+	) CPPONLY(noexcept)
+	{
+		return submitJob(&jobSystem, function, userData, counter);
+	}
+
+	//Blocks until every job submitted with counter finished. Don't call from inside a job, worker would sleep instead of helping
+	inline void waitJobCounter(
+		JobSystem& jobSystem,
+		JobCounter& counter
+	) CPPONLY(noexcept)
+	{
+		waitJobCounter(&jobSystem, &counter);
+	}
+
+	//Runs jobs still queued, then joins workers
+	inline void destroyJobSystem(
+		JobSystem* jobSystem
+	) CPPONLY(noexcept)
+	{
+		::destroyJobSystem(jobSystem);
+	}
+
+	//Never blocks, true once every job submitted with counter finished. Safe to call from inside a job
+	inline bool pollJobCounter(
+		const JobCounter& counter
+	) CPPONLY(noexcept)
+	{
+		return pollJobCounter(&counter);
+	}
+
+	//createDevice that overlaps with disk and worker threads. Pipeline cache file (withPipelineCache) and shaders are read on
+	//jobSystem while vkCreateDevice runs on calling thread, returns once device is ready with pipeline cache and shader modules
+	//still being created on workers. Create swapchain and present first frames meanwhile, just don't use pipelineCache or
+	//shaders (nor savePipelineCache/destroyDevice) before pollAsyncInit is true or finishAsyncInit returned.
+	//shaders have to stay alive until then. NULL if out of memory, nothing was started then
+	inline AsyncInit* beginAsyncInit(
+		InitializationStruct& initStruct,
+		JobSystem& jobSystem,
+		/*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount),
+		const char* const* deviceExtensions,
+		uint32_t deviceExtensionCount,
+		/*can be null*/ AsyncShaderRequest* shaders,
+		uint32_t shaderCount
+	) CPPONLY(noexcept)
+	{
+		return beginAsyncInit(&initStruct, &jobSystem, deviceDesigner, deviceExtensions, deviceExtensionCount, shaders, shaderCount);
+	}
+
+	//Never blocks, true once pipeline cache and every shader of beginAsyncInit are done. Poll once per frame
+	inline bool pollAsyncInit(
+		const AsyncInit& asyncInit
+	) CPPONLY(noexcept)
+	{
+		return pollAsyncInit(&asyncInit);
+	}
+
+	//Waits for what's left and frees asyncInit. VK_SUCCESS if device, pipeline cache and every shader were created
+	inline VkResult finishAsyncInit(
+		AsyncInit* asyncInit
+	) CPPONLY(noexcept)
+	{
+		return ::finishAsyncInit(asyncInit);
+	}
+
+	//Creates pools on graphics family of default createDevice path, one set per frame slot of frameContext. NULL on failure or
+	//if device wasn't created by default path
+	inline ParallelRecorder* createParallelRecorder(
+		InitializationStruct& initStruct,
+		JobSystem& jobSystem,
+		const FrameContext& frameContext
+	) CPPONLY(noexcept)
+	{
+		return createParallelRecorder(&initStruct, &jobSystem, &frameContext);
+	}
+
+	//Call between beginFrame and endFrame. Splits work into chunkCount jobs each recording a secondary, waits for them and executes
+	//secondaries in primaryCommandBuffer in chunk order. With inheritanceInfo->renderPass set, begin render pass with
+	//VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS first. First call in a frame resets that frame slot's pools
+	inline VkResult recordParallel(
+		InitializationStruct& initStruct,
+		ParallelRecorder& recorder,
+		const FrameContext& frameContext,
+		VkCommandBuffer primaryCommandBuffer,
+		/*can be null*/ const VkCommandBufferInheritanceInfo* inheritanceInfo,
+		uint32_t chunkCount,
+		RecordFunction function,
+		void* userData
+	) CPPONLY(noexcept)
+	{
+		return recordParallel(&initStruct, &recorder, &frameContext, primaryCommandBuffer, inheritanceInfo, chunkCount, function, userData);
+	}
+
+	//GPU must be done with every frame, ex. vkDeviceWaitIdle first
+	inline void destroyParallelRecorder(
+		InitializationStruct& initStruct,
+		ParallelRecorder* recorder
+	) CPPONLY(noexcept)
+	{
+		destroyParallelRecorder(&initStruct, recorder);
+	}
+
+	//NULL on failure
+	inline PipelineCompiler* createPipelineCompiler(
+		InitializationStruct& initStruct,
+		JobSystem& jobSystem
+	) CPPONLY(noexcept)
+	{
+		return createPipelineCompiler(&initStruct, &jobSystem);
+	}
+
+	//Queues pipeline, or returns handle of identical earlier request. Never blocks on compilation.
+	//createInfo and everything it points to has to stay alive until pipeline is done (pollPipeline isn't VK_NOT_READY)
+	inline PipelineHandle compileGraphicsPipeline(
+		PipelineCompiler& compiler,
+		const VkGraphicsPipelineCreateInfo& createInfo,
+		PipelinePriority priority
+	) CPPONLY(noexcept)
+	{
+		return compileGraphicsPipeline(&compiler, &createInfo, priority);
+	}
+
+	//Same as compileGraphicsPipeline
+	inline PipelineHandle compileComputePipeline(
+		PipelineCompiler& compiler,
+		const VkComputePipelineCreateInfo& createInfo,
+		PipelinePriority priority
+	) CPPONLY(noexcept)
+	{
+		return compileComputePipeline(&compiler, &createInfo, priority);
+	}
+
+	//Never blocks. VK_NOT_READY while queued or compiling, otherwise result of creation with pipeline written
+	inline VkResult pollPipeline(
+		PipelineCompiler& compiler,
+		PipelineHandle handle,
+		VkPipeline& pipeline
+	) CPPONLY(noexcept)
+	{
+		return pollPipeline(&compiler, handle, &pipeline);
+	}
+
+	//Compiles pipeline on calling thread if no worker started it yet, otherwise waits for the worker. Don't call from inside a job
+	inline VkResult waitPipeline(
+		PipelineCompiler& compiler,
+		PipelineHandle handle,
+		VkPipeline& pipeline
+	) CPPONLY(noexcept)
+	{
+		return waitPipeline(&compiler, handle, &pipeline);
+	}
+
+	//Blocks until nothing is queued or compiling, ex. before savePipelineCache. Don't call from inside a job
+	inline void waitPipelineCompiler(
+		PipelineCompiler& compiler
+	) CPPONLY(noexcept)
+	{
+		waitPipelineCompiler(&compiler);
+	}
+
+	inline void getPipelineCompilerStats(
+		PipelineCompiler& compiler,
+		PipelineCompilerStats& stats
+	) CPPONLY(noexcept)
+	{
+		getPipelineCompilerStats(&compiler, &stats);
+	}
+
+	//Waits for queued pipelines, then destroys every pipeline compiler created. GPU must be done with them
+	inline void destroyPipelineCompiler(
+		InitializationStruct& initStruct,
+		PipelineCompiler* compiler
+	) CPPONLY(noexcept)
+	{
+		destroyPipelineCompiler(&initStruct, compiler);
+	}
+
+	//Packs SPIR-V blobs into one file for openShaderArchive, identical blobs are stored once. Meant for build step.
+	//VK_ERROR_INITIALIZATION_FAILED if a blob isn't SPIR-V, a name repeats or file can't be written
+	inline VkResult writeShaderArchive(
+		const char* path,
+		const ShaderArchiveSource* sources,
+		uint32_t sourceCount
+	) CPPONLY(noexcept)
+	{
+		return ::writeShaderArchive(path, sources, sourceCount);
 	}
 
-	//Adds instance extension, for device extensions see createDevice
-	inline InitializationStruct& addExtension(
+	//Maps archive and validates its index (bounds, 4 byte alignment of every blob), code itself isn't read yet.
+	//NULL if file is missing, corrupt or out of memory
+	inline ShaderArchive* openShaderArchive(
 		InitializationStruct& initStruct,
-		const char* extensionName
+		const char* path
 	) CPPONLY(noexcept)
 	{
-		return *(addExtension(&initStruct, extensionName));
+		return openShaderArchive(&initStruct, path);
 	}
 
-	//Starts a vulkan instance with extensions provided using addExtension
-	inline InitializationStruct& startInstance(
-		InitializationStruct& initStruct
+	//Creates module on first request of name (or of another name with identical code), later requests return the same one.
+	//Module is owned by archive. VK_NULL_HANDLE if name isn't in archive, blob isn't valid SPIR-V or creation failed
+	inline VkShaderModule getShaderModule(
+		InitializationStruct& initStruct,
+		ShaderArchive& shaderArchive,
+		const char* name
 	) CPPONLY(noexcept)
 	{
-		return *startInstance(&initStruct);
+		return getShaderModule(&initStruct, &shaderArchive, name);
 	}
 
-	//Terminates vulkan instance, aswell as cleans up instance extension objects created using vkCmdInit
-	inline void terminateInstance(
-		InitializationStruct& initStruct
+	//Code of name straight from the mapping (ex. for reflection), valid until closeShaderArchive. NULL if name isn't in archive
+	inline const uint32_t* getShaderCode(
+		const ShaderArchive& shaderArchive,
+		const char* name,
+		/*can be null*/ size_t* codeSize
 	) CPPONLY(noexcept)
 	{
-		return terminateInstance(&initStruct);
+		return getShaderCode(&shaderArchive, name, codeSize);
 	}
 
-	//Enumerates and selects a suitable physical device, provide deviceEnumerator for custom selection rules
-	inline InitializationStruct& selectPhysicalDevices(
+	inline void getShaderArchiveStats(
+		const ShaderArchive& shaderArchive,
+		ShaderArchiveStats& stats
+	) CPPONLY(noexcept)
+	{
+		getShaderArchiveStats(&shaderArchive, &stats);
+	}
+
+	//Unmaps archive and destroys modules it created, pipelines created from them stay valid
+	inline void closeShaderArchive(
 		InitializationStruct& initStruct,
-		/*can be NULL. If so, selects first device available*/ VkPhysicalDevice(*deviceEnumerator)(const VkPhysicalDevice* const devices,
-			size_t deviceCount, /*ex. required device extensions*/ void* additionalData) = nullptr,
-		/*if device enumerator is null, can be null, because default implementation ignores it*/ void* additionalData = nullptr
+		ShaderArchive* shaderArchive
 	) CPPONLY(noexcept)
 	{
-		return *selectPhysicalDevices(&initStruct, deviceEnumerator, additionalData);
+		closeShaderArchive(&initStruct, shaderArchive);
 	}
 
-	//Creates logical device with extensions provided
-	inline InitializationStruct& createDevice(
+	//Uses graphics family of default createDevice path. traceCapacity 0 disables trace export. NULL on failure, if family
+	//doesn't support timestamps or if device wasn't created by default path
+	inline GpuProfiler* createGpuProfiler(
 		InitializationStruct& initStruct,
-		/*can be NULL. If so, selects first device available, returns data that will be saved in queueIndices*/ void* (*deviceDesigner)(VkPhysicalDevice physicalDevice, VkDeviceCreateInfo* deviceCreateInfo, const char* const* deviceExtensions, uint32_t deviceExtensionCount),
-		const char* const* deviceExtensions,
-		uint32_t deviceExtensionCount
+		/*same as FrameContext*/ uint32_t framesInFlight,
+		uint32_t maxScopesPerFrame = 256,
+		uint32_t traceCapacity = 0
 	) CPPONLY(noexcept)
 	{
-		return *createDevice(&initStruct, deviceDesigner, deviceExtensions, deviceExtensionCount);
+		return createGpuProfiler(&initStruct, framesInFlight, maxScopesPerFrame, traceCapacity);
 	}
 
-	//retrieves queues from physical device object, if deviceDesigner in createDevice call wasn't NULL, provide custom queueRetriever function
-	inline void retrieveQueues(
+	//Resets frame slot's queries in commandBuffer, call first thing after beginFrame (with FrameContext::frameNumber)
+	inline void beginGpuProfilerFrame(
 		InitializationStruct& initStruct,
-		/*if queueRetriever isn't custom, should be array of a graphics queue and a presentation queue (non-initialized if VkSurfaceKHR isn't present)*/ VkQueue* queues,
-		uint32_t** familyIndices,
-		/*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices) = nullptr
+		GpuProfiler& profiler,
+		VkCommandBuffer commandBuffer,
+		uint64_t frameNumber
 	) CPPONLY(noexcept)
 	{
-		::retrieveQueues(&initStruct,queues,familyIndices, queueRetriever);
+		beginGpuProfilerFrame(&initStruct, &profiler, commandBuffer, frameNumber);
 	}
 
+	//Scopes nest, every beginGpuScope needs an endGpuScope in the same frame
+	inline void beginGpuScope(
+		InitializationStruct& initStruct,
+		GpuProfiler& profiler,
+		VkCommandBuffer commandBuffer,
+		/*has to outlive the profiler*/ const char* name
+	) CPPONLY(noexcept)
+	{
+		beginGpuScope(&initStruct, &profiler, commandBuffer, name);
+	}
 
-	//retrieves queues from physical device object, if deviceDesigner in createDevice call wasn't NULL, provide custom queueRetriever function
-	inline void retrieveQueues(
+	inline void endGpuScope(
 		InitializationStruct& initStruct,
-		/*if queueRetriever isn't custom, should be array of a graphics queue and a presentation queue (non-initialized if VkSurfaceKHR isn't present)*/ DefaultQueueRetrieveStruct& queues,
-		uint32_t** familyIndices,
-		/*can be null if createDevice was called with deviceDesigner = null, otherwise you need to supply own retriewer*/ void(*queueRetriever)(void* queueIndices, VkDevice device, VkQueue* queues, uint32_t** familyIndices) = nullptr
+		GpuProfiler& profiler,
+		VkCommandBuffer commandBuffer
 	) CPPONLY(noexcept)
 	{
-		::retrieveQueues(&initStruct,(VkQueue*)&queues, familyIndices, queueRetriever);
+		endGpuScope(&initStruct, &profiler, commandBuffer);
 	}
-	//Creates debug messenger, for simpler calls see withDebugOutput1 and withDebugOutput2
-	inline InitializationStruct& withDebugOutput(
+
+	//Call before endFrame, scopes still open are dropped
+	inline void endGpuProfilerFrame(
+		GpuProfiler& profiler
+	) CPPONLY(noexcept)
+	{
+		endGpuProfilerFrame(&profiler);
+	}
+
+	//Reads results of ended frames up to completedFrameNumber and updates scope stats. Never blocks, frames whose results aren't
+	//available yet are retried next call. With FrameContext call it after beginFrame with frameNumber - framesInFlight.
+	//Returns number of frames resolved
+	inline uint32_t resolveGpuProfiler(
 		InitializationStruct& initStruct,
-		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
-		void* userData,
-		VkDebugUtilsMessageSeverityFlagsEXT messageSeverity,
-		VkDebugUtilsMessageTypeFlagsEXT messageType
+		GpuProfiler& profiler,
+		uint64_t completedFrameNumber
 	) CPPONLY(noexcept)
 	{
-		return *withDebugOutput(&initStruct, debugOutputProc, userData, messageSeverity, messageType);
+		return resolveGpuProfiler(&initStruct, &profiler, completedFrameNumber);
 	}
 
-	//Creates debug messenger with default settings and pointer to user data, for call without userData see withDebugOutput2
-	inline InitializationStruct& withDebugOutput(
+	//Writes resolved scopes still in trace ring as Chrome trace event JSON
+	inline VkResult exportGpuProfilerTrace(
+		const GpuProfiler& profiler,
+		const char* path
+	) CPPONLY(noexcept)
+	{
+		return exportGpuProfilerTrace(&profiler, path);
+	}
+
+	//Query pools may still be written by GPU, wait for frames first (ex. destroyFrameContext)
+	inline void destroyGpuProfiler(
 		InitializationStruct& initStruct,
-		PFN_vkDebugUtilsMessengerCallbackEXT debugOutputProc,
-		void* userData = nullptr
+		GpuProfiler* profiler
 	) CPPONLY(noexcept)
 	{
-		return *withDebugOutput1(&initStruct, debugOutputProc, userData);
+		destroyGpuProfiler(&initStruct, profiler);
 	}
 
+	//Names fixed at compile time, build with nameList(VK_KHR_SWAPCHAIN_EXTENSION_NAME, ...). Storage is inline, no heap
+	template<uint32_t N>
+	struct NameList
+	{
+		const char* names[N ? N : 1];
 
+		constexpr uint32_t size() const CPPONLY(noexcept) { return N; }
+		constexpr const char* const* data() const CPPONLY(noexcept) { return N ? names : nullptr; }
+	};
 
-#ifdef VKCMDINIT_GLFW
-	//Creates window surface using GLFWwindow (platform-independent)
-	inline InitializationStruct& withSurfaceGLFW(
-		InitializationStruct& initStruct,
-		GLFWwindow* window
+	template<typename... Names>
+	constexpr NameList<sizeof...(Names)> nameList(
+		Names... names
 	) CPPONLY(noexcept)
 	{
-		return *(withSurfaceGLFW(&initStruct, window));
+		return NameList<sizeof...(Names)>{ { names... } };
 	}
-#endif
 
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-	//Creates window surface for Win32 platform-dependent window
-	inline InitializationStruct& withSurfaceWin32(
-		InitializationStruct& initStruct,
-		HINSTANCE processHandle,
-		HWND windowHandle
+	//Feature structs of compile-time configuration, sType and pNext don't have to be set
+	struct FeatureSet
+	{
+		VkPhysicalDeviceFeatures features;
+		VkPhysicalDeviceVulkan11Features features11;
+		VkPhysicalDeviceVulkan12Features features12;
+		VkPhysicalDeviceVulkan13Features features13;
+	};
+
+	//Queues default createDevice path requests per role (see withQueueCount), every queue gets priority 1.0
+	struct QueueLayout
+	{
+		uint32_t graphicsQueueCount;
+		uint32_t computeQueueCount;
+		uint32_t transferQueueCount;
+	};
+
+	//Compile-time configuration, derive and hide what differs. Checked with static_assert where it's first used, lists and
+	//feature request live in static storage and selectors are called directly, not through pointers:
+	//struct EngineConfig : vki::StaticConfig
+	//{
+	//	static constexpr uint32_t apiVersion = VK_API_VERSION_1_3;
+	//	static constexpr auto deviceExtensions() noexcept { return vki::nameList(VK_KHR_SWAPCHAIN_EXTENSION_NAME); }
+	//	static constexpr vki::FeatureSet optionalFeatures() noexcept { vki::FeatureSet set{}; set.features13.dynamicRendering = VK_TRUE; return set; }
+	//};
+	struct StaticConfig
+	{
+		static constexpr uint32_t apiVersion = VK_API_VERSION_1_0;
+
+		//Required/optional pairs, see FeatureRequest
+		static constexpr NameList<0> instanceLayers() CPPONLY(noexcept) { return {}; }
+		static constexpr NameList<0> optionalInstanceLayers() CPPONLY(noexcept) { return {}; }
+		static constexpr NameList<0> instanceExtensions() CPPONLY(noexcept) { return {}; }
+		static constexpr NameList<0> optionalInstanceExtensions() CPPONLY(noexcept) { return {}; }
+		static constexpr NameList<0> deviceExtensions() CPPONLY(noexcept) { return {}; }
+		static constexpr NameList<0> optionalDeviceExtensions() CPPONLY(noexcept) { return {}; }
+		static constexpr FeatureSet requiredFeatures() CPPONLY(noexcept) { return {}; }
+		static constexpr FeatureSet optionalFeatures() CPPONLY(noexcept) { return {}; }
+
+		static constexpr QueueLayout queueLayout() CPPONLY(noexcept) { return { 1, 1, 1 }; }
+
+		//requiredExtensions left null are filled with deviceExtensions
+		static DeviceSelectionPolicy deviceSelectionPolicy() CPPONLY(noexcept) { return ::defaultDeviceSelectionPolicy(); }
+
+		//Called directly by createSwapchainKHR<Config>, hide them to pick something else
+		static VkSurfaceFormatKHR surfaceFormatSelector(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount) CPPONLY(noexcept) { return ::selectDefaultSurfaceFormat(surfaceFormats, surfaceFormatCount); }
+		static VkPresentModeKHR presentModeSelector(VkPresentModeKHR* presentModes, size_t presentModeCount) CPPONLY(noexcept) { return ::selectDefaultPresentMode(presentModes, presentModeCount); }
+	};
+
+	constexpr bool vkCmdInitSameName(const char* name0, const char* name1) CPPONLY(noexcept)
+	{
+		while (*name0 && *name0 == *name1)
+		{
+			++name0;
+			++name1;
+		}
+		return *name0 == *name1;
+	}
+
+	//No null and no name twice
+	template<uint32_t N>
+	constexpr bool vkCmdInitValidNames(const NameList<N>& list) CPPONLY(noexcept)
+	{
+		for (uint32_t i = 0; i < list.size(); ++i)
+		{
+			if (!list.names[i])
+				return false;
+			for (uint32_t j = 0; j < i; ++j)
+			{
+				if (vkCmdInitSameName(list.names[i], list.names[j]))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	template<uint32_t N, uint32_t M>
+	constexpr bool vkCmdInitDisjointNames(const NameList<N>& required, const NameList<M>& optional) CPPONLY(noexcept)
+	{
+		for (uint32_t i = 0; i < required.size(); ++i)
+		{
+			for (uint32_t j = 0; j < optional.size(); ++j)
+			{
+				if (required.names[i] && optional.names[j] && vkCmdInitSameName(required.names[i], optional.names[j]))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool vkCmdInitValidQueueCount(uint32_t queueCount) CPPONLY(noexcept)
+	{
+		return queueCount >= 1 && queueCount <= VKCMDINIT_MAX_QUEUES_PER_FAMILY;
+	}
+
+	//Built once per Config, lists it points at are function statics next to it so request stays valid for whole program
+	template<typename Config>
+	inline const FeatureRequest& vkCmdInitStaticFeatureRequest() CPPONLY(noexcept)
+	{
+		static_assert(Config::apiVersion >= VK_API_VERSION_1_0, "apiVersion has to be at least VK_API_VERSION_1_0");
+		static_assert(vkCmdInitValidNames(Config::instanceLayers()) && vkCmdInitValidNames(Config::optionalInstanceLayers()) &&
+			vkCmdInitValidNames(Config::instanceExtensions()) && vkCmdInitValidNames(Config::optionalInstanceExtensions()) &&
+			vkCmdInitValidNames(Config::deviceExtensions()) && vkCmdInitValidNames(Config::optionalDeviceExtensions()),
+			"name lists can't contain null or same name twice");
+		static_assert(vkCmdInitDisjointNames(Config::instanceLayers(), Config::optionalInstanceLayers()) &&
+			vkCmdInitDisjointNames(Config::instanceExtensions(), Config::optionalInstanceExtensions()) &&
+			vkCmdInitDisjointNames(Config::deviceExtensions(), Config::optionalDeviceExtensions()),
+			"name can't be both required and optional");
+		static_assert(vkCmdInitValidQueueCount(Config::queueLayout().graphicsQueueCount) && vkCmdInitValidQueueCount(Config::queueLayout().computeQueueCount) &&
+			vkCmdInitValidQueueCount(Config::queueLayout().transferQueueCount),
+			"queue counts have to be between 1 and VKCMDINIT_MAX_QUEUES_PER_FAMILY");
+
+		static const auto instanceLayers = Config::instanceLayers();
+		static const auto optionalInstanceLayers = Config::optionalInstanceLayers();
+		static const auto instanceExtensions = Config::instanceExtensions();
+		static const auto optionalInstanceExtensions = Config::optionalInstanceExtensions();
+		static const auto deviceExtensions = Config::deviceExtensions();
+		static const auto optionalDeviceExtensions = Config::optionalDeviceExtensions();
+
+		struct Builder
+		{
+			static FeatureRequest build() CPPONLY(noexcept)
+			{
+				constexpr FeatureSet required = Config::requiredFeatures();
+				constexpr FeatureSet optional = Config::optionalFeatures();
+
+				FeatureRequest request = { ZERO };
+				request.requiredInstanceLayers = instanceLayers.data();
+				request.requiredInstanceLayerCount = instanceLayers.size();
+				request.optionalInstanceLayers = optionalInstanceLayers.data();
+				request.optionalInstanceLayerCount = optionalInstanceLayers.size();
+				request.requiredInstanceExtensions = instanceExtensions.data();
+				request.requiredInstanceExtensionCount = instanceExtensions.size();
+				request.optionalInstanceExtensions = optionalInstanceExtensions.data();
+				request.optionalInstanceExtensionCount = optionalInstanceExtensions.size();
+				request.requiredDeviceExtensions = deviceExtensions.data();
+				request.requiredDeviceExtensionCount = deviceExtensions.size();
+				request.optionalDeviceExtensions = optionalDeviceExtensions.data();
+				request.optionalDeviceExtensionCount = optionalDeviceExtensions.size();
+
+				request.requiredFeatures = required.features;
+				request.optionalFeatures = optional.features;
+				request.requiredFeatures11 = required.features11;
+				request.optionalFeatures11 = optional.features11;
+				request.requiredFeatures12 = required.features12;
+				request.optionalFeatures12 = optional.features12;
+				request.requiredFeatures13 = required.features13;
+				request.optionalFeatures13 = optional.features13;
+				request.requiredFeatures11.sType = request.optionalFeatures11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+				request.requiredFeatures12.sType = request.optionalFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+				request.requiredFeatures13.sType = request.optionalFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+				request.requiredFeatures11.pNext = request.optionalFeatures11.pNext = nullptr;
+				request.requiredFeatures12.pNext = request.optionalFeatures12.pNext = nullptr;
+				request.requiredFeatures13.pNext = request.optionalFeatures13.pNext = nullptr;
+				return request;
+			}
+		};
+
+		static const FeatureRequest request = Builder::build();
+		return request;
+	}
+
+	//createApplication with Config's apiVersion, feature request (see withFeatureRequest) and queue layout already applied
+	template<typename Config>
+	inline InitializationStruct createApplication(
+		const char* engineName,
+		const char* applicationName,
+		uint32_t applicationVersion,
+		uint32_t engineVersion
 	) CPPONLY(noexcept)
 	{
-		return *(withSurfaceWin32(&initStruct, processHandle, windowHandle));
+		constexpr QueueLayout queueLayout = Config::queueLayout();
+		InitializationStruct initStruct = ::createApplication(engineName, applicationName, applicationVersion, engineVersion, Config::apiVersion);
+		::withFeatureRequest(&initStruct, &vkCmdInitStaticFeatureRequest<Config>());
+		::withQueueCount(&initStruct, QUEUE_ROLE_GRAPHICS, queueLayout.graphicsQueueCount, nullptr);
+		::withQueueCount(&initStruct, QUEUE_ROLE_COMPUTE, queueLayout.computeQueueCount, nullptr);
+		::withQueueCount(&initStruct, QUEUE_ROLE_TRANSFER, queueLayout.transferQueueCount, nullptr);
+		return initStruct;
+	}
 
+	//Selects highest scored device under Config::deviceSelectionPolicy, devices missing Config::deviceExtensions are never selected
+	template<typename Config>
+	inline InitializationStruct& selectPhysicalDevices(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		const FeatureRequest& request = vkCmdInitStaticFeatureRequest<Config>();
+		DeviceSelectionPolicy policy = Config::deviceSelectionPolicy();
+		if (!policy.requiredExtensions)
+		{
+			policy.requiredExtensions = request.requiredDeviceExtensions;
+			policy.requiredExtensionCount = request.requiredDeviceExtensionCount;
+		}
+		return *::selectPhysicalDevices(&initStruct, nullptr, &policy);
 	}
-#endif
-	//Creates generic swapchain and retrieves images and image views from it
+
+	//Default createDevice path with extensions and features negotiated from Config, see initStruct.featureGrant
+	template<typename Config>
+	inline InitializationStruct& createDevice(
+		InitializationStruct& initStruct
+	) CPPONLY(noexcept)
+	{
+		::withFeatureRequest(&initStruct, &vkCmdInitStaticFeatureRequest<Config>());
+		return *::createDevice(&initStruct, nullptr, nullptr, 0);
+	}
+
+	//createSwapchainKHR with Config's selectors. Surface formats and present modes are enumerated here, so selectors are
+	//called directly and can inline
+	template<typename Config>
 	inline VkSwapchainKHR createSwapchainKHR(
 		InitializationStruct& initStruct,
-		/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount),
-		/*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount),
 		/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
 		uint32_t& swapchainImageCount,
 		VkImage*& swapchainImages,
 		/*can be null*/ VkImageView*& swapchainImageViews
 	) CPPONLY(noexcept)
 	{
-		return createSwapchainKHR(&initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
+		if (!(initStruct.instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE))
+			return VK_NULL_HANDLE;
+
+		uint32_t surfaceFormatCount = 0;
+		uint32_t presentModeCount = 0;
+		initStruct.instanceTable.vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct.physicalDevice, initStruct.surface, &surfaceFormatCount, nullptr);
+		initStruct.instanceTable.vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct.physicalDevice, initStruct.surface, &presentModeCount, nullptr);
+		if (surfaceFormatCount == 0 || presentModeCount == 0)
+			return VK_NULL_HANDLE;
+
+		ScratchMark scratch = ::scratchMark(&initStruct);
+		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)::scratchAllocate(&initStruct, surfaceFormatCount * sizeof(VkSurfaceFormatKHR));
+		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)::scratchAllocate(&initStruct, presentModeCount * sizeof(VkPresentModeKHR));
+		if (surfaceFormats)
+			initStruct.instanceTable.vkGetPhysicalDeviceSurfaceFormatsKHR(initStruct.physicalDevice, initStruct.surface, &surfaceFormatCount, surfaceFormats);
+		if (presentModes)
+			initStruct.instanceTable.vkGetPhysicalDeviceSurfacePresentModesKHR(initStruct.physicalDevice, initStruct.surface, &presentModeCount, presentModes);
+		if (!surfaceFormats || !presentModes || surfaceFormatCount == 0 || presentModeCount == 0)
+		{
+			::scratchRewind(&initStruct, scratch);
+			return VK_NULL_HANDLE;
+		}
+
+		VkSurfaceFormatKHR surfaceFormat = Config::surfaceFormatSelector(surfaceFormats, surfaceFormatCount);
+		VkPresentModeKHR presentMode = Config::presentModeSelector(presentModes, presentModeCount);
+		::scratchRewind(&initStruct, scratch);
+		return ::createSwapchainKHRWithFormat(&initStruct, surfaceFormat, presentMode, surfaceDesigner, &swapchainImageCount, &swapchainImages, &swapchainImageViews);
 	}
 
+#ifdef VKCMDINIT_CPP20
+	//Owning handles, C++20 only. Declare them as Instance, Surface, Device, Swapchain and they are destroyed in reverse,
+	//which is the order Vulkan needs. Move-only, none of them allocates
+
+	//Owns InitializationStruct, terminateInstance runs in destructor. Surface, Device and Swapchain keep pointer to it,
+	//so don't move it while they are alive
+	class Instance
+	{
+	public:
+		Instance() CPPONLY(noexcept) = default;
+
+		//Takes over initStruct of createApplication (and its with* calls) and starts instance
+		explicit Instance(const InitializationStruct& initStruct) CPPONLY(noexcept)
+			: initStruct(initStruct), owning(true)
+		{
+			::startInstance(&this->initStruct);
+		}
+
+		Instance(Instance&& other) CPPONLY(noexcept)
+			: initStruct(other.initStruct), owning(std::exchange(other.owning, false))
+		{
+		}
+
+		Instance& operator=(Instance&& other) CPPONLY(noexcept)
+		{
+			if (this != &other)
+			{
+				reset();
+				initStruct = other.initStruct;
+				owning = std::exchange(other.owning, false);
+			}
+			return *this;
+		}
+
+		Instance(const Instance&) = delete;
+		Instance& operator=(const Instance&) = delete;
+
+		~Instance()
+		{
+			reset();
+		}
+
+		void reset() CPPONLY(noexcept)
+		{
+			if (owning)
+				::terminateInstance(&initStruct);
+			owning = false;
+		}
+
+		//Lets Instance be passed to every vki function taking InitializationStruct&
+		operator InitializationStruct&() CPPONLY(noexcept) { return initStruct; }
+		InitializationStruct& get() CPPONLY(noexcept) { return initStruct; }
+		VkInstance handle() const CPPONLY(noexcept) { return initStruct.instance; }
+		explicit operator bool() const CPPONLY(noexcept) { return owning && initStruct.instance != VK_NULL_HANDLE; }
+
+	private:
+		InitializationStruct initStruct{};
+		bool owning = false;
+	};
+
+	//Owns surface of withSurface* call, destroyed with destroySurface
+	class Surface
+	{
+	public:
+		Surface() CPPONLY(noexcept) = default;
+
+		explicit Surface(InitializationStruct& initStruct) CPPONLY(noexcept)
+			: initStruct((initStruct.instanceOptionalFlags & INSTANCE_OPTIONAL_FLAGS_SURFACE) ? &initStruct : nullptr)
+		{
+		}
+
+		Surface(Surface&& other) CPPONLY(noexcept)
+			: initStruct(std::exchange(other.initStruct, nullptr))
+		{
+		}
+
+		Surface& operator=(Surface&& other) CPPONLY(noexcept)
+		{
+			if (this != &other)
+			{
+				reset();
+				initStruct = std::exchange(other.initStruct, nullptr);
+			}
+			return *this;
+		}
+
+		Surface(const Surface&) = delete;
+		Surface& operator=(const Surface&) = delete;
+
+		~Surface()
+		{
+			reset();
+		}
+
+		void reset() CPPONLY(noexcept)
+		{
+			if (initStruct)
+				::destroySurface(initStruct);
+			initStruct = nullptr;
+		}
+
+		VkSurfaceKHR handle() const CPPONLY(noexcept) { return initStruct ? initStruct->surface : VK_NULL_HANDLE; }
+		explicit operator bool() const CPPONLY(noexcept) { return handle() != VK_NULL_HANDLE; }
+
+	private:
+		InitializationStruct* initStruct = nullptr;
+	};
+
+	//Owns device of default createDevice path, destroyed with destroyDevice
+	class Device
+	{
+	public:
+		Device() CPPONLY(noexcept) = default;
+
+		//Call selectPhysicalDevices first, extensions are required ones (see withFeatureRequest for the rest)
+		explicit Device(InitializationStruct& initStruct, std::span<const char* const> deviceExtensions = {}) CPPONLY(noexcept)
+			: initStruct(&initStruct)
+		{
+			::createDevice(&initStruct, nullptr, deviceExtensions.data(), (uint32_t)deviceExtensions.size());
+		}
+
+		Device(Device&& other) CPPONLY(noexcept)
+			: initStruct(std::exchange(other.initStruct, nullptr))
+		{
+		}
+
+		Device& operator=(Device&& other) CPPONLY(noexcept)
+		{
+			if (this != &other)
+			{
+				reset();
+				initStruct = std::exchange(other.initStruct, nullptr);
+			}
+			return *this;
+		}
+
+		Device(const Device&) = delete;
+		Device& operator=(const Device&) = delete;
+
+		~Device()
+		{
+			reset();
+		}
+
+		void reset() CPPONLY(noexcept)
+		{
+			if (initStruct)
+				::destroyDevice(initStruct);
+			initStruct = nullptr;
+		}
+
+		//See retrieveQueue
+		VkQueue queue(QueueRole role, uint32_t queueIndex = 0) const CPPONLY(noexcept) { return initStruct ? ::retrieveQueue(initStruct, role, queueIndex) : VK_NULL_HANDLE; }
+		VkDevice handle() const CPPONLY(noexcept) { return initStruct ? initStruct->device : VK_NULL_HANDLE; }
+		explicit operator bool() const CPPONLY(noexcept) { return handle() != VK_NULL_HANDLE; }
+
+	private:
+		InitializationStruct* initStruct = nullptr;
+	};
+
+	//Owns swapchain and its image views, images and views live inline (VKCMDINIT_MAX_SWAPCHAIN_IMAGES), so neither creation
+	//nor recreate allocates
+	class Swapchain
+	{
+	public:
+		Swapchain() CPPONLY(noexcept) = default;
+
+		//See createSwapchainKHR, swapchain with more images than VKCMDINIT_MAX_SWAPCHAIN_IMAGES fails
+		Swapchain(
+			InitializationStruct& initStruct,
+			/*cannot be null*/ void(*surfaceDesigner)(const VkSurfaceCapabilitiesKHR* capabilities, VkExtent2D* extent, uint32_t* imageCount),
+			/*can be null, if so, uses default selector*/ VkSurfaceFormatKHR(*surfaceFormatSelector)(VkSurfaceFormatKHR* surfaceFormats, size_t surfaceFormatCount) = nullptr,
+			/*can be null, if so, uses default selector*/ VkPresentModeKHR(*presentModeSelector)(VkPresentModeKHR* presentModes, size_t presentModeCount) = nullptr
+		) CPPONLY(noexcept)
+			: initStruct(&initStruct)
+		{
+			swapchain = ::createSwapchainKHRInPlace(&initStruct, surfaceFormatSelector, presentModeSelector, surfaceDesigner, VKCMDINIT_MAX_SWAPCHAIN_IMAGES, &imageCount, swapchainImages, swapchainImageViews);
+		}
+
+		Swapchain(Swapchain&& other) CPPONLY(noexcept)
+		{
+			take(other);
+		}
+
+		Swapchain& operator=(Swapchain&& other) CPPONLY(noexcept)
+		{
+			if (this != &other)
+			{
+				reset();
+				take(other);
+			}
+			return *this;
+		}
+
+		Swapchain(const Swapchain&) = delete;
+		Swapchain& operator=(const Swapchain&) = delete;
+
+		~Swapchain()
+		{
+			reset();
+		}
+
+		//Destroys right away, GPU must be done with it (ex. after vkDeviceWaitIdle). Retired ones go with collectRetiredSwapchains
+		void reset() CPPONLY(noexcept)
+		{
+			if (initStruct && swapchain)
+			{
+				for (uint32_t i = 0; i < imageCount; ++i)
+					initStruct->deviceTable.vkDestroyImageView(initStruct->device, swapchainImageViews[i], initStruct->allocationCallbacks);
+				initStruct->deviceTable.vkDestroySwapchainKHR(initStruct->device, swapchain, initStruct->allocationCallbacks);
+			}
+			initStruct = nullptr;
+			swapchain = VK_NULL_HANDLE;
+			imageCount = 0;
+		}
+
+		//See recreateSwapchainKHR. False if window is minimized (old swapchain is kept) or creation failed (swapchain is empty)
+		bool recreate(
+			/*i.e. current frame number, resources are kept until this frame is done*/ uint64_t retireAfterFrame
+		) CPPONLY(noexcept)
+		{
+			if (!initStruct || !swapchain)
+				return false;
+			VkSwapchainKHR recreated = ::recreateSwapchainKHRInPlace(initStruct, swapchain, retireAfterFrame, VKCMDINIT_MAX_SWAPCHAIN_IMAGES, &imageCount, swapchainImages, swapchainImageViews);
+			//Zero count means old one was retired, but new one couldn't be created
+			if (recreated || imageCount == 0)
+				swapchain = recreated;
+			return recreated != VK_NULL_HANDLE;
+		}
+
+		std::span<const VkImage> images() const CPPONLY(noexcept) { return { swapchainImages, imageCount }; }
+		std::span<const VkImageView> imageViews() const CPPONLY(noexcept) { return { swapchainImageViews, imageCount }; }
+		VkSwapchainKHR handle() const CPPONLY(noexcept) { return swapchain; }
+		explicit operator bool() const CPPONLY(noexcept) { return swapchain != VK_NULL_HANDLE; }
+
+	private:
+		void take(Swapchain& other) CPPONLY(noexcept)
+		{
+			initStruct = std::exchange(other.initStruct, nullptr);
+			swapchain = std::exchange(other.swapchain, VkSwapchainKHR{});
+			imageCount = std::exchange(other.imageCount, 0);
+			for (uint32_t i = 0; i < imageCount; ++i)
+			{
+				swapchainImages[i] = other.swapchainImages[i];
+				swapchainImageViews[i] = other.swapchainImageViews[i];
+			}
+		}
+
+		InitializationStruct* initStruct = nullptr;
+		VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+		uint32_t imageCount = 0;
+		VkImage swapchainImages[VKCMDINIT_MAX_SWAPCHAIN_IMAGES] = {};
+		VkImageView swapchainImageViews[VKCMDINIT_MAX_SWAPCHAIN_IMAGES] = {};
+	};
+#endif
+
 	using InitializationStruct = ::InitializationStruct;
 	using DefaultQueueRetrieveStruct = ::DefaultQueueRetrieveStruct;
+	using QueueRole = ::QueueRole;
+	using ValidationProfile = ::ValidationProfile;
+	using ValidationFeatureBits = ::ValidationFeatureBits;
+	using DebugSinkStats = ::DebugSinkStats;
+	using DebugMessageIdStats = ::DebugMessageIdStats;
+	using PipelineCacheStats = ::PipelineCacheStats;
+	using InitTraceEvent = ::InitTraceEvent;
+	using InitTrace = ::InitTrace;
+	using AllocationScopeStats = ::AllocationScopeStats;
+	using AllocationStats = ::AllocationStats;
+	using ScratchArena = ::ScratchArena;
+	using ScratchMark = ::ScratchMark;
+	using OffscreenSwapchain = ::OffscreenSwapchain;
+	using FrameContext = ::FrameContext;
+	using DeviceSelectionPolicy = ::DeviceSelectionPolicy;
+	using FeatureRequest = ::FeatureRequest;
+	using FeatureGrant = ::FeatureGrant;
+	using PhysicalDeviceScore = ::PhysicalDeviceScore;
+	using TimelineWait = ::TimelineWait;
+	using TimelineQueue = ::TimelineQueue;
+	using GpuMemoryUsage = ::GpuMemoryUsage;
+	using GpuAllocation = ::GpuAllocation;
+	using GpuLinearArena = ::GpuLinearArena;
+	using GpuMemoryStats = ::GpuMemoryStats;
+	using UploadRing = ::UploadRing;
+	using ReadbackResult = ::ReadbackResult;
+	using ReadbackRing = ::ReadbackRing;
+	using DescriptorPoolRatio = ::DescriptorPoolRatio;
+	using DescriptorAllocator = ::DescriptorAllocator;
+	using DescriptorWrite = ::DescriptorWrite;
+	using DescriptorCache = ::DescriptorCache;
+	using BindlessResourceType = ::BindlessResourceType;
+	using BindlessTable = ::BindlessTable;
+	using JobSystem = ::JobSystem;
+	using JobFunction = ::JobFunction;
+	using JobCounter = ::JobCounter;
+	using AsyncShaderRequest = ::AsyncShaderRequest;
+	using AsyncInit = ::AsyncInit;
+	using RecordFunction = ::RecordFunction;
+	using ParallelRecorder = ::ParallelRecorder;
+	using PipelinePriority = ::PipelinePriority;
+	using PipelineHandle = ::PipelineHandle;
+	using PipelineCompilerStats = ::PipelineCompilerStats;
+	using PipelineCompiler = ::PipelineCompiler;
+	using ShaderArchiveSource = ::ShaderArchiveSource;
+	using ShaderArchiveStats = ::ShaderArchiveStats;
+	using ShaderArchive = ::ShaderArchive;
+	using GpuScopeStats = ::GpuScopeStats;
+	using GpuTraceEvent = ::GpuTraceEvent;
+	using GpuProfiler = ::GpuProfiler;
 
 };
 
@@ -50,7 +50,7 @@ int main()
 
 	{
 		DefaultQueueRetrieveStruct queues = { 0 };
-		retrieveQueues(&initstruct, &queues, &families , NULL);
+		retrieveDefaultQueues(&initstruct, &queues, &families);
 		graphicsQueue = queues.graphicsQueue;
 		presentationQueue = queues.presentationQueue;
 	}
@@ -68,8 +68,10 @@ int main()
 	}
 
 	for (uint32_t i = 0; i < swapchainImageCount; ++i)
-		vkDestroyImageView(initstruct.device, swapchainImageViews[i], NULL);
-	vkDestroySwapchainKHR(initstruct.device, swapchain, NULL);
+		initstruct.deviceTable.vkDestroyImageView(initstruct.device, swapchainImageViews[i], initstruct.allocationCallbacks);
+	free(swapchainImageViews);
+	free(swapchainImages);
+	initstruct.deviceTable.vkDestroySwapchainKHR(initstruct.device, swapchain, initstruct.allocationCallbacks);
 	terminateInstance(&initstruct);
 	glfwTerminate();
 }
\ No newline at end of file
@@ -67,8 +67,10 @@ int main()
 	}
 
 	for (uint32_t i = 0; i < swapchainImageCount; ++i)
-		vkDestroyImageView(initstruct.device,swapchainImageViews[i], nullptr);
-	vkDestroySwapchainKHR(initstruct.device,swapchain, nullptr);
+		initstruct.deviceTable.vkDestroyImageView(initstruct.device,swapchainImageViews[i], initstruct.allocationCallbacks);
+	free(swapchainImageViews);
+	free(swapchainImages);
+	initstruct.deviceTable.vkDestroySwapchainKHR(initstruct.device,swapchain, initstruct.allocationCallbacks);
 	terminateInstance(&initstruct);
 	glfwTerminate();
 }
\ No newline at end of file